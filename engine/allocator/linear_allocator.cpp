@@ -0,0 +1,80 @@
+#include "linear_allocator.h"
+
+#include "core/logger.h"
+#include "platform/platform.h"
+
+#include <cassert>
+
+static constexpr size_t COMMIT_GRANULARITY = 64 * 1024;
+
+LinearAllocator::LinearAllocator(size_t reserveSize, bool hugePages)
+	:
+	m_CommitGranularity(hugePages ? HUGE_PAGE_SIZE : COMMIT_GRANULARITY),
+	m_OwnsMemory(true) {
+	m_TotalSize = (reserveSize + m_CommitGranularity - 1) & ~(m_CommitGranularity - 1);
+	m_Memory = (uint8_t*)Platform::VReserve(m_TotalSize, hugePages);
+
+	if (!m_Memory) {
+		m_TotalSize = 0;
+	}
+}
+
+LinearAllocator::LinearAllocator(size_t totalSize, void* memory)
+	:
+	m_Memory((uint8_t*)memory),
+	m_TotalSize(totalSize),
+	m_Committed(totalSize),
+	m_OwnsMemory(false) {}
+
+LinearAllocator::~LinearAllocator() {
+	if (m_OwnsMemory && m_Memory) {
+		Platform::VRelease(m_Memory, m_TotalSize);
+	}
+	m_Memory = nullptr;
+	m_TotalSize = 0;
+	m_Committed = 0;
+	m_Offset = 0;
+}
+
+void* LinearAllocator::Allocate(size_t size, size_t alignment) {
+	assert((alignment & (alignment - 1)) == 0 && "alignment must be a power of two");
+
+	uintptr_t current = (uintptr_t)(m_Memory + m_Offset);
+	uintptr_t aligned = (current + (alignment - 1)) & ~(uintptr_t)(alignment - 1);
+	size_t newOffset = (aligned - (uintptr_t)m_Memory) + size;
+
+	if (newOffset > m_TotalSize) {
+		LOG_WARNING("LinearAllocator::Allocate: out of memory, requested %zu bytes with %zu of %zu in use", size, m_Offset, m_TotalSize);
+		return nullptr;
+	}
+
+	if (newOffset > m_Committed && !Commit(newOffset)) {
+		return nullptr;
+	}
+
+	m_Offset = newOffset;
+
+	return (void*)aligned;
+}
+
+void LinearAllocator::Rewind(LinearAllocatorMark mark) {
+	assert(mark.offset <= m_Offset && "Rewinding to a mark that is ahead of the allocator");
+	m_Offset = mark.offset;
+}
+
+bool LinearAllocator::Commit(size_t offset) {
+	// Committed pages are kept across Reset, so a steady workload stops committing after a few frames.
+	size_t newCommitted = (offset + m_CommitGranularity - 1) & ~(m_CommitGranularity - 1);
+	if (newCommitted > m_TotalSize) {
+		newCommitted = m_TotalSize;
+	}
+
+	if (!Platform::VCommit(m_Memory + m_Committed, newCommitted - m_Committed)) {
+		LOG_WARNING("LinearAllocator::Allocate: failed to commit %zu bytes", newCommitted - m_Committed);
+		return false;
+	}
+
+	m_Committed = newCommitted;
+
+	return true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "defines.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/* A position inside a LinearAllocator. Rewinding to it frees everything allocated after it. */
+struct LinearAllocatorMark {
+	size_t offset;
+};
+
+/*
+ * Bump allocator over a single block of memory.
+ * Allocations can't be freed one by one, instead the whole allocator is
+ * rewound to a mark or reset in O(1).
+ * An owning allocator only reserves address space up front and commits pages as it grows.
+ */
+class RAPI LinearAllocator {
+public:
+	/* Reserves reserveSize bytes of address space, optionally backed by huge pages. */
+	LinearAllocator(size_t reserveSize, bool hugePages = false);
+	/* Uses memory as the backing block, memory is not owned by the allocator. */
+	LinearAllocator(size_t totalSize, void* memory);
+	LinearAllocator(const LinearAllocator&) = delete;
+	LinearAllocator(LinearAllocator&&) = delete;
+	LinearAllocator& operator=(const LinearAllocator&) = delete;
+	~LinearAllocator();
+
+	/* Returns nullptr if the allocator doesn't have enough space left. */
+	void* Allocate(size_t size, size_t alignment = MINIMUM_ALIGNMENT_SIZE);
+
+	/* Objects are never destroyed, so only trivially destructible types are allowed. */
+	template<typename Type, typename... Args>
+	Type* Construct(Args&&... args) {
+		static_assert(std::is_trivially_destructible_v<Type>, "LinearAllocator never calls destructors.");
+		void* memory = Allocate(sizeof(Type), alignof(Type) > MINIMUM_ALIGNMENT_SIZE ? alignof(Type) : MINIMUM_ALIGNMENT_SIZE);
+		if (!memory) {
+			return nullptr;
+		}
+		return new (memory) Type(std::forward<Args>(args)...);
+	}
+
+	/* Allocates an uninitialized array of count elements. */
+	template<typename Type>
+	Type* AllocateArray(size_t count) {
+		static_assert(std::is_trivially_destructible_v<Type>, "LinearAllocator never calls destructors.");
+		return (Type*)Allocate(sizeof(Type) * count, alignof(Type) > MINIMUM_ALIGNMENT_SIZE ? alignof(Type) : MINIMUM_ALIGNMENT_SIZE);
+	}
+
+	AINLINE LinearAllocatorMark GetMark() const { return { m_Offset }; }
+	void Rewind(LinearAllocatorMark mark);
+	AINLINE void Reset() { m_Offset = 0; }
+
+	AINLINE size_t GetAllocated() const { return m_Offset; }
+	AINLINE size_t GetCommitted() const { return m_Committed; }
+	AINLINE size_t GetTotalSize() const { return m_TotalSize; }
+
+private:
+	bool Commit(size_t offset);
+
+private:
+	uint8_t* m_Memory = nullptr;
+	size_t m_TotalSize = 0;
+	size_t m_Committed = 0;
+	size_t m_Offset = 0;
+	size_t m_CommitGranularity = 0;
+	bool m_OwnsMemory = false;
+};
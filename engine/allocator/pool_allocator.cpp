@@ -0,0 +1,327 @@
+#include "pool_allocator.h"
+
+#include "platform/platform.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define cpu_relax() _mm_pause()
+#else
+#define cpu_relax()
+#endif
+
+namespace {
+
+/* 16 byte steps up to 128 bytes, then 4 steps per power of two up to 32 KiB. */
+constexpr uint32_t SMALL_CLASS_COUNT = 8;
+constexpr uint32_t SIZE_CLASS_COUNT = SMALL_CLASS_COUNT + 8 * 4;
+constexpr size_t SLAB_SIZE = 256 * 1024;
+constexpr size_t BATCH_BYTES = 32 * 1024;
+
+struct FreeBlock {
+	FreeBlock* next;
+};
+
+struct SpinLock {
+	std::atomic<bool> locked{ false };
+
+	void Lock() {
+		while (locked.exchange(true, std::memory_order_acquire)) {
+			while (locked.load(std::memory_order_relaxed)) {
+				cpu_relax();
+			}
+		}
+	}
+
+	void Unlock() {
+		locked.store(false, std::memory_order_release);
+	}
+};
+
+/* Shared between every thread, guarded by lock. */
+struct CentralSizeClass {
+	SpinLock lock;
+	FreeBlock* freeList = nullptr;
+	uint32_t freeCount = 0;
+	uint8_t* slabCursor = nullptr;
+	uint8_t* slabEnd = nullptr;
+};
+
+/* Per thread, no locking needed. fresh* is a span of blocks that were never handed out. */
+struct ThreadSizeClass {
+	FreeBlock* freeList;
+	uint32_t freeCount;
+	uint8_t* freshCursor;
+	uint8_t* freshEnd;
+};
+
+struct ThreadCache {
+	ThreadSizeClass classes[SIZE_CLASS_COUNT];
+	bool destroyed;
+};
+
+constexpr size_t ComputeClassSize(uint32_t sizeClass) {
+	if (sizeClass < SMALL_CLASS_COUNT) {
+		return (sizeClass + 1) * 16;
+	}
+	uint32_t k = sizeClass - SMALL_CLASS_COUNT;
+	uint32_t msb = 7 + k / 4;
+	return (size_t(1) << msb) + (k % 4 + 1) * (size_t(1) << (msb - 2));
+}
+
+struct SizeClassTable {
+	size_t sizes[SIZE_CLASS_COUNT];
+	uint32_t batchCounts[SIZE_CLASS_COUNT];
+
+	constexpr SizeClassTable() : sizes(), batchCounts() {
+		for (uint32_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+			sizes[i] = ComputeClassSize(i);
+			size_t batch = BATCH_BYTES / sizes[i];
+			batchCounts[i] = uint32_t(batch < 2 ? 2 : (batch > 128 ? 128 : batch));
+		}
+	}
+};
+
+constexpr SizeClassTable s_SizeClasses;
+static_assert(ComputeClassSize(SIZE_CLASS_COUNT - 1) == PoolAllocator::MAX_SMALL_ALLOCATION_SIZE);
+
+CentralSizeClass s_CentralClasses[SIZE_CLASS_COUNT];
+thread_local ThreadCache t_Cache;
+
+AINLINE uint32_t GetSizeClass(size_t size) {
+	if (size <= 128) {
+		return uint32_t((size + 15) / 16) - (size != 0);
+	}
+	size_t s = size - 1;
+	uint32_t msb = 63 - __builtin_clzll(s);
+	return SMALL_CLASS_COUNT + (msb - 7) * 4 + uint32_t((s >> (msb - 2)) & 3);
+}
+
+AINLINE size_t RoundToPages(size_t size) {
+	constexpr size_t pageSize = 4096;
+	return (size + pageSize - 1) & ~(pageSize - 1);
+}
+
+void PushBlock(FreeBlock*& list, uint32_t& count, void* memory) {
+	FreeBlock* block = (FreeBlock*)memory;
+	block->next = list;
+	list = block;
+	count++;
+}
+
+/* Gives count blocks of the thread cache back to the central size class. */
+void FlushToCentral(uint32_t sizeClass, ThreadSizeClass& cache, uint32_t count) {
+	if (count == 0 || cache.freeList == nullptr) {
+		return;
+	}
+
+	FreeBlock* first = cache.freeList;
+	FreeBlock* last = first;
+	uint32_t moved = 1;
+	while (moved < count && last->next) {
+		last = last->next;
+		moved++;
+	}
+
+	cache.freeList = last->next;
+	cache.freeCount -= moved;
+
+	CentralSizeClass& central = s_CentralClasses[sizeClass];
+	central.lock.Lock();
+	last->next = central.freeList;
+	central.freeList = first;
+	central.freeCount += moved;
+	central.lock.Unlock();
+}
+
+/* Called with the central lock held. Makes sure the slab can hand out at least size bytes. */
+bool EnsureSlab(CentralSizeClass& central, size_t size) {
+	if (central.slabCursor + size <= central.slabEnd) {
+		return true;
+	}
+	// The tail of the old slab is too small for a block of this class and is dropped.
+	uint8_t* slab = (uint8_t*)Platform::VAlloc(SLAB_SIZE);
+	if (!slab) {
+		return false;
+	}
+	central.slabCursor = slab;
+	central.slabEnd = slab + SLAB_SIZE;
+	return true;
+}
+
+/* Refills the thread cache from the central free list or with a fresh span of the slab. */
+bool Refill(uint32_t sizeClass, ThreadSizeClass& cache) {
+	CentralSizeClass& central = s_CentralClasses[sizeClass];
+	const size_t classSize = s_SizeClasses.sizes[sizeClass];
+	const uint32_t batch = s_SizeClasses.batchCounts[sizeClass];
+
+	central.lock.Lock();
+
+	if (central.freeList) {
+		FreeBlock* first = central.freeList;
+		FreeBlock* last = first;
+		uint32_t moved = 1;
+		while (moved < batch && last->next) {
+			last = last->next;
+			moved++;
+		}
+		central.freeList = last->next;
+		central.freeCount -= moved;
+		central.lock.Unlock();
+
+		last->next = cache.freeList;
+		cache.freeList = first;
+		cache.freeCount += moved;
+		return true;
+	}
+
+	if (!EnsureSlab(central, classSize)) {
+		central.lock.Unlock();
+		return false;
+	}
+
+	size_t spanSize = classSize * batch;
+	size_t available = size_t(central.slabEnd - central.slabCursor);
+	if (spanSize > available) {
+		spanSize = available - available % classSize;
+	}
+
+	cache.freshCursor = central.slabCursor;
+	cache.freshEnd = central.slabCursor + spanSize;
+	central.slabCursor += spanSize;
+
+	central.lock.Unlock();
+	return true;
+}
+
+/* Used once the thread cache was destroyed at thread exit. */
+void* AllocateFromCentral(uint32_t sizeClass) {
+	CentralSizeClass& central = s_CentralClasses[sizeClass];
+	const size_t classSize = s_SizeClasses.sizes[sizeClass];
+	void* memory = nullptr;
+
+	central.lock.Lock();
+	if (central.freeList) {
+		memory = central.freeList;
+		central.freeList = central.freeList->next;
+		central.freeCount--;
+	} else if (EnsureSlab(central, classSize)) {
+		memory = central.slabCursor;
+		central.slabCursor += classSize;
+	}
+	central.lock.Unlock();
+
+	return memory;
+}
+
+void FreeToCentral(uint32_t sizeClass, void* memory) {
+	CentralSizeClass& central = s_CentralClasses[sizeClass];
+	central.lock.Lock();
+	PushBlock(central.freeList, central.freeCount, memory);
+	central.lock.Unlock();
+}
+
+/* Hands every cached block back to the central size classes when a thread exits. */
+struct ThreadCacheGuard {
+	bool active = false;
+
+	~ThreadCacheGuard() {
+		for (uint32_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+			ThreadSizeClass& cache = t_Cache.classes[i];
+			const size_t classSize = s_SizeClasses.sizes[i];
+
+			while (cache.freshCursor && cache.freshCursor + classSize <= cache.freshEnd) {
+				PushBlock(cache.freeList, cache.freeCount, cache.freshCursor);
+				cache.freshCursor += classSize;
+			}
+			cache.freshCursor = nullptr;
+			cache.freshEnd = nullptr;
+
+			FlushToCentral(i, cache, cache.freeCount);
+		}
+		t_Cache.destroyed = true;
+	}
+};
+
+thread_local ThreadCacheGuard t_CacheGuard;
+
+} // namespace
+
+void* PoolAllocator::Allocate(size_t size, bool zeroed) {
+	if (size > MAX_SMALL_ALLOCATION_SIZE) {
+		return Platform::VAlloc(RoundToPages(size));
+	}
+
+	uint32_t sizeClass = GetSizeClass(size);
+
+	if (t_Cache.destroyed) [[unlikely]] {
+		void* memory = AllocateFromCentral(sizeClass);
+		if (memory && zeroed) {
+			memset(memory, 0, size);
+		}
+		return memory;
+	}
+
+	ThreadSizeClass& cache = t_Cache.classes[sizeClass];
+	const size_t classSize = s_SizeClasses.sizes[sizeClass];
+
+	for (;;) {
+		if (cache.freeList) {
+			FreeBlock* block = cache.freeList;
+			cache.freeList = block->next;
+			cache.freeCount--;
+			if (zeroed) {
+				memset(block, 0, size);
+			}
+			return block;
+		}
+
+		if (cache.freshCursor + classSize <= cache.freshEnd) {
+			void* memory = cache.freshCursor;
+			cache.freshCursor += classSize;
+			return memory;
+		}
+
+		// First allocation of this thread registers the guard that flushes the cache at thread exit.
+		t_CacheGuard.active = true;
+
+		if (!Refill(sizeClass, cache)) {
+			return nullptr;
+		}
+	}
+}
+
+void PoolAllocator::Free(void* memory, size_t size) {
+	if (!memory) {
+		return;
+	}
+
+	if (size > MAX_SMALL_ALLOCATION_SIZE) {
+		Platform::VFree(memory, RoundToPages(size));
+		return;
+	}
+
+	uint32_t sizeClass = GetSizeClass(size);
+
+	if (t_Cache.destroyed) [[unlikely]] {
+		FreeToCentral(sizeClass, memory);
+		return;
+	}
+
+	ThreadSizeClass& cache = t_Cache.classes[sizeClass];
+	PushBlock(cache.freeList, cache.freeCount, memory);
+
+	if (cache.freeCount == 1) {
+		// Threads that only free still have to give their blocks back at exit.
+		t_CacheGuard.active = true;
+	}
+
+	const uint32_t batch = s_SizeClasses.batchCounts[sizeClass];
+	if (cache.freeCount > batch * 2) {
+		FlushToCentral(sizeClass, cache, batch);
+	}
+}
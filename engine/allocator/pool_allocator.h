@@ -0,0 +1,22 @@
+#pragma once
+
+#include "defines.h"
+
+#include <cstddef>
+
+/*
+ * General purpose size-class allocator behind Platform::UAlloc.
+ * Small sizes are carved from slabs and freed blocks are kept in per-thread caches,
+ * which hand them back to the shared size class in batches.
+ * Anything bigger than MAX_SMALL_ALLOCATION_SIZE goes straight to the OS.
+ * Every block is aligned to MINIMUM_ALIGNMENT_SIZE.
+ */
+class PoolAllocator {
+public:
+	static constexpr size_t MAX_SMALL_ALLOCATION_SIZE = 32 * 1024;
+
+	/* When zeroed is set, only blocks that were used before are cleared, fresh OS pages are already zero. */
+	static void* Allocate(size_t size, bool zeroed = false);
+	/* size must be the same size that was passed to Allocate. */
+	static void Free(void* memory, size_t size);
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "defines.h"
+#include "containers/list.h"
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+/*
+ * Refers to an element of a handle_pool<T>. The generation changes every time the
+ * slot is reused, so handles to erased elements are detected instead of aliasing
+ * whatever was inserted after them.
+ */
+template<typename T>
+struct Handle {
+	uint32_t index = INVALID_ID;
+	uint32_t generation = 0;
+
+	AINLINE bool IsValid() const { return index != INVALID_ID; }
+
+	friend bool operator==(const Handle& a, const Handle& b) { return a.index == b.index && a.generation == b.generation; }
+	friend bool operator!=(const Handle& a, const Handle& b) { return !(a == b); }
+};
+
+/*
+ * Slot map. Elements live densely packed in insertion order (until something is erased),
+ * so iterating them is a linear walk. Insert, erase and lookup are O(1).
+ * Erasing moves the last element into the hole, pointers to elements are invalidated
+ * by insert and erase, handles are not.
+ */
+template<typename T>
+class handle_pool {
+	struct Slot {
+		/* Index in the dense array while alive, next free slot while free. */
+		uint32_t index;
+		uint32_t generation;
+	};
+
+public:
+	handle_pool() = default;
+
+	Handle<T> insert(const T& element) {
+		Handle<T> handle = acquire_slot();
+		m_Dense.push_back(element);
+		return handle;
+	}
+
+	Handle<T> insert(T&& element) {
+		Handle<T> handle = acquire_slot();
+		m_Dense.push_back(std::move(element));
+		return handle;
+	}
+
+	/* Returns false if the handle is stale. */
+	bool erase(Handle<T> handle) {
+		if (!contains(handle)) {
+			return false;
+		}
+
+		Slot& slot = m_Slots[handle.index];
+		uint32_t denseIndex = slot.index;
+		uint32_t lastIndex = m_Dense.size_u32() - 1;
+
+		if (denseIndex != lastIndex) {
+			m_Dense[denseIndex] = std::move(m_Dense[lastIndex]);
+			m_DenseToSlot[denseIndex] = m_DenseToSlot[lastIndex];
+			m_Slots[m_DenseToSlot[denseIndex]].index = denseIndex;
+		}
+
+		m_Dense.remove_last();
+		m_DenseToSlot.remove_last();
+
+		slot.generation++;
+		slot.index = m_FreeHead;
+		m_FreeHead = handle.index;
+
+		return true;
+	}
+
+	/* The generation alone isn't enough, a free slot already has the one its next element gets. */
+	AINLINE bool contains(Handle<T> handle) const {
+		if (handle.index >= m_Slots.size()) {
+			return false;
+		}
+
+		const Slot& slot = m_Slots[handle.index];
+		return slot.generation == handle.generation && slot.index < m_Dense.size() && m_DenseToSlot[slot.index] == handle.index;
+	}
+
+	/* Returns nullptr if the handle is stale. */
+	T* get(Handle<T> handle) {
+		return contains(handle) ? &m_Dense[m_Slots[handle.index].index] : nullptr;
+	}
+
+	const T* get(Handle<T> handle) const {
+		return contains(handle) ? &m_Dense[m_Slots[handle.index].index] : nullptr;
+	}
+
+	/* Handle of the element at position index of the dense array. */
+	Handle<T> handle_at(size_t index) const {
+		assert(index < m_Dense.size());
+		uint32_t slotIndex = m_DenseToSlot[index];
+		return Handle<T>{ slotIndex, m_Slots[slotIndex].generation };
+	}
+
+	void clear() {
+		while (!m_Dense.is_empty()) {
+			erase(handle_at(m_Dense.size() - 1));
+		}
+	}
+
+	AINLINE size_t size() const { return m_Dense.size(); }
+	AINLINE bool is_empty() const { return m_Dense.is_empty(); }
+
+	AINLINE T* data() { return m_Dense.data(); }
+	AINLINE const T* data() const { return m_Dense.data(); }
+
+	AINLINE T* begin() { return m_Dense.data(); }
+	AINLINE T* end() { return m_Dense.data() + m_Dense.size(); }
+	AINLINE const T* begin() const { return m_Dense.data(); }
+	AINLINE const T* end() const { return m_Dense.data() + m_Dense.size(); }
+
+private:
+	Handle<T> acquire_slot() {
+		uint32_t slotIndex;
+
+		if (m_FreeHead != INVALID_ID) {
+			slotIndex = m_FreeHead;
+			m_FreeHead = m_Slots[slotIndex].index;
+		} else {
+			slotIndex = m_Slots.size_u32();
+			m_Slots.push_back(Slot{ 0, 0 });
+		}
+
+		m_Slots[slotIndex].index = m_Dense.size_u32();
+		m_DenseToSlot.push_back(slotIndex);
+
+		return Handle<T>{ slotIndex, m_Slots[slotIndex].generation };
+	}
+
+private:
+	list<T> m_Dense;
+	list<uint32_t> m_DenseToSlot;
+	list<Slot> m_Slots;
+	uint32_t m_FreeHead = INVALID_ID;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "containers/hash_table.h"
+
+template<typename K, typename V>
+struct hash_map_entry {
+	K key;
+	V value;
+};
+
+template<typename K, typename V>
+struct hash_map_policy {
+	using Key = K;
+	using Entry = hash_map_entry<K, V>;
+	using Value = Entry;
+
+	static AINLINE const K& KeyOf(const Entry& entry) { return entry.key; }
+	static AINLINE Entry& ValueOf(Entry& entry) { return entry; }
+	static AINLINE const Entry& ValueOf(const Entry& entry) { return entry; }
+};
+
+/*
+ * Flat hash map, entries are stored inline in the table so they move when it grows.
+ * Iterating yields hash_map_entry with key and value members, in no particular order.
+ * With a transparent hasher (e.g. String keys) lookups accept any type the hasher does.
+ */
+template<typename K, typename V, typename Hash = hasher<K>, typename Eq = key_equal<K>>
+class hash_map : public hash_table<hash_map_policy<K, V>, Hash, Eq> {
+	using Base = hash_table<hash_map_policy<K, V>, Hash, Eq>;
+	using Entry = hash_map_entry<K, V>;
+public:
+	/* Returns nullptr if key isn't in the map. */
+	template<typename Query>
+	V* find(const Query& key) {
+		size_t index = Base::find_index(key);
+		return index != Base::NOT_FOUND ? &Base::entry_at(index).value : nullptr;
+	}
+
+	template<typename Query>
+	const V* find(const Query& key) const {
+		size_t index = Base::find_index(key);
+		return index != Base::NOT_FOUND ? &Base::entry_at(index).value : nullptr;
+	}
+
+	/* Inserts value if key isn't in the map yet. Returns false if it already was, the old value is kept. */
+	bool insert(const K& key, const V& value) {
+		return emplace(key, value).second;
+	}
+
+	bool insert(const K& key, V&& value) {
+		return emplace(key, std::move(value)).second;
+	}
+
+	/* Constructs the value from args only if key isn't in the map. Returns the value and whether it was inserted. */
+	template<typename... Args>
+	std::pair<V*, bool> emplace(const K& key, Args&&... args) {
+		auto [index, inserted] = Base::find_or_prepare_insert(key);
+		Entry& entry = Base::entry_at(index);
+		if (inserted) {
+			new (static_cast<void*>(&entry)) Entry{ key, V(std::forward<Args>(args)...) };
+		}
+		return { &entry.value, inserted };
+	}
+
+	V& insert_or_assign(const K& key, V value) {
+		auto [index, inserted] = Base::find_or_prepare_insert(key);
+		Entry& entry = Base::entry_at(index);
+		if (inserted) {
+			new (static_cast<void*>(&entry)) Entry{ key, std::move(value) };
+		} else {
+			entry.value = std::move(value);
+		}
+		return entry.value;
+	}
+
+	/* Default constructs the value if key isn't in the map. */
+	V& operator[](const K& key) {
+		return *emplace(key).first;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "containers/hash_table.h"
+
+template<typename K>
+struct hash_set_policy {
+	using Key = K;
+	using Entry = K;
+	using Value = const K;
+
+	static AINLINE const K& KeyOf(const Entry& entry) { return entry; }
+	static AINLINE const K& ValueOf(const Entry& entry) { return entry; }
+};
+
+/* Flat hash set, see hash_table for how lookups work. */
+template<typename K, typename Hash = hasher<K>, typename Eq = key_equal<K>>
+class hash_set : public hash_table<hash_set_policy<K>, Hash, Eq> {
+	using Base = hash_table<hash_set_policy<K>, Hash, Eq>;
+public:
+	/* Returns false if key was already in the set. */
+	bool insert(const K& key) {
+		auto [index, inserted] = Base::find_or_prepare_insert(key);
+		if (inserted) {
+			new (static_cast<void*>(&Base::entry_at(index))) K(key);
+		}
+		return inserted;
+	}
+
+	bool insert(K&& key) {
+		auto [index, inserted] = Base::find_or_prepare_insert(key);
+		if (inserted) {
+			new (static_cast<void*>(&Base::entry_at(index))) K(std::move(key));
+		}
+		return inserted;
+	}
+};
\ No newline at end of file
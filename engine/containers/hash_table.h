@@ -0,0 +1,513 @@
+#pragma once
+
+#include "defines.h"
+#include "platform/platform.h"
+#include "core/string.h"
+#include "core/string_id.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* Mixes all 64 bits of x into the low and high bits of the result. */
+static AINLINE uint64_t hash_u64(uint64_t x) {
+#if defined(_MSC_VER)
+	uint64_t high;
+	uint64_t low = _umul128(x ^ 0x2d358dccaa6c78a5ull, 0x9e3779b97f4a7c15ull, &high);
+	return low ^ high;
+#else
+	__uint128_t product = (__uint128_t)(x ^ 0x2d358dccaa6c78a5ull) * 0x9e3779b97f4a7c15ull;
+	return (uint64_t)product ^ (uint64_t)(product >> 64);
+#endif
+}
+
+static inline uint64_t hash_bytes(const void* data, size_t size) {
+	const uint8_t* bytes = (const uint8_t*)data;
+	uint64_t hash = hash_u64(size);
+
+	while (size >= 8) {
+		uint64_t chunk;
+		memcpy(&chunk, bytes, 8);
+		hash = hash_u64(hash ^ chunk);
+		bytes += 8;
+		size -= 8;
+	}
+
+	if (size != 0) {
+		uint64_t chunk = 0;
+		memcpy(&chunk, bytes, size);
+		hash = hash_u64(hash ^ chunk);
+	}
+
+	return hash;
+}
+
+/* Hash used by hash_map and hash_set. Integers, enums and pointers hash by value. */
+template<typename T>
+struct hasher {
+	static_assert(std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>, "No hasher for this key type, write a hasher<T> specialization.");
+
+	AINLINE uint64_t operator()(T key) const {
+		if constexpr (std::is_pointer_v<T>) {
+			return hash_u64((uint64_t)(uintptr_t)key);
+		} else {
+			return hash_u64((uint64_t)key);
+		}
+	}
+};
+
+/* String keys can be looked up with a const char* or a StringView without building a String. */
+template<>
+struct hasher<String> {
+	using is_transparent = void;
+
+	AINLINE uint64_t operator()(const String& key) const { return hash_bytes(key.CStr(), key.GetSize()); }
+	AINLINE uint64_t operator()(const char* key) const { return hash_bytes(key, strlen(key)); }
+	AINLINE uint64_t operator()(StringView key) const { return hash_bytes(key.Data(), key.GetSize()); }
+};
+
+/* StringIds already are hashes, they're only mixed again so the low bits used for the slot index are spread out. */
+template<>
+struct hasher<StringId> {
+	AINLINE uint64_t operator()(StringId key) const { return hash_u64(key.GetHash()); }
+};
+
+template<typename T>
+struct key_equal {
+	AINLINE bool operator()(const T& a, const T& b) const { return a == b; }
+};
+
+template<>
+struct key_equal<String> {
+	using is_transparent = void;
+
+	AINLINE bool operator()(const String& a, const String& b) const {
+		return a.GetSize() == b.GetSize() && (a.GetSize() == 0 || memcmp(a.CStr(), b.CStr(), a.GetSize()) == 0);
+	}
+	AINLINE bool operator()(const String& a, const char* b) const {
+		size_t size = strlen(b);
+		return a.GetSize() == size && (size == 0 || memcmp(a.CStr(), b, size) == 0);
+	}
+	AINLINE bool operator()(const String& a, StringView b) const { return a.View() == b; }
+};
+
+/*
+ * Open addressing table in the style of Swiss tables, shared by hash_map and hash_set.
+ * Every slot has a control byte: empty, deleted, or the low 7 bits of the key's hash.
+ * Lookups compare a whole group of control bytes at once (16 with SSE2, 32 with AVX2)
+ * and only touch the slots whose 7 bits match, so a probe rarely reads more than one entry.
+ * The first group is mirrored past the end of the control bytes so group loads never wrap.
+ */
+template<typename Policy, typename Hash, typename Eq>
+class hash_table {
+protected:
+	using Key = typename Policy::Key;
+	using Entry = typename Policy::Entry;
+
+	using Control = int8_t;
+	static constexpr Control EMPTY = -128;
+	static constexpr Control DELETED = -2;
+
+#if defined(__AVX2__)
+	static constexpr size_t GROUP_WIDTH = 32;
+
+	struct Group {
+		__m256i control;
+
+		AINLINE explicit Group(const Control* position) : control(_mm256_loadu_si256((const __m256i*)position)) {}
+
+		AINLINE uint32_t Match(Control hash) const { return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(hash), control)); }
+		AINLINE uint32_t MatchEmpty() const { return Match(EMPTY); }
+		AINLINE uint32_t MatchEmptyOrDeleted() const { return (uint32_t)_mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_set1_epi8(-1), control)); }
+	};
+#else
+	static constexpr size_t GROUP_WIDTH = 16;
+
+	struct Group {
+		__m128i control;
+
+		AINLINE explicit Group(const Control* position) : control(_mm_loadu_si128((const __m128i*)position)) {}
+
+		AINLINE uint32_t Match(Control hash) const { return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(hash), control)); }
+		AINLINE uint32_t MatchEmpty() const { return Match(EMPTY); }
+		AINLINE uint32_t MatchEmptyOrDeleted() const { return (uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), control)); }
+	};
+#endif
+
+	static constexpr size_t NOT_FOUND = (size_t)-1;
+
+public:
+	template<bool IsConst>
+	class Iterator {
+		using Value = std::conditional_t<IsConst, const typename Policy::Value, typename Policy::Value>;
+		using EntryPtr = std::conditional_t<IsConst, const Entry*, Entry*>;
+	public:
+		Iterator(const Control* control, EntryPtr entry, EntryPtr end)
+			:
+			m_Control(control),
+			m_Entry(entry),
+			m_End(end) {
+			SkipFree();
+		}
+
+		Value& operator*() const { return Policy::ValueOf(*m_Entry); }
+		Value* operator->() const { return &Policy::ValueOf(*m_Entry); }
+
+		Iterator& operator++() { m_Control++; m_Entry++; SkipFree(); return *this; }
+		Iterator operator++(int) { Iterator it = *this; ++(*this); return it; }
+
+		friend bool operator==(const Iterator& a, const Iterator& b) { return a.m_Entry == b.m_Entry; }
+		friend bool operator!=(const Iterator& a, const Iterator& b) { return a.m_Entry != b.m_Entry; }
+
+	private:
+		AINLINE void SkipFree() {
+			while (m_Entry != m_End && *m_Control < 0) {
+				m_Control++;
+				m_Entry++;
+			}
+		}
+
+	private:
+		const Control* m_Control;
+		EntryPtr m_Entry;
+		EntryPtr m_End;
+	};
+
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+public:
+	hash_table() = default;
+
+	hash_table(const hash_table& rhs) {
+		copy_from(rhs);
+	}
+
+	hash_table(hash_table&& rhs) noexcept {
+		take(rhs);
+	}
+
+	hash_table& operator=(const hash_table& rhs) {
+		if (this != &rhs) {
+			destroy();
+			copy_from(rhs);
+		}
+		return *this;
+	}
+
+	hash_table& operator=(hash_table&& rhs) noexcept {
+		if (this != &rhs) {
+			destroy();
+			take(rhs);
+		}
+		return *this;
+	}
+
+	~hash_table() {
+		destroy();
+	}
+
+	size_t size() const { return m_Size; }
+	uint32_t size_u32() const { return (uint32_t)m_Size; }
+	size_t capacity() const { return m_Capacity; }
+	bool is_empty() const { return m_Size == 0; }
+
+	/* Makes room for count entries without growing again. */
+	void reserve(size_t count) {
+		size_t capacity = GROUP_WIDTH;
+		while (max_load(capacity) < count) {
+			capacity *= 2;
+		}
+		if (capacity > m_Capacity) {
+			rehash(capacity);
+		}
+	}
+
+	/* Destroys every entry, the capacity is kept. */
+	void clear() {
+		if (m_Capacity == 0) {
+			return;
+		}
+		destroy_entries();
+		memset(m_Control, EMPTY, m_Capacity + GROUP_WIDTH);
+		m_Size = 0;
+		m_GrowthLeft = max_load(m_Capacity);
+	}
+
+	template<typename Query>
+	AINLINE bool contains(const Query& key) const { return find_index(key) != NOT_FOUND; }
+
+	/* Returns false if the key wasn't in the table. */
+	template<typename Query>
+	bool erase(const Query& key) {
+		size_t index = find_index(key);
+		if (index == NOT_FOUND) {
+			return false;
+		}
+		erase_at(index);
+		return true;
+	}
+
+	iterator begin() { return iterator(m_Control, m_Entries, m_Entries + m_Capacity); }
+	iterator end() { return iterator(m_Control + m_Capacity, m_Entries + m_Capacity, m_Entries + m_Capacity); }
+	const_iterator begin() const { return const_iterator(m_Control, m_Entries, m_Entries + m_Capacity); }
+	const_iterator end() const { return const_iterator(m_Control + m_Capacity, m_Entries + m_Capacity, m_Entries + m_Capacity); }
+
+protected:
+	template<typename Query>
+	size_t find_index(const Query& key) const {
+		if (m_Size == 0) {
+			return NOT_FOUND;
+		}
+
+		uint64_t hash = Hash()(key);
+		Control h2 = (Control)(hash & 0x7f);
+		size_t mask = m_Capacity - 1;
+		size_t offset = (size_t)(hash >> 7) & mask;
+		size_t step = 0;
+
+		while (true) {
+			Group group(m_Control + offset);
+
+			for (uint32_t match = group.Match(h2); match != 0; match &= match - 1) {
+				size_t index = (offset + count_trailing_zeros(match)) & mask;
+				if (Eq()(Policy::KeyOf(m_Entries[index]), key)) {
+					return index;
+				}
+			}
+
+			if (group.MatchEmpty() != 0) {
+				return NOT_FOUND;
+			}
+
+			step += GROUP_WIDTH;
+			offset = (offset + step) & mask;
+		}
+	}
+
+	/* Returns the index of key and false, or the index of a claimed but unconstructed slot and true. */
+	template<typename Query>
+	std::pair<size_t, bool> find_or_prepare_insert(const Query& key) {
+		size_t index = find_index(key);
+		if (index != NOT_FOUND) {
+			return { index, false };
+		}
+		return { prepare_insert(Hash()(key)), true };
+	}
+
+	size_t prepare_insert(uint64_t hash) {
+		size_t index = m_Capacity != 0 ? find_first_free(hash) : 0;
+
+		if (m_GrowthLeft == 0 && (m_Capacity == 0 || m_Control[index] == EMPTY)) {
+			grow();
+			index = find_first_free(hash);
+		}
+
+		if (m_Control[index] == EMPTY) {
+			m_GrowthLeft--;
+		}
+
+		set_control(index, (Control)(hash & 0x7f));
+		m_Size++;
+
+		return index;
+	}
+
+	void erase_at(size_t index) {
+		m_Entries[index].~Entry();
+		m_Size--;
+
+		// If the slot never made a probe sequence skip over it, it can go straight back to empty.
+		size_t before = (index - GROUP_WIDTH) & (m_Capacity - 1);
+		uint32_t emptyAfter = Group(m_Control + index).MatchEmpty();
+		uint32_t emptyBefore = Group(m_Control + before).MatchEmpty();
+		bool wasNeverFull = emptyBefore != 0 && emptyAfter != 0 &&
+			count_trailing_zeros(emptyAfter) + count_leading_zeros(emptyBefore) < GROUP_WIDTH;
+
+		if (wasNeverFull) {
+			set_control(index, EMPTY);
+			m_GrowthLeft++;
+		} else {
+			set_control(index, DELETED);
+		}
+	}
+
+	AINLINE Entry& entry_at(size_t index) { return m_Entries[index]; }
+	AINLINE const Entry& entry_at(size_t index) const { return m_Entries[index]; }
+
+private:
+	static AINLINE size_t max_load(size_t capacity) { return capacity - capacity / 8; }
+
+	static AINLINE uint32_t count_trailing_zeros(uint32_t mask) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return index;
+#else
+		return (uint32_t)__builtin_ctz(mask);
+#endif
+	}
+
+	/* Leading zeros inside a GROUP_WIDTH wide mask. */
+	static AINLINE uint32_t count_leading_zeros(uint32_t mask) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse(&index, mask);
+		return (uint32_t)(GROUP_WIDTH - 1 - index);
+#else
+		return (uint32_t)__builtin_clz(mask) - (32 - GROUP_WIDTH);
+#endif
+	}
+
+	size_t find_first_free(uint64_t hash) const {
+		size_t mask = m_Capacity - 1;
+		size_t offset = (size_t)(hash >> 7) & mask;
+		size_t step = 0;
+
+		while (true) {
+			uint32_t free = Group(m_Control + offset).MatchEmptyOrDeleted();
+			if (free != 0) {
+				return (offset + count_trailing_zeros(free)) & mask;
+			}
+			step += GROUP_WIDTH;
+			offset = (offset + step) & mask;
+		}
+	}
+
+	AINLINE void set_control(size_t index, Control control) {
+		m_Control[index] = control;
+		// Mirror the first group after the end.
+		if (index < GROUP_WIDTH) {
+			m_Control[m_Capacity + index] = control;
+		}
+	}
+
+	void grow() {
+		if (m_Capacity == 0) {
+			rehash(GROUP_WIDTH);
+		} else if (m_Size * 2 <= max_load(m_Capacity)) {
+			// Mostly deleted slots, rebuilding at the same size is enough.
+			rehash(m_Capacity);
+		} else {
+			rehash(m_Capacity * 2);
+		}
+	}
+
+	static AINLINE size_t entries_offset(size_t capacity) {
+		size_t alignment = alignof(Entry);
+		return (capacity + GROUP_WIDTH + alignment - 1) & ~(alignment - 1);
+	}
+
+	void allocate(size_t capacity) {
+		size_t alignment = alignof(Entry) > MINIMUM_ALIGNMENT_SIZE ? alignof(Entry) : MINIMUM_ALIGNMENT_SIZE;
+		uint8_t* memory = (uint8_t*)Platform::AAllocUninitialized(alignment, entries_offset(capacity) + capacity * sizeof(Entry), MemoryTag::Container);
+
+		m_Control = (Control*)memory;
+		m_Entries = (Entry*)(memory + entries_offset(capacity));
+		m_Capacity = capacity;
+		m_GrowthLeft = max_load(capacity) - m_Size;
+
+		memset(m_Control, EMPTY, capacity + GROUP_WIDTH);
+	}
+
+	void rehash(size_t newCapacity) {
+		assert((newCapacity & (newCapacity - 1)) == 0 && newCapacity >= GROUP_WIDTH);
+
+		Control* oldControl = m_Control;
+		Entry* oldEntries = m_Entries;
+		size_t oldCapacity = m_Capacity;
+
+		allocate(newCapacity);
+
+		for (size_t i = 0; i < oldCapacity; i++) {
+			if (oldControl[i] < 0) {
+				continue;
+			}
+
+			uint64_t hash = Hash()(Policy::KeyOf(oldEntries[i]));
+			size_t index = find_first_free(hash);
+			set_control(index, (Control)(hash & 0x7f));
+
+			if constexpr (std::is_trivially_copyable_v<Entry>) {
+				memcpy(static_cast<void*>(&m_Entries[index]), &oldEntries[i], sizeof(Entry));
+			} else {
+				new (static_cast<void*>(&m_Entries[index])) Entry(std::move(oldEntries[i]));
+				oldEntries[i].~Entry();
+			}
+		}
+
+		if (oldControl) {
+			Platform::AFree(oldControl);
+		}
+	}
+
+	void copy_from(const hash_table& rhs) {
+		if (rhs.m_Size == 0) {
+			return;
+		}
+
+		reserve(rhs.m_Size);
+
+		for (size_t i = 0; i < rhs.m_Capacity; i++) {
+			if (rhs.m_Control[i] >= 0) {
+				size_t index = prepare_insert(Hash()(Policy::KeyOf(rhs.m_Entries[i])));
+				new (static_cast<void*>(&m_Entries[index])) Entry(rhs.m_Entries[i]);
+			}
+		}
+	}
+
+	void take(hash_table& rhs) {
+		m_Control = rhs.m_Control;
+		m_Entries = rhs.m_Entries;
+		m_Capacity = rhs.m_Capacity;
+		m_Size = rhs.m_Size;
+		m_GrowthLeft = rhs.m_GrowthLeft;
+		rhs.m_Control = nullptr;
+		rhs.m_Entries = nullptr;
+		rhs.m_Capacity = 0;
+		rhs.m_Size = 0;
+		rhs.m_GrowthLeft = 0;
+	}
+
+	void destroy_entries() {
+		if constexpr (!std::is_trivially_destructible_v<Entry>) {
+			for (size_t i = 0; i < m_Capacity; i++) {
+				if (m_Control[i] >= 0) {
+					m_Entries[i].~Entry();
+				}
+			}
+		}
+	}
+
+	void destroy() {
+		if (m_Control) {
+			destroy_entries();
+			Platform::AFree(m_Control);
+		}
+		m_Control = nullptr;
+		m_Entries = nullptr;
+		m_Capacity = 0;
+		m_Size = 0;
+		m_GrowthLeft = 0;
+	}
+
+private:
+	Control* m_Control = nullptr;
+	Entry* m_Entries = nullptr;
+	size_t m_Capacity = 0;
+	size_t m_Size = 0;
+	size_t m_GrowthLeft = 0;
+};
\ No newline at end of file
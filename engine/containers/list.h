@@ -1,5 +1,8 @@
 #pragma once
 
+#include "defines.h"
+#include "platform/platform.h"
+
 #include <cstring>
 #include <cassert>
 #include <type_traits>
@@ -9,6 +12,11 @@
 
 static size_t s_ResizeFactor = 2;
 
+/*
+ * Dynamic array over raw uninitialized storage. Only the first size() elements are
+ * constructed, the rest of the capacity is untouched memory.
+ * Trivially copyable elements are relocated with memcpy when the list grows.
+ */
 template<typename T>
 class list {
 	using Element = T;
@@ -16,6 +24,9 @@ class list {
 	using ElementRef = T&;
     using ConstElementRef = const T&;
 	using ElementRValue = T&&;
+
+	static constexpr bool IsTrivial = std::is_trivially_copyable_v<T>;
+	static constexpr bool IsOverAligned = alignof(T) > MINIMUM_ALIGNMENT_SIZE;
 public:
     template<typename Ty>
 	class Iterator {
@@ -24,7 +35,7 @@ public:
 			:
 			m_Ptr(ptr)
 		{}
-		
+
 		ElementRef operator*() { return *m_Ptr; }
 		ElementPtr operator->() { return m_Ptr; }
         ElementRef operator[](int index) { return *(m_Ptr + index); }
@@ -46,6 +57,7 @@ public:
 	};
 
 public:
+	/* Reserves capacity elements, the list starts empty. */
 	list(size_t capacity)
 		:
 		m_Elements(allocate(capacity)),
@@ -66,21 +78,15 @@ public:
 		static_assert(std::is_move_constructible_v<Element>, "The template argument must be move constructible to be used in the list.");
 	}
 
-	list(const list& rhs) 
+	list(const list& rhs)
 		:
-		m_Elements(allocate(rhs.m_Capacity)),
+		m_Elements(allocate(rhs.m_Size)),
 		m_Size(rhs.m_Size),
-		m_Capacity(rhs.m_Capacity) {
-		
-		assert(m_Elements != nullptr);
-
-		for (size_t i = 0; i < m_Size; i++) {
-			ElementPtr ptr = &m_Elements[i];
-			new (static_cast<void*>(ptr)) Element(rhs.m_Elements[i]);
-		}
+		m_Capacity(rhs.m_Size) {
+		copy_construct(m_Elements, rhs.m_Elements, m_Size);
 	}
 
-	list(list&& rhs) 
+	list(list&& rhs) noexcept
 		:
 		m_Elements(rhs.m_Elements),
 		m_Size(rhs.m_Size),
@@ -90,70 +96,89 @@ public:
 		rhs.m_Capacity = 0;
 	}
 
-    list operator=(const list& rhs) {
-        if (rhs.m_Elements == nullptr) {
-            m_Elements = nullptr;
-            m_Capacity = rhs.m_Capacity;
-            m_Size = rhs.m_Size;
-            return *this;
-        }
+	list& operator=(const list& rhs) {
+		if (this == &rhs) {
+			return *this;
+		}
+
+		remove_all();
 
-        m_Elements = allocate(rhs.m_Capacity);
+		if (rhs.m_Size > m_Capacity) {
+			release(m_Elements);
+			m_Elements = allocate(rhs.m_Size);
+			m_Capacity = rhs.m_Size;
+		}
+
+		copy_construct(m_Elements, rhs.m_Elements, rhs.m_Size);
 		m_Size = rhs.m_Size;
-		m_Capacity = rhs.m_Capacity;
 
-		for (size_t i = 0; i < m_Size; i++) {
-			ElementPtr ptr = &m_Elements[i];
-			new (static_cast<void*>(ptr)) Element(rhs.m_Elements[i]);
+		return *this;
+	}
+
+	list& operator=(list&& rhs) noexcept {
+		if (this == &rhs) {
+			return *this;
 		}
 
-        return *this;
+		remove_all();
+		release(m_Elements);
+
+		m_Elements = rhs.m_Elements;
+		m_Size = rhs.m_Size;
+		m_Capacity = rhs.m_Capacity;
+		rhs.m_Elements = nullptr;
+		rhs.m_Size = 0;
+		rhs.m_Capacity = 0;
+
+		return *this;
 	}
 
 	~list() {
-		delete[] m_Elements;
-		m_Elements = 0;
-		m_Size = 0;
+		remove_all();
+		release(m_Elements);
+		m_Elements = nullptr;
 		m_Capacity = 0;
 	}
 
 	void push_back(ConstElementRef element) {
-		if (m_Capacity == 0) {
-			m_Elements = allocate(2);
-			m_Capacity = 2;
-		}
-		if (m_Size >= m_Capacity) {
-			reallocate(size() * s_ResizeFactor);
-			m_Elements[m_Size++] = element;
-			return;
-		}
-		if (m_Capacity != 0 && m_Size < m_Capacity) {
-			m_Elements[m_Size++] = element;
+		if (m_Size == m_Capacity) {
+			// element may live inside this list, so build the copy before the storage moves.
+			Element copy(element);
+			grow(m_Size + 1);
+			new (static_cast<void*>(&m_Elements[m_Size])) Element(std::move(copy));
+		} else {
+			new (static_cast<void*>(&m_Elements[m_Size])) Element(element);
 		}
+		m_Size++;
 	}
 
 	void push_back(ElementRValue element) {
-		if (m_Capacity == 0) {
-			m_Elements = allocate(2);
-			m_Capacity = 2;
-		}
+		emplace_back(std::move(element));
+	}
 
-		if (m_Size >= m_Capacity) {
-			reallocate(m_Capacity * s_ResizeFactor);
+	template<typename... Args>
+	ElementRef emplace_back(Args&&... args) {
+		if (m_Size == m_Capacity) {
+			Element element(std::forward<Args>(args)...);
+			grow(m_Size + 1);
+			new (static_cast<void*>(&m_Elements[m_Size])) Element(std::move(element));
+		} else {
+			new (static_cast<void*>(&m_Elements[m_Size])) Element(std::forward<Args>(args)...);
 		}
-		
-		ElementPtr ptr = &m_Elements[m_Size++];
-		new (static_cast<void*>(ptr)) Element(std::forward<Element>(element));
+		return m_Elements[m_Size++];
+	}
 
+	/* Makes room for at least capacity elements without changing the size. */
+	void reserve(size_t capacity) {
+		if (capacity > m_Capacity) {
+			reallocate(capacity);
+		}
 	}
 
 	size_t find_index(ConstElementRef element) const {
-		if (m_Size != 0) {
-			for (size_t i = 0; i < size(); i++) {
-				ConstElementRef el = m_Elements[i];
-				if (el == element) {
-					return i;
-				}
+		for (size_t i = 0; i < m_Size; i++) {
+			if (m_Elements[i] == element) {
+				return i;
 			}
 		}
 		return -1;
@@ -161,34 +186,33 @@ public:
 
 	void remove_last() {
 		if (m_Size != 0) {
-			ElementRef el = m_Elements[m_Size];
-			el.~Element();
-			memset(&m_Elements[m_Size], 0, sizeof(Element));
+			m_Elements[--m_Size].~Element();
 		}
 	}
 
 	void remove_at(size_t index) {
 		assert(index < m_Size);
-		assert(m_Size > 0);
-		ElementRef el = m_Elements[index];
-		el.~Element();
-		memset(&m_Elements[index], 0, sizeof(Element));
-		
-		// Yep. memmove on instances. ikr
-		if (index < (m_Size - 1)) {
-			memmove(&m_Elements[index], &m_Elements[index + 1], (index - size()) * sizeof(Element));
-		}
 
-		if (m_Size - 1 > 0) {
-			m_Size--;
+		if constexpr (IsTrivial) {
+			memmove(&m_Elements[index], &m_Elements[index + 1], (m_Size - index - 1) * sizeof(Element));
+		} else {
+			for (size_t i = index; i + 1 < m_Size; i++) {
+				m_Elements[i] = std::move(m_Elements[i + 1]);
+			}
+			m_Elements[m_Size - 1].~Element();
 		}
+
+		m_Size--;
 	}
 
+	/* Destroys every element, the capacity is kept. */
 	void remove_all() {
-		for (size_t i = 0; i < size(); i++) {
-			m_Elements[i].~Element();
+		if constexpr (!std::is_trivially_destructible_v<Element>) {
+			for (size_t i = 0; i < m_Size; i++) {
+				m_Elements[i].~Element();
+			}
 		}
-		memset(m_Elements, 0, sizeof(Element) * size());
+		m_Size = 0;
 	}
 
 	void set_resize_factor(float resize_factor) {
@@ -196,44 +220,67 @@ public:
 		s_ResizeFactor = resize_factor;
 	}
 
+	/* New elements are value initialized, zero for trivial types. */
 	void resize(size_t new_size) {
-		size_t oldSize = m_Size;
-        m_Size = new_size;
-		if (oldSize > 0) {
-        	reallocate(new_size);
-		} else {
-			m_Elements = allocate(new_size);
-			m_Capacity = new_size;
+		if (new_size > m_Capacity) {
+			grow(new_size);
+		}
+
+		if (new_size > m_Size) {
+			if constexpr (IsTrivial) {
+				memset(static_cast<void*>(&m_Elements[m_Size]), 0, (new_size - m_Size) * sizeof(Element));
+			} else {
+				for (size_t i = m_Size; i < new_size; i++) {
+					new (static_cast<void*>(&m_Elements[i])) Element();
+				}
+			}
+		} else if constexpr (!std::is_trivially_destructible_v<Element>) {
+			for (size_t i = new_size; i < m_Size; i++) {
+				m_Elements[i].~Element();
+			}
 		}
+
+		m_Size = new_size;
 	}
 
 	bool is_empty() const {
 		return m_Size == 0;
 	}
 
-    void reallocate(size_t new_size) {
-        ElementPtr new_elements = allocate(new_size);
+	/* Moves the elements to a new block of new_capacity elements, new_capacity can't be less than size(). */
+    void reallocate(size_t new_capacity) {
+		assert(new_capacity >= m_Size);
+
+        ElementPtr new_elements = allocate(new_capacity);
 
-		for (size_t i = 0; i < size(); i++) {
-			ElementPtr ptr = &new_elements[i];
-			new (static_cast<void*>(ptr)) Element(std::move(m_Elements[i]));
+		if constexpr (IsTrivial) {
+			if (m_Size != 0) {
+				memcpy(static_cast<void*>(new_elements), m_Elements, m_Size * sizeof(Element));
+			}
+		} else {
+			for (size_t i = 0; i < m_Size; i++) {
+				new (static_cast<void*>(&new_elements[i])) Element(std::move(m_Elements[i]));
+				m_Elements[i].~Element();
+			}
 		}
-		delete[] m_Elements;
+
+		release(m_Elements);
 		m_Elements = new_elements;
-		m_Capacity = new_size;
+		m_Capacity = new_capacity;
     }
-	
+
 	size_t size() const { return m_Size; }
 	uint32_t size_u32() const { return (uint32_t)m_Size; }
+	size_t capacity() const { return m_Capacity; }
 
-	ConstElementRef operator[](size_t index) const { 
-		assert(index < m_Capacity);
+	ConstElementRef operator[](size_t index) const {
+		assert(index < m_Size);
 		return m_Elements[index];
 	}
 
-	ElementRef operator[](size_t index) { 
-		assert(index < m_Capacity);
-		return m_Elements[index]; 
+	ElementRef operator[](size_t index) {
+		assert(index < m_Size);
+		return m_Elements[index];
 	}
 
 	const Iterator<T> begin() const { return Iterator<T>(m_Elements); }
@@ -257,10 +304,46 @@ public:
     }
 
 private:
-	ElementPtr allocate(size_t element_count) {
+	/* Geometric growth, so a run of push_back calls only reallocates O(log n) times. */
+	void grow(size_t min_capacity) {
+		size_t new_capacity = m_Capacity * s_ResizeFactor;
+		if (new_capacity < 4) {
+			new_capacity = 4;
+		}
+		if (new_capacity < min_capacity) {
+			new_capacity = min_capacity;
+		}
+		reallocate(new_capacity);
+	}
+
+	static void copy_construct(ElementPtr destination, const ElementPtr source, size_t count) {
+		if constexpr (IsTrivial) {
+			if (count != 0) {
+				memcpy(static_cast<void*>(destination), source, count * sizeof(Element));
+			}
+		} else {
+			for (size_t i = 0; i < count; i++) {
+				new (static_cast<void*>(&destination[i])) Element(source[i]);
+			}
+		}
+	}
+
+	static ElementPtr allocate(size_t element_count) {
 		if (element_count == 0) return nullptr;
-		ElementPtr elements = new Element[element_count]();
-		return elements;
+		if constexpr (IsOverAligned) {
+			return (ElementPtr)Platform::AAllocUninitialized(alignof(Element), element_count * sizeof(Element), MemoryTag::Container);
+		} else {
+			return (ElementPtr)Platform::UAllocUninitialized(element_count * sizeof(Element), MemoryTag::Container);
+		}
+	}
+
+	static void release(ElementPtr elements) {
+		if (!elements) return;
+		if constexpr (IsOverAligned) {
+			Platform::AFree(elements);
+		} else {
+			Platform::UFree(elements);
+		}
 	}
 
 private:
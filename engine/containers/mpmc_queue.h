@@ -0,0 +1,129 @@
+#pragma once
+
+#include "defines.h"
+#include "platform/platform.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+/*
+ * Bounded lock-free multi-producer multi-consumer queue (Dmitry Vyukov's design).
+ * Every cell carries a sequence number that tells producers and consumers whose turn it is,
+ * so the only contended writes are the CAS on the enqueue and dequeue positions,
+ * which live on cache lines of their own.
+ * try_push fails when the queue is full and try_pop when it is empty, neither ever blocks.
+ */
+template<typename T>
+class mpmc_queue {
+	struct Cell {
+		std::atomic<size_t> sequence;
+		alignas(T) unsigned char storage[sizeof(T)];
+
+		AINLINE T* Get() { return reinterpret_cast<T*>(storage); }
+	};
+
+public:
+	/* capacity must be a power of two. */
+	mpmc_queue(size_t capacity)
+		:
+		m_Mask(capacity - 1) {
+		assert(capacity >= 2 && (capacity & (capacity - 1)) == 0 && "mpmc_queue capacity must be a power of two");
+
+		m_Cells = (Cell*)Platform::AAllocUninitialized(CACHE_LINE_SIZE, sizeof(Cell) * capacity, MemoryTag::Container);
+		for (size_t i = 0; i < capacity; i++) {
+			new (&m_Cells[i].sequence) std::atomic<size_t>(i);
+		}
+	}
+
+	mpmc_queue(const mpmc_queue&) = delete;
+	mpmc_queue(mpmc_queue&&) = delete;
+	mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+	/* Must not race with producers or consumers. */
+	~mpmc_queue() {
+		size_t end = m_EnqueuePosition.load(std::memory_order_relaxed);
+		for (size_t position = m_DequeuePosition.load(std::memory_order_relaxed); position != end; position++) {
+			m_Cells[position & m_Mask].Get()->~T();
+		}
+		Platform::AFree(m_Cells);
+	}
+
+	AINLINE bool try_push(const T& element) { return try_emplace(element); }
+	AINLINE bool try_push(T&& element) { return try_emplace(std::move(element)); }
+
+	template<typename... Args>
+	bool try_emplace(Args&&... args) {
+		Cell* cell;
+		size_t position = m_EnqueuePosition.load(std::memory_order_relaxed);
+
+		while (true) {
+			cell = &m_Cells[position & m_Mask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+			if (difference == 0) {
+				if (m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (difference < 0) {
+				// The consumer of the previous lap hasn't freed this cell yet.
+				return false;
+			} else {
+				position = m_EnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		new (cell->storage) T(std::forward<Args>(args)...);
+		cell->sequence.store(position + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	bool try_pop(T& element) {
+		Cell* cell;
+		size_t position = m_DequeuePosition.load(std::memory_order_relaxed);
+
+		while (true) {
+			cell = &m_Cells[position & m_Mask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+
+			if (difference == 0) {
+				if (m_DequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (difference < 0) {
+				return false;
+			} else {
+				position = m_DequeuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		T* stored = cell->Get();
+		element = std::move(*stored);
+		stored->~T();
+		cell->sequence.store(position + m_Mask + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	AINLINE size_t capacity() const { return m_Mask + 1; }
+
+	/* Only a snapshot, other threads may change it right after. */
+	size_t size_approx() const {
+		size_t enqueued = m_EnqueuePosition.load(std::memory_order_relaxed);
+		size_t dequeued = m_DequeuePosition.load(std::memory_order_relaxed);
+		return enqueued > dequeued ? enqueued - dequeued : 0;
+	}
+
+private:
+	alignas(CACHE_LINE_SIZE) Cell* m_Cells;
+	size_t m_Mask;
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_EnqueuePosition{ 0 };
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_DequeuePosition{ 0 };
+	char m_Padding[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+};
\ No newline at end of file
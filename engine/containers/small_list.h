@@ -0,0 +1,321 @@
+#pragma once
+
+#include "defines.h"
+#include "containers/list.h"
+#include "platform/platform.h"
+
+#include <cstring>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+#include <new>
+
+/*
+ * list<T> with room for InlineCapacity elements inside the object itself.
+ * Nothing is allocated until the list grows past InlineCapacity, after which
+ * it behaves like a regular list. Meant for short lived or tiny collections.
+ */
+template<typename T, size_t InlineCapacity>
+class small_list {
+	using Element = T;
+	using ElementPtr = T*;
+	using ElementRef = T&;
+	using ConstElementRef = const T&;
+	using ElementRValue = T&&;
+
+	static_assert(InlineCapacity > 0, "small_list needs room for at least one inline element, use list otherwise.");
+
+	static constexpr bool IsTrivial = std::is_trivially_copyable_v<T>;
+	static constexpr bool IsOverAligned = alignof(T) > MINIMUM_ALIGNMENT_SIZE;
+public:
+	small_list()
+		:
+		m_Elements(inline_elements()),
+		m_Size(0),
+		m_Capacity(InlineCapacity)
+	{}
+
+	/* Reserves capacity elements, the list starts empty. */
+	small_list(size_t capacity)
+		:
+		small_list() {
+		reserve(capacity);
+	}
+
+	small_list(const small_list& rhs)
+		:
+		small_list() {
+		reserve(rhs.m_Size);
+		copy_construct(m_Elements, rhs.m_Elements, rhs.m_Size);
+		m_Size = rhs.m_Size;
+	}
+
+	small_list(small_list&& rhs) noexcept
+		:
+		small_list() {
+		take(std::move(rhs));
+	}
+
+	small_list& operator=(const small_list& rhs) {
+		if (this == &rhs) {
+			return *this;
+		}
+
+		remove_all();
+		reserve(rhs.m_Size);
+		copy_construct(m_Elements, rhs.m_Elements, rhs.m_Size);
+		m_Size = rhs.m_Size;
+
+		return *this;
+	}
+
+	small_list& operator=(small_list&& rhs) noexcept {
+		if (this == &rhs) {
+			return *this;
+		}
+
+		remove_all();
+		if (!is_inline()) {
+			release(m_Elements);
+			m_Elements = inline_elements();
+			m_Capacity = InlineCapacity;
+		}
+		take(std::move(rhs));
+
+		return *this;
+	}
+
+	~small_list() {
+		remove_all();
+		if (!is_inline()) {
+			release(m_Elements);
+		}
+	}
+
+	void push_back(ConstElementRef element) {
+		if (m_Size == m_Capacity) {
+			// element may live inside this list, so build the copy before the storage moves.
+			Element copy(element);
+			grow(m_Size + 1);
+			new (static_cast<void*>(&m_Elements[m_Size])) Element(std::move(copy));
+		} else {
+			new (static_cast<void*>(&m_Elements[m_Size])) Element(element);
+		}
+		m_Size++;
+	}
+
+	void push_back(ElementRValue element) {
+		emplace_back(std::move(element));
+	}
+
+	template<typename... Args>
+	ElementRef emplace_back(Args&&... args) {
+		if (m_Size == m_Capacity) {
+			Element element(std::forward<Args>(args)...);
+			grow(m_Size + 1);
+			new (static_cast<void*>(&m_Elements[m_Size])) Element(std::move(element));
+		} else {
+			new (static_cast<void*>(&m_Elements[m_Size])) Element(std::forward<Args>(args)...);
+		}
+		return m_Elements[m_Size++];
+	}
+
+	/* Makes room for at least capacity elements without changing the size. */
+	void reserve(size_t capacity) {
+		if (capacity > m_Capacity) {
+			reallocate(capacity);
+		}
+	}
+
+	size_t find_index(ConstElementRef element) const {
+		for (size_t i = 0; i < m_Size; i++) {
+			if (m_Elements[i] == element) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	void remove_last() {
+		if (m_Size != 0) {
+			m_Elements[--m_Size].~Element();
+		}
+	}
+
+	void remove_at(size_t index) {
+		assert(index < m_Size);
+
+		if constexpr (IsTrivial) {
+			memmove(&m_Elements[index], &m_Elements[index + 1], (m_Size - index - 1) * sizeof(Element));
+		} else {
+			for (size_t i = index; i + 1 < m_Size; i++) {
+				m_Elements[i] = std::move(m_Elements[i + 1]);
+			}
+			m_Elements[m_Size - 1].~Element();
+		}
+
+		m_Size--;
+	}
+
+	/* Destroys every element, the capacity is kept. */
+	void remove_all() {
+		if constexpr (!std::is_trivially_destructible_v<Element>) {
+			for (size_t i = 0; i < m_Size; i++) {
+				m_Elements[i].~Element();
+			}
+		}
+		m_Size = 0;
+	}
+
+	/* New elements are value initialized, zero for trivial types. */
+	void resize(size_t new_size) {
+		if (new_size > m_Capacity) {
+			grow(new_size);
+		}
+
+		if (new_size > m_Size) {
+			if constexpr (IsTrivial) {
+				memset(static_cast<void*>(&m_Elements[m_Size]), 0, (new_size - m_Size) * sizeof(Element));
+			} else {
+				for (size_t i = m_Size; i < new_size; i++) {
+					new (static_cast<void*>(&m_Elements[i])) Element();
+				}
+			}
+		} else if constexpr (!std::is_trivially_destructible_v<Element>) {
+			for (size_t i = new_size; i < m_Size; i++) {
+				m_Elements[i].~Element();
+			}
+		}
+
+		m_Size = new_size;
+	}
+
+	bool is_empty() const {
+		return m_Size == 0;
+	}
+
+	/* True while the elements still fit in the inline storage. */
+	bool is_inline() const {
+		return m_Elements == inline_elements();
+	}
+
+	size_t size() const { return m_Size; }
+	uint32_t size_u32() const { return (uint32_t)m_Size; }
+	size_t capacity() const { return m_Capacity; }
+
+	ConstElementRef operator[](size_t index) const {
+		assert(index < m_Size);
+		return m_Elements[index];
+	}
+
+	ElementRef operator[](size_t index) {
+		assert(index < m_Size);
+		return m_Elements[index];
+	}
+
+	const Element* begin() const { return m_Elements; }
+	const Element* end() const { return m_Elements + m_Size; }
+
+	ElementPtr begin() { return m_Elements; }
+	ElementPtr end() { return m_Elements + m_Size; }
+
+	const Element* data() const {
+		return m_Elements;
+	}
+
+	ElementPtr data() {
+		return m_Elements;
+	}
+
+private:
+	AINLINE ElementPtr inline_elements() { return reinterpret_cast<ElementPtr>(m_InlineStorage); }
+	AINLINE const Element* inline_elements() const { return reinterpret_cast<const Element*>(m_InlineStorage); }
+
+	void grow(size_t min_capacity) {
+		size_t new_capacity = m_Capacity * s_ResizeFactor;
+		if (new_capacity < min_capacity) {
+			new_capacity = min_capacity;
+		}
+		reallocate(new_capacity);
+	}
+
+	/* Always moves to the heap, the list never goes back to its inline storage once it spilled. */
+	void reallocate(size_t new_capacity) {
+		assert(new_capacity >= m_Size);
+
+		ElementPtr new_elements = allocate(new_capacity);
+		relocate(new_elements, m_Elements, m_Size);
+
+		if (!is_inline()) {
+			release(m_Elements);
+		}
+		m_Elements = new_elements;
+		m_Capacity = new_capacity;
+	}
+
+	/* Expects this list to be empty and inline. */
+	void take(small_list&& rhs) {
+		if (rhs.is_inline()) {
+			relocate(m_Elements, rhs.m_Elements, rhs.m_Size);
+			m_Size = rhs.m_Size;
+			rhs.m_Size = 0;
+			return;
+		}
+
+		m_Elements = rhs.m_Elements;
+		m_Size = rhs.m_Size;
+		m_Capacity = rhs.m_Capacity;
+		rhs.m_Elements = rhs.inline_elements();
+		rhs.m_Size = 0;
+		rhs.m_Capacity = InlineCapacity;
+	}
+
+	/* Moves count elements into uninitialized destination and destroys the sources. */
+	static void relocate(ElementPtr destination, ElementPtr source, size_t count) {
+		if constexpr (IsTrivial) {
+			if (count != 0) {
+				memcpy(static_cast<void*>(destination), source, count * sizeof(Element));
+			}
+		} else {
+			for (size_t i = 0; i < count; i++) {
+				new (static_cast<void*>(&destination[i])) Element(std::move(source[i]));
+				source[i].~Element();
+			}
+		}
+	}
+
+	static void copy_construct(ElementPtr destination, const Element* source, size_t count) {
+		if constexpr (IsTrivial) {
+			if (count != 0) {
+				memcpy(static_cast<void*>(destination), source, count * sizeof(Element));
+			}
+		} else {
+			for (size_t i = 0; i < count; i++) {
+				new (static_cast<void*>(&destination[i])) Element(source[i]);
+			}
+		}
+	}
+
+	static ElementPtr allocate(size_t element_count) {
+		if constexpr (IsOverAligned) {
+			return (ElementPtr)Platform::AAllocUninitialized(alignof(Element), element_count * sizeof(Element), MemoryTag::Container);
+		} else {
+			return (ElementPtr)Platform::UAllocUninitialized(element_count * sizeof(Element), MemoryTag::Container);
+		}
+	}
+
+	static void release(ElementPtr elements) {
+		if constexpr (IsOverAligned) {
+			Platform::AFree(elements);
+		} else {
+			Platform::UFree(elements);
+		}
+	}
+
+private:
+	ElementPtr m_Elements;
+	size_t m_Size;
+	size_t m_Capacity;
+	alignas(Element) unsigned char m_InlineStorage[sizeof(Element) * InlineCapacity];
+};
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "defines.h"
+#include "platform/platform.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+/*
+ * Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ * Each side keeps a private copy of the other side's index and only reloads it when
+ * the queue looks full or empty, so in steady state neither side reads the other's cache line.
+ */
+template<typename T>
+class spsc_queue {
+public:
+	/* capacity must be a power of two. */
+	spsc_queue(size_t capacity)
+		:
+		m_Mask(capacity - 1) {
+		assert(capacity >= 2 && (capacity & (capacity - 1)) == 0 && "spsc_queue capacity must be a power of two");
+		m_Elements = (T*)Platform::AAllocUninitialized(alignof(T) > CACHE_LINE_SIZE ? alignof(T) : CACHE_LINE_SIZE, sizeof(T) * capacity, MemoryTag::Container);
+	}
+
+	spsc_queue(const spsc_queue&) = delete;
+	spsc_queue(spsc_queue&&) = delete;
+	spsc_queue& operator=(const spsc_queue&) = delete;
+
+	/* Must not race with the producer or the consumer. */
+	~spsc_queue() {
+		size_t tail = m_Tail.load(std::memory_order_relaxed);
+		for (size_t head = m_Head.load(std::memory_order_relaxed); head != tail; head++) {
+			m_Elements[head & m_Mask].~T();
+		}
+		Platform::AFree(m_Elements);
+	}
+
+	/* Producer only. */
+	AINLINE bool try_push(const T& element) { return try_emplace(element); }
+	AINLINE bool try_push(T&& element) { return try_emplace(std::move(element)); }
+
+	/* Producer only. */
+	template<typename... Args>
+	bool try_emplace(Args&&... args) {
+		size_t tail = m_Tail.load(std::memory_order_relaxed);
+
+		if (tail - m_CachedHead > m_Mask) {
+			m_CachedHead = m_Head.load(std::memory_order_acquire);
+			if (tail - m_CachedHead > m_Mask) {
+				return false;
+			}
+		}
+
+		new (&m_Elements[tail & m_Mask]) T(std::forward<Args>(args)...);
+		m_Tail.store(tail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	/* Consumer only. */
+	bool try_pop(T& element) {
+		size_t head = m_Head.load(std::memory_order_relaxed);
+
+		if (head == m_CachedTail) {
+			m_CachedTail = m_Tail.load(std::memory_order_acquire);
+			if (head == m_CachedTail) {
+				return false;
+			}
+		}
+
+		T* stored = &m_Elements[head & m_Mask];
+		element = std::move(*stored);
+		stored->~T();
+		m_Head.store(head + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	/* Consumer only. Returns nullptr if the queue is empty, the element stays queued until pop. */
+	T* front() {
+		size_t head = m_Head.load(std::memory_order_relaxed);
+
+		if (head == m_CachedTail) {
+			m_CachedTail = m_Tail.load(std::memory_order_acquire);
+			if (head == m_CachedTail) {
+				return nullptr;
+			}
+		}
+
+		return &m_Elements[head & m_Mask];
+	}
+
+	/* Consumer only. Drops the element returned by front. */
+	void pop() {
+		size_t head = m_Head.load(std::memory_order_relaxed);
+		assert(head != m_CachedTail && "spsc_queue::pop called on an empty queue");
+		m_Elements[head & m_Mask].~T();
+		m_Head.store(head + 1, std::memory_order_release);
+	}
+
+	AINLINE size_t capacity() const { return m_Mask + 1; }
+
+	/* Only a snapshot, the other side may change it right after. */
+	size_t size_approx() const {
+		return m_Tail.load(std::memory_order_acquire) - m_Head.load(std::memory_order_acquire);
+	}
+
+private:
+	T* m_Elements;
+	size_t m_Mask;
+	/* Written by the consumer. */
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_Head{ 0 };
+	size_t m_CachedTail = 0;
+	/* Written by the producer. */
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_Tail{ 0 };
+	size_t m_CachedHead = 0;
+	char m_Padding[CACHE_LINE_SIZE - 2 * sizeof(size_t)];
+};
\ No newline at end of file
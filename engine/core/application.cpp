@@ -1,7 +1,11 @@
 #include "application.h"
 
 #include "game_interface.h"
+#include "core/event.h"
+#include "core/job_system.h"
 #include "core/logger.h"
+#include "ecs/registry.h"
+#include "ecs/world.h"
 #include "platform/platform.h"
 #include "renderer/renderer_frontend.h"
 #include "renderer/vulkan/vulkan_backend.h"
@@ -18,22 +22,30 @@ int Application::Run() {
     int ret_val = 0;
 
     if (m_Game == nullptr) {
-        Logger::Fatal("Failed to initialize engine: IGame* is nullptr");
+        LOG_FATAL("Failed to initialize engine: IGame* is nullptr");
         return -1;
     }
 
     try {
         m_Platform = new Platform();
         Logger::InitializeLogging();
-        m_Window = Platform::Construct<Window>(100, 100, 800, 600, "Stimply Engine");
-        m_RendererBackend = Platform::Construct<VulkanBackend>("Stimply Engine", *m_Window);
-        m_Renderer = Platform::Construct<RendererFrontend>(*m_RendererBackend);
+        JobSystem::Initialize();
+        m_Window = Platform::Construct<Window, MemoryTag::Core>(100, 100, 800, 600, "Stimply Engine");
+        m_RendererBackend = Platform::Construct<VulkanBackend, MemoryTag::Renderer>("Stimply Engine", *m_Window);
+        m_Renderer = Platform::Construct<RendererFrontend, MemoryTag::Renderer>(*m_RendererBackend);
+        m_Registry = Platform::Construct<Registry, MemoryTag::Core>();
+        m_World = Platform::Construct<World, MemoryTag::Core>();
         
         // By this point, the engine is all initialized.
 
         m_Game->OnBegin();
 
         while (m_Window->ProcessMessages()) {
+            // Input queued by ProcessMessages reaches subscribers here, in one batch per event type.
+            EventBus::DispatchQueuedEvents();
+
+            // Everything allocated from the frame allocator two frames ago is released here.
+            Platform::AdvanceFrameAllocator();
 
             int64_t current_time = Platform::GetTime();
             static int64_t last_time = current_time;
@@ -49,7 +61,7 @@ int Application::Run() {
             packet.deltaTime = m_DeltaTime;
 
             if (!m_Renderer->DrawFrame(packet)) {
-                Logger::Fatal("Failed trying to render the frame");
+                LOG_FATAL("Failed trying to render the frame");
                 ret_val = -2;
                 break;
             }
@@ -57,21 +69,26 @@ int Application::Run() {
 
         m_Renderer->WaitDeviceIdle();
         m_Game->OnShutdown();
-        
-        Logger::ShutdownLogging();        
     }
     catch (const std::exception& exception) {
-        Logger::Fatal("Error: %s", exception.what());
+        LOG_FATAL("Error: %s", exception.what());
         Window::MessageBox("Fatal error", exception.what());
         ret_val = -3;
     }
 
+    // Jobs may still use anything below.
+    JobSystem::Shutdown();
+    Platform::Destroy(m_World);
+    Platform::Destroy(m_Registry);
     Platform::Destroy(m_Renderer);
     Platform::Destroy(m_RendererBackend);
     Platform::Destroy(m_Window);
+    EventBus::ReleaseChannels();
     delete m_Platform;
 
-    Logger::Info("Leaving engine...");
+    LOG_INFO("Leaving engine...");
+    // Last, so messages from shutting everything down still make it to the log file.
+    Logger::ShutdownLogging();
 
 	return ret_val;
 }
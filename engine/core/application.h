@@ -5,6 +5,8 @@ class RendererFrontend;
 class RendererBackend;
 class Window;
 class Platform;
+class Registry;
+class World;
 
 class RAPI Application {
 public:
@@ -14,6 +16,8 @@ public:
 	inline void SetGame(IGame* game) { m_Game = game; }
 	inline RendererFrontend* GetRenderer() const { return m_Renderer; }
 	inline const Window* GetWindow() const { return m_Window; }
+	inline Registry* GetRegistry() const { return m_Registry; }
+	inline World* GetWorld() const { return m_World; }
 
 	int Run();
 
@@ -21,6 +25,8 @@ private:
 	IGame* m_Game = nullptr;
 	Platform* m_Platform = nullptr;
 	RendererFrontend* m_Renderer = nullptr;
+	Registry* m_Registry = nullptr;
+	World* m_World = nullptr;
 	Window* m_Window = nullptr;
 	float m_DeltaTime = 0.0f;
 	RendererBackend* m_RendererBackend = nullptr;
@@ -0,0 +1,287 @@
+#include "binary_log.h"
+
+#include "platform/platform.h"
+
+#include <cstring>
+#include <mutex>
+
+static constexpr uint64_t BINARY_LOG_FORMAT_TABLE_SIZE = 1024 * 1024;
+/* Rings smaller than this would only hold a few seconds of a busy thread. */
+static constexpr uint64_t BINARY_LOG_MIN_RING_SIZE = 64 * 1024;
+static constexpr uint64_t BINARY_LOG_PAGE_SIZE = 4096;
+/* Format address -> id, a power of two. Filled to at most 3/4. */
+static constexpr uint32_t FORMAT_ID_SLOTS = 4096;
+/* Per thread cache in front of it, a power of two. */
+static constexpr uint32_t FORMAT_CACHE_SIZE = 256;
+static constexpr uint32_t NO_FORMAT_ID = ~0u;
+static constexpr uint32_t NO_RING = ~0u;
+
+struct FormatIdSlot {
+	const char* format;
+	uint32_t id;
+};
+
+struct BinaryLogState {
+	BinaryLogRingHeader* rings = nullptr;
+	char* ringData = nullptr;
+	char* formatTable = nullptr;
+	std::atomic<bool> ringOwned[BINARY_LOG_MAX_THREADS]{};
+	/* Bumped on every Close so threads drop their ring and cached ids. */
+	std::atomic<uint32_t> generation{ 1 };
+
+	std::mutex formatMutex;
+	FormatIdSlot formatIds[FORMAT_ID_SLOTS]{};
+	uint32_t formatCount = 0;
+};
+
+static BinaryLogState s_BinaryLog;
+
+struct ThreadBinaryLog {
+	~ThreadBinaryLog() {
+		if (ring != NO_RING && generation == s_BinaryLog.generation.load(std::memory_order_relaxed)) {
+			s_BinaryLog.ringOwned[ring].store(false, std::memory_order_release);
+		}
+	}
+
+	uint32_t ring = NO_RING;
+	uint32_t generation = 0;
+	FormatIdSlot cache[FORMAT_CACHE_SIZE]{};
+};
+
+static AINLINE uint64_t hash_format(const char* format) {
+	return ((uint64_t)(uintptr_t)format >> 3) * 0x9e3779b97f4a7c15ull;
+}
+
+/* Records the format in the file the first time it's seen, ids are only ever added. */
+static uint32_t register_format(BinaryLogFileHeader* header, const char* format) {
+	std::lock_guard<std::mutex> lock(s_BinaryLog.formatMutex);
+
+	uint64_t mask = FORMAT_ID_SLOTS - 1;
+	uint64_t index = hash_format(format) >> 52 & mask;
+	for (;; index = (index + 1) & mask) {
+		FormatIdSlot& slot = s_BinaryLog.formatIds[index];
+		if (slot.format == format) {
+			return slot.id;
+		}
+		if (!slot.format) {
+			break;
+		}
+	}
+
+	uint64_t length = strlen(format);
+	uint64_t entrySize = binary_log_align(sizeof(BinaryLogFormat) + length + 1);
+	uint64_t used = header->formatTableUsed.load(std::memory_order_relaxed);
+	if ((s_BinaryLog.formatCount + 1) * 4 > FORMAT_ID_SLOTS * 3 || used + entrySize > header->formatTableSize) {
+		return NO_FORMAT_ID;
+	}
+
+	BinaryLogFormat* entry = (BinaryLogFormat*)(s_BinaryLog.formatTable + used);
+	entry->id = s_BinaryLog.formatCount++;
+	entry->length = (uint32_t)length;
+	memcpy(entry + 1, format, length + 1);
+	header->formatTableUsed.store(used + entrySize, std::memory_order_release);
+
+	s_BinaryLog.formatIds[index] = { format, entry->id };
+	return entry->id;
+}
+
+static AINLINE uint32_t find_format_id(BinaryLogFileHeader* header, ThreadBinaryLog& thread, const char* format) {
+	FormatIdSlot& cached = thread.cache[hash_format(format) >> 56 & (FORMAT_CACHE_SIZE - 1)];
+	if (cached.format == format) {
+		return cached.id;
+	}
+
+	uint32_t id = register_format(header, format);
+	if (id != NO_FORMAT_ID) {
+		cached = { format, id };
+	}
+	return id;
+}
+
+static uint32_t claim_ring() {
+	for (uint32_t i = 0; i < BINARY_LOG_MAX_THREADS; i++) {
+		bool expected = false;
+		if (!s_BinaryLog.ringOwned[i].load(std::memory_order_relaxed) &&
+			s_BinaryLog.ringOwned[i].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+			return i;
+		}
+	}
+	return NO_RING;
+}
+
+/* Position of the record after the one at position, stepping over the unused end of the ring. */
+static uint64_t next_record(const char* data, uint64_t position, uint64_t ringSize) {
+	uint64_t offset = position & (ringSize - 1);
+	uint64_t toEnd = ringSize - offset;
+	if (toEnd < sizeof(BinaryLogRecord)) {
+		return position + toEnd;
+	}
+
+	uint32_t size = ((const BinaryLogRecord*)(data + offset))->size;
+	return size == BINARY_LOG_WRAP_RECORD ? position + toEnd : position + size;
+}
+
+bool BinaryLog::Open(const char* path, uint64_t size) {
+	if (s_Header) {
+		return true;
+	}
+
+	uint64_t ringHeadersOffset = binary_log_align(sizeof(BinaryLogFileHeader));
+	uint64_t formatTableOffset = ringHeadersOffset + sizeof(BinaryLogRingHeader) * BINARY_LOG_MAX_THREADS;
+	uint64_t ringOffset = (formatTableOffset + BINARY_LOG_FORMAT_TABLE_SIZE + BINARY_LOG_PAGE_SIZE - 1) & ~(BINARY_LOG_PAGE_SIZE - 1);
+
+	uint64_t ringSize = BINARY_LOG_MIN_RING_SIZE;
+	while (size > ringOffset && ringSize * 2 <= (size - ringOffset) / BINARY_LOG_MAX_THREADS) {
+		ringSize *= 2;
+	}
+
+	uint64_t fileSize = ringOffset + ringSize * BINARY_LOG_MAX_THREADS;
+
+	// MapFile truncates, so the log of the last run, possibly one that crashed, is kept next to it to be decoded.
+	char previousPath[512];
+	Formatter::FormatTo(previousPath, sizeof(previousPath), "%s.prev", path);
+	Platform::RenameFile(path, previousPath);
+
+	char* memory = (char*)Platform::MapFile(path, fileSize);
+	if (!memory) {
+		return false;
+	}
+
+	// A new mapping is all zeros, so the rings start out empty.
+	BinaryLogFileHeader* header = (BinaryLogFileHeader*)memory;
+	header->version = BINARY_LOG_VERSION;
+	header->fileSize = fileSize;
+	header->startTime = Platform::GetTime();
+	header->formatTableOffset = formatTableOffset;
+	header->formatTableSize = BINARY_LOG_FORMAT_TABLE_SIZE;
+	header->ringOffset = ringOffset;
+	header->ringSize = ringSize;
+	header->ringCount = BINARY_LOG_MAX_THREADS;
+	header->magic = BINARY_LOG_MAGIC;
+
+	s_BinaryLog.rings = (BinaryLogRingHeader*)(memory + ringHeadersOffset);
+	s_BinaryLog.formatTable = memory + formatTableOffset;
+	s_BinaryLog.ringData = memory + ringOffset;
+	s_Header = header;
+
+	return true;
+}
+
+void BinaryLog::Close() {
+	if (!s_Header) {
+		return;
+	}
+
+	// Left mapped, a thread that read s_Header before this may still be writing a record. The pages are
+	// written back to the file by the system, at the latest when the process exits.
+	s_Header = nullptr;
+
+	s_BinaryLog.generation.fetch_add(1, std::memory_order_relaxed);
+	for (std::atomic<bool>& owned : s_BinaryLog.ringOwned) {
+		owned.store(false, std::memory_order_relaxed);
+	}
+	memset(s_BinaryLog.formatIds, 0, sizeof(s_BinaryLog.formatIds));
+	s_BinaryLog.formatCount = 0;
+}
+
+bool BinaryLog::Write(log_level level, const char* format, const FormatArg* args, uint32_t argCount) {
+	static thread_local ThreadBinaryLog thread;
+
+	BinaryLogFileHeader* header = s_Header;
+	if (!header || argCount > 0xff) {
+		return false;
+	}
+
+	uint32_t generation = s_BinaryLog.generation.load(std::memory_order_relaxed);
+	if (thread.generation != generation) {
+		memset(thread.cache, 0, sizeof(thread.cache));
+		thread.ring = claim_ring();
+		thread.generation = generation;
+	}
+
+	if (thread.ring == NO_RING) {
+		return false;
+	}
+
+	uint32_t formatId = find_format_id(header, thread, format);
+	if (formatId == NO_FORMAT_ID) {
+		return false;
+	}
+
+	uint64_t size = sizeof(BinaryLogRecord);
+	for (uint32_t i = 0; i < argCount; i++) {
+		size += sizeof(BinaryLogArg) + binary_log_payload_size(args[i].type, args[i].type == FormatArgType::String ? args[i].string.size : 0);
+	}
+	size = binary_log_align(size);
+
+	uint64_t ringSize = header->ringSize;
+	if (size > ringSize / 2) {
+		return false;
+	}
+
+	BinaryLogRingHeader& ring = s_BinaryLog.rings[thread.ring];
+	char* data = s_BinaryLog.ringData + thread.ring * ringSize;
+
+	uint64_t head = ring.head.load(std::memory_order_relaxed);
+	uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+	uint64_t offset = head & (ringSize - 1);
+	uint64_t toEnd = ringSize - offset;
+	uint64_t required = size > toEnd ? toEnd + size : size;
+
+	if (head + required - tail > ringSize) {
+		// Drop the oldest records. tail has to land in memory before they're overwritten, a crash
+		// halfway through this write must not leave the decoder reading a torn record.
+		while (head + required - tail > ringSize) {
+			tail = next_record(data, tail, ringSize);
+		}
+		ring.tail.store(tail, std::memory_order_release);
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+	}
+
+	if (size > toEnd) {
+		if (toEnd >= sizeof(BinaryLogRecord)) {
+			((BinaryLogRecord*)(data + offset))->size = BINARY_LOG_WRAP_RECORD;
+		}
+		head += toEnd;
+		offset = 0;
+	}
+
+	char* cursor = data + offset;
+	BinaryLogRecord* record = (BinaryLogRecord*)cursor;
+	record->size = (uint32_t)size;
+	record->formatId = formatId;
+	record->time = Platform::GetTime();
+	record->level = level;
+	record->argCount = (uint8_t)argCount;
+	cursor += sizeof(BinaryLogRecord);
+
+	for (uint32_t i = 0; i < argCount; i++) {
+		const FormatArg& arg = args[i];
+
+		BinaryLogArg* argHeader = (BinaryLogArg*)cursor;
+		argHeader->type = arg.type;
+		argHeader->size = arg.size;
+		cursor += sizeof(BinaryLogArg);
+
+		switch (arg.type) {
+		case FormatArgType::String: {
+			uint32_t length = (uint32_t)arg.string.size;
+			memcpy(cursor, &length, sizeof(length));
+			memcpy(cursor + sizeof(length), arg.string.data, length);
+			break;
+		}
+		case FormatArgType::Float2:
+		case FormatArgType::Float3:
+		case FormatArgType::Float4:
+			memcpy(cursor, arg.floats, sizeof(float) * binary_log_float_count(arg.type));
+			break;
+		default:
+			memcpy(cursor, &arg.u, sizeof(arg.u));
+			break;
+		}
+		cursor += binary_log_payload_size(arg.type, arg.type == FormatArgType::String ? arg.string.size : 0);
+	}
+
+	ring.head.store(head + size, std::memory_order_release);
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "defines.h"
+#include "core/format.h"
+#include "core/logger.h"
+
+#include <atomic>
+#include <cstdint>
+
+/*
+ * Layout of the binary log file, shared with Stimply-LogDecode.
+ *
+ * [BinaryLogFileHeader][BinaryLogRingHeader x threadRingCount][format table][ring 0][ring 1]...
+ *
+ * The format table is append only: each format string is stored once, the first time it's logged, and its
+ * index is the id records refer to. Every thread writes to its own ring: a record is a BinaryLogRecord followed
+ * by the raw arguments, each a BinaryLogArg and its payload. Once a ring is full the oldest records are dropped,
+ * tail is moved past them before they're overwritten and head only moves once a record is complete,
+ * so whatever lies between tail and head is always whole, even after a crash.
+ */
+static inline constexpr uint32_t BINARY_LOG_MAGIC = 0x474c5453; // "STLG"
+static inline constexpr uint32_t BINARY_LOG_VERSION = 2;
+static inline constexpr uint32_t BINARY_LOG_MAX_THREADS = 16;
+/* Record size marking the rest of a ring as unused, the next record starts at the beginning. */
+static inline constexpr uint32_t BINARY_LOG_WRAP_RECORD = ~0u;
+static inline constexpr uint64_t BINARY_LOG_ALIGNMENT = 8;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "The file layout relies on plain 64 bit atomics");
+
+struct BinaryLogFileHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t fileSize;
+	/* Platform::GetTime when the file was created, record times are relative to the same clock. */
+	int64_t startTime;
+	uint64_t formatTableOffset;
+	uint64_t formatTableSize;
+	std::atomic<uint64_t> formatTableUsed;
+	uint64_t ringOffset;
+	/* Per thread, a power of two. */
+	uint64_t ringSize;
+	uint32_t ringCount;
+	uint32_t padding;
+};
+
+struct alignas(CACHE_LINE_SIZE) BinaryLogRingHeader {
+	std::atomic<uint64_t> head;
+	std::atomic<uint64_t> tail;
+};
+
+/* Followed by length characters and a terminator, padded to BINARY_LOG_ALIGNMENT. */
+struct BinaryLogFormat {
+	uint32_t id;
+	uint32_t length;
+};
+
+struct BinaryLogRecord {
+	/* Including this header and the padding after the arguments. */
+	uint32_t size;
+	uint32_t formatId;
+	int64_t time;
+	log_level level;
+	uint8_t argCount;
+	uint8_t padding[6];
+};
+
+/*
+ * Payload: 8 bytes for integers, bools, doubles and pointers (FormatArg::u), a uint32_t length and the
+ * characters for strings, 2 to 4 floats for vectors. Payloads are padded to 4 bytes so the next argument stays aligned.
+ */
+struct BinaryLogArg {
+	FormatArgType type;
+	/* FormatArg::size */
+	uint8_t size;
+	uint8_t padding[2];
+};
+
+static AINLINE uint64_t binary_log_align(uint64_t size) {
+	return (size + BINARY_LOG_ALIGNMENT - 1) & ~(BINARY_LOG_ALIGNMENT - 1);
+}
+
+/* Floats in a vector argument. */
+static AINLINE uint32_t binary_log_float_count(FormatArgType type) {
+	return 2 + (uint32_t)type - (uint32_t)FormatArgType::Float2;
+}
+
+/* Bytes an argument takes after its BinaryLogArg. */
+static AINLINE uint64_t binary_log_payload_size(FormatArgType type, uint64_t stringLength) {
+	switch (type) {
+	case FormatArgType::String:
+		return (sizeof(uint32_t) + stringLength + 3) & ~3ull;
+	case FormatArgType::Float2:
+	case FormatArgType::Float3:
+	case FormatArgType::Float4:
+		return sizeof(float) * binary_log_float_count(type);
+	default:
+		return sizeof(uint64_t);
+	}
+}
+
+/*
+ * Writer side, used by Logger while LoggerConfig::binaryLogPath is set. Records a message as the id of its
+ * format and the raw bytes of its arguments, no formatting happens at runtime. The format must be a string literal
+ * (or otherwise never change for as long as the log is open), ids are looked up by its address.
+ */
+class BinaryLog {
+public:
+	static bool Open(const char* path, uint64_t size);
+	/* Stops recording. The file stays mapped for the rest of the process, Write calls already past IsOpen may still land in it. */
+	static void Close();
+
+	static AINLINE bool IsOpen() { return s_Header != nullptr; }
+
+	/* False if the message couldn't be recorded (too big, too many threads or formats) and has to be logged as text. */
+	static bool Write(log_level level, const char* format, const FormatArg* args, uint32_t argCount);
+
+private:
+	static inline BinaryLogFileHeader* s_Header = nullptr;
+};
\ No newline at end of file
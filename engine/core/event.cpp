@@ -1,38 +1,218 @@
 #include "event.h"
 
+#include "allocator/linear_allocator.h"
 #include "core/logger.h"
+#include "platform/platform.h"
 
-bool IEvent::RegisterListener(IEvent* pEvent, EventType type) {
-	// -1 means there's no entry in this event type list.
-	bool isAlreadyRegistered = s_EventListeners[type].find_index(pEvent) != -1;
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
 
-	if (isAlreadyRegistered) {
-		Logger::Warning("Trying to register listener (%p) more than once in event code %i", pEvent, type);
+/* Channel states are never freed, so cached pointers to them stay valid. This only reserves address space. */
+static constexpr size_t EVENT_CHANNEL_RESERVE = 4 * 1024 * 1024;
+/* Returned by find_subscriber when the subscriber isn't in the channel. */
+static constexpr size_t NOT_SUBSCRIBED = SIZE_MAX;
+
+/* An event posted from any thread, the event's bytes follow the header. */
+struct PostedEvent {
+	PostedEvent* next;
+	EventChannelState* channel;
+};
+
+static constexpr size_t POSTED_EVENT_HEADER_SIZE = (sizeof(PostedEvent) + MINIMUM_ALIGNMENT_SIZE - 1) & ~(MINIMUM_ALIGNMENT_SIZE - 1);
+
+static LinearAllocator& get_channel_allocator() {
+	static LinearAllocator allocator(EVENT_CHANNEL_RESERVE);
+	return allocator;
+}
+
+/* Guards s_Channels, channels can be created from any thread the first time a type is used there. */
+static std::mutex s_ChannelMutex;
+static list<EventChannelState*> s_Channels;
+static uint32_t s_QueueIndex = 0;
+/* Newest first. Producers push with a CAS, the main thread takes the whole list at once, so there's no ABA. */
+static std::atomic<PostedEvent*> s_Inbox{ nullptr };
+
+static size_t find_subscriber(const EventChannelState& channel, const EventSubscriber& subscriber) {
+	for (size_t i = 0; i < channel.subscribers.size(); i++) {
+		const EventSubscriber& other = channel.subscribers[i];
+		if (other.callback == subscriber.callback && other.context == subscriber.context) {
+			return i;
+		}
+	}
+	return NOT_SUBSCRIBED;
+}
+
+static void compact_subscribers(EventChannelState& channel) {
+	size_t kept = 0;
+	for (size_t i = 0; i < channel.subscribers.size(); i++) {
+		if (channel.subscribers[i].callback) {
+			channel.subscribers[kept++] = channel.subscribers[i];
+		}
+	}
+
+	channel.subscribers.resize(kept);
+	channel.hasRemovedSubscribers = false;
+}
+
+/* Takes everything posted so far and appends it to the queues in the order it was posted. */
+static void drain_inbox() {
+	PostedEvent* posted = s_Inbox.exchange(nullptr, std::memory_order_acquire);
+
+	PostedEvent* oldest = nullptr;
+	while (posted) {
+		PostedEvent* next = posted->next;
+		posted->next = oldest;
+		oldest = posted;
+		posted = next;
+	}
+
+	while (oldest) {
+		PostedEvent* next = oldest->next;
+		EventBus::QueueEvent(*oldest->channel, (const uint8_t*)oldest + POSTED_EVENT_HEADER_SIZE);
+		Platform::UFree(oldest);
+		oldest = next;
+	}
+}
+
+static EventChannelState* get_channel_at(size_t index) {
+	std::lock_guard<std::mutex> lock(s_ChannelMutex);
+	return index < s_Channels.size() ? s_Channels[index] : nullptr;
+}
+
+EventChannelState* EventBus::GetChannel(uint64_t typeHash, size_t eventSize, void (*dispatch)(EventChannelState&, const uint8_t*, size_t)) {
+	std::lock_guard<std::mutex> lock(s_ChannelMutex);
+
+	for (size_t i = 0; i < s_Channels.size(); i++) {
+		if (s_Channels[i]->typeHash == typeHash) {
+			assert(s_Channels[i]->eventSize == eventSize && "Two event types hash to the same channel");
+			return s_Channels[i];
+		}
+	}
+
+	void* memory = get_channel_allocator().Allocate(sizeof(EventChannelState), alignof(EventChannelState));
+	assert(memory && "Out of memory for event channels");
+
+	EventChannelState* channel = new (memory) EventChannelState();
+	channel->typeHash = typeHash;
+	channel->eventSize = eventSize;
+	channel->dispatch = dispatch;
+
+	s_Channels.push_back(channel);
+
+	return channel;
+}
+
+bool EventBus::Subscribe(EventChannelState& channel, const EventSubscriber& subscriber) {
+	std::lock_guard<std::recursive_mutex> lock(channel.subscriberMutex);
+
+	if (find_subscriber(channel, subscriber) != NOT_SUBSCRIBED) {
+		LOG_WARNING("Trying to subscribe (%p, %p) more than once to an event channel", (void*)subscriber.callback, subscriber.context);
 		return false;
 	}
 
-	s_EventListeners[type].push_back(pEvent);
+	channel.subscribers.push_back(subscriber);
 
 	return true;
 }
 
-bool IEvent::UnregisterListener(IEvent* pEvent, EventType type) {
-	// -1 means there's no entry in this event type list.
-	size_t eventIndex = s_EventListeners[type].find_index(pEvent);
-	bool isAlreadyRegistered = eventIndex != -1;
+bool EventBus::Unsubscribe(EventChannelState& channel, const EventSubscriber& subscriber) {
+	std::lock_guard<std::recursive_mutex> lock(channel.subscriberMutex);
 
-	if (!isAlreadyRegistered) {
-		Logger::Warning("Listener (%p) is not registered for event code: %i", pEvent, type);
+	size_t index = find_subscriber(channel, subscriber);
+
+	if (index == NOT_SUBSCRIBED) {
+		LOG_WARNING("Subscriber (%p, %p) is not subscribed to this event channel", (void*)subscriber.callback, subscriber.context);
 		return false;
 	}
 
-	s_EventListeners[type].remove_at(eventIndex);
+	if (channel.dispatchDepth != 0) {
+		channel.subscribers[index] = { nullptr, nullptr, false };
+		channel.hasRemovedSubscribers = true;
+	} else {
+		channel.subscribers.remove_at(index);
+	}
 
 	return true;
 }
 
-void IEvent::FireEvent(EventType type, const EventData* eventData) {
-	for (size_t i = 0; i < s_EventListeners[type].size(); i++) {
-		s_EventListeners[type][i]->OnEvent(type, eventData);
+void EventBus::BeginDispatch(EventChannelState& channel) {
+	channel.subscriberMutex.lock();
+	channel.dispatchDepth++;
+}
+
+void EventBus::EndDispatch(EventChannelState& channel) {
+	if (--channel.dispatchDepth == 0 && channel.hasRemovedSubscribers) {
+		compact_subscribers(channel);
 	}
+	channel.subscriberMutex.unlock();
+}
+
+void EventBus::QueueEvent(EventChannelState& channel, const void* event) {
+	EventQueue& queue = channel.queues[s_QueueIndex];
+
+	size_t offset = queue.events.size();
+	queue.events.resize(offset + channel.eventSize);
+	memcpy(queue.events.data() + offset, event, channel.eventSize);
+	queue.count++;
+}
+
+void EventBus::PostEvent(EventChannelState& channel, const void* event) {
+	PostedEvent* posted = (PostedEvent*)Platform::UAllocUninitialized(POSTED_EVENT_HEADER_SIZE + channel.eventSize, MemoryTag::Core);
+	posted->channel = &channel;
+	memcpy((uint8_t*)posted + POSTED_EVENT_HEADER_SIZE, event, channel.eventSize);
+
+	PostedEvent* head = s_Inbox.load(std::memory_order_relaxed);
+	do {
+		posted->next = head;
+	} while (!s_Inbox.compare_exchange_weak(head, posted, std::memory_order_release, std::memory_order_relaxed));
+}
+
+const uint8_t* EventBus::GetDispatchedEvents(const EventChannelState& channel, size_t& count) {
+	const EventQueue& queue = channel.queues[s_QueueIndex ^ 1];
+	count = queue.count;
+	return queue.events.data();
 }
+
+void EventBus::DispatchQueuedEvents() {
+	drain_inbox();
+
+	uint32_t dispatchIndex = s_QueueIndex;
+	s_QueueIndex ^= 1;
+
+	// The batch dispatched last frame is done with, its memory is reused for the next one.
+	for (size_t i = 0; EventChannelState* channel = get_channel_at(i); i++) {
+		EventQueue& queue = channel->queues[s_QueueIndex];
+		queue.events.remove_all();
+		queue.count = 0;
+	}
+
+	// One channel at a time, so subscribers may use new event types and other threads may add channels meanwhile.
+	for (size_t i = 0; EventChannelState* channel = get_channel_at(i); i++) {
+		const EventQueue& queue = channel->queues[dispatchIndex];
+
+		if (queue.count != 0) {
+			channel->dispatch(*channel, queue.events.data(), queue.count);
+		}
+	}
+}
+
+void EventBus::ReleaseChannels() {
+	// Nothing will dispatch them anymore, this only frees their memory.
+	drain_inbox();
+
+	std::lock_guard<std::mutex> lock(s_ChannelMutex);
+
+	for (size_t i = 0; i < s_Channels.size(); i++) {
+		EventChannelState& channel = *s_Channels[i];
+		channel.subscribers = list<EventSubscriber>();
+		for (EventQueue& queue : channel.queues) {
+			queue.events = list<uint8_t>();
+			queue.count = 0;
+		}
+	}
+
+	// The states themselves stay, every EventChannel<T> keeps a pointer to its own.
+	s_Channels = list<EventChannelState*>();
+}
\ No newline at end of file
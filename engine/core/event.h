@@ -1,19 +1,200 @@
 #pragma once
 
+#include "defines.h"
 #include "event_types.h"
 #include "containers/list.h"
+#include "core/string_id.h"
 
-class RAPI IEvent {
+#include <cassert>
+#include <mutex>
+#include <type_traits>
+
+/* Read only view over events of one type, laid out back to back. */
+template<typename T>
+class EventSpan {
 public:
-	IEvent() = default;
-	virtual ~IEvent() = default;
+	EventSpan() = default;
+	EventSpan(const T* events, size_t count) : m_Events(events), m_Count(count) {}
+
+	const T* begin() const { return m_Events; }
+	const T* end() const { return m_Events + m_Count; }
 
-	virtual void OnEvent(EventType type, const EventData* eventData) = 0;
+	size_t size() const { return m_Count; }
+	bool is_empty() const { return m_Count == 0; }
 
-	static bool RegisterListener(IEvent* pEvent, EventType type);
-	static bool UnregisterListener(IEvent* pEvent, EventType type);
-	static void FireEvent(EventType type, const EventData* eventData);
+	const T& operator[](size_t index) const {
+		assert(index < m_Count);
+		return m_Events[index];
+	}
 
 private:
-	static inline list<IEvent*> s_EventListeners[EventType::MAX];
+	const T* m_Events = nullptr;
+	size_t m_Count = 0;
+};
+
+struct EventSubscriber {
+	/* The channel's Callback or BatchCallback, cast back to its real type before it's called. */
+	void (*callback)();
+	void* context;
+	bool batch;
+};
+
+/* Events of one type queued during a frame. */
+struct EventQueue {
+	list<uint8_t> events;
+	size_t count = 0;
+};
+
+/* Everything EventChannel<T> keeps, owned by EventBus so the engine and the game share one per type. */
+struct EventChannelState {
+	uint64_t typeHash;
+	size_t eventSize;
+	/* EventChannel<T>::Dispatch, calls the subscribers with count events. */
+	void (*dispatch)(EventChannelState& channel, const uint8_t* events, size_t count);
+	/*
+	 * Held while subscribers are called, recursive so they can subscribe and unsubscribe from their callback.
+	 * Subscribers added during a dispatch are called from the next one. Removed ones are only cleared to a null
+	 * callback and compacted once the outermost dispatch is done, so indices stay valid while it runs.
+	 */
+	std::recursive_mutex subscriberMutex;
+	list<EventSubscriber> subscribers;
+	uint32_t dispatchDepth = 0;
+	bool hasRemovedSubscribers = false;
+	/* Double buffered: EventBus's queue index is being filled while the other one holds the last dispatched batch. */
+	EventQueue queues[2];
+};
+
+/* Type independent half of the event channels. */
+class RAPI EventBus {
+public:
+	/* Finds or creates the channel of a type, the state lives until the process exits. */
+	static EventChannelState* GetChannel(uint64_t typeHash, size_t eventSize, void (*dispatch)(EventChannelState&, const uint8_t*, size_t));
+
+	/* Safe from any thread, including from a subscriber while the channel dispatches. */
+	static bool Subscribe(EventChannelState& channel, const EventSubscriber& subscriber);
+	static bool Unsubscribe(EventChannelState& channel, const EventSubscriber& subscriber);
+
+	/* Bracket every call to a channel's subscribers. */
+	static void BeginDispatch(EventChannelState& channel);
+	static void EndDispatch(EventChannelState& channel);
+
+	/* Copies eventSize bytes to the end of the channel's queue. Main thread only. */
+	static void QueueEvent(EventChannelState& channel, const void* event);
+	/* Same from any thread: the event goes through a lock free inbox, moved to the queue by the next DispatchQueuedEvents. */
+	static void PostEvent(EventChannelState& channel, const void* event);
+	static const uint8_t* GetDispatchedEvents(const EventChannelState& channel, size_t& count);
+
+	/*
+	 * Moves posted events to their queues, swaps the queues and dispatches everything queued since the last call,
+	 * channel by channel in the order they were first used. Events queued or posted by subscribers while this runs
+	 * go to the next batch. Application calls it once per frame on the main thread, right after the window's
+	 * messages are processed.
+	 */
+	static void DispatchQueuedEvents();
+
+	/* Frees the subscriber lists and queues, called before Platform shuts down. */
+	static void ReleaseChannels();
+};
+
+/* Same value for the same type in the engine and the game binaries, without RTTI. */
+template<typename T>
+uint64_t get_event_type_hash() {
+	return fnv1a_64(FUNCTION_SIGNATURE, sizeof(FUNCTION_SIGNATURE) - 1);
+}
+
+/*
+ * Publish/subscribe for events of type T, any trivially copyable struct. There is no central list of event types:
+ * a channel is created the first time its type is used. Subscribers are a function pointer and a context, stored
+ * contiguously and called directly with a typed event, either one event per call or a whole batch.
+ *
+ *   EventChannel<KeyboardEventData>::Subscribe<&Game::OnKey>(this);
+ *   EventChannel<KeyboardEventData>::Queue(eventData);
+ */
+template<typename T>
+class EventChannel {
+	static_assert(std::is_trivially_copyable_v<T>, "Events are copied around as bytes, they must be trivially copyable");
+public:
+	using Callback = void (*)(void* context, const T& event);
+	using BatchCallback = void (*)(void* context, EventSpan<T> events);
+
+	static bool Subscribe(Callback callback, void* context = nullptr) { return EventBus::Subscribe(GetState(), MakeSubscriber(callback, context)); }
+	static bool Subscribe(BatchCallback callback, void* context = nullptr) { return EventBus::Subscribe(GetState(), MakeSubscriber(callback, context)); }
+	static bool Unsubscribe(Callback callback, void* context = nullptr) { return EventBus::Unsubscribe(GetState(), MakeSubscriber(callback, context)); }
+	static bool Unsubscribe(BatchCallback callback, void* context = nullptr) { return EventBus::Unsubscribe(GetState(), MakeSubscriber(callback, context)); }
+
+	/* Method is a member function of Class taking either const T& or EventSpan<T>. */
+	template<auto Method, typename Class>
+	static bool Subscribe(Class* object) { return Subscribe(GetMemberCallback<Method, Class>(), object); }
+
+	template<auto Method, typename Class>
+	static bool Unsubscribe(Class* object) { return Unsubscribe(GetMemberCallback<Method, Class>(), object); }
+
+	/* Calls every subscriber right away on the calling thread, before returning. */
+	static void Publish(const T& event) {
+		Dispatch(GetState(), (const uint8_t*)&event, 1);
+	}
+
+	/* Subscribers get the event from the next EventBus::DispatchQueuedEvents. Main thread only. */
+	static void Queue(const T& event) {
+		EventBus::QueueEvent(GetState(), &event);
+	}
+
+	/* Queue for any thread, e.g. to announce a finished job. Subscribers still run on the main thread. */
+	static void Post(const T& event) {
+		EventBus::PostEvent(GetState(), &event);
+	}
+
+	/* Events from the last EventBus::DispatchQueuedEvents, for code that polls instead of subscribing. Valid until the next one. */
+	static EventSpan<T> GetDispatchedEvents() {
+		size_t count = 0;
+		const uint8_t* events = EventBus::GetDispatchedEvents(GetState(), count);
+		return EventSpan<T>((const T*)events, count);
+	}
+
+private:
+	static EventChannelState& GetState() {
+		static EventChannelState* state = EventBus::GetChannel(get_event_type_hash<T>(), sizeof(T), &Dispatch);
+		return *state;
+	}
+
+	template<typename Function>
+	static EventSubscriber MakeSubscriber(Function callback, void* context) {
+		return { reinterpret_cast<void (*)()>(callback), context, std::is_same_v<Function, BatchCallback> };
+	}
+
+	template<auto Method, typename Class>
+	static auto GetMemberCallback() {
+		if constexpr (std::is_invocable_v<decltype(Method), Class*, EventSpan<T>>) {
+			return (BatchCallback)[](void* context, EventSpan<T> events) { (((Class*)context)->*Method)(events); };
+		} else {
+			return (Callback)[](void* context, const T& event) { (((Class*)context)->*Method)(event); };
+		}
+	}
+
+	static void Dispatch(EventChannelState& channel, const uint8_t* events, size_t count) {
+		const T* typedEvents = (const T*)events;
+
+		EventBus::BeginDispatch(channel);
+
+		size_t subscriberCount = channel.subscribers.size();
+		for (size_t i = 0; i < subscriberCount; i++) {
+			// A copy, the subscriber list may grow while it's being called.
+			EventSubscriber subscriber = channel.subscribers[i];
+			if (!subscriber.callback) {
+				continue;
+			}
+
+			if (subscriber.batch) {
+				reinterpret_cast<BatchCallback>(subscriber.callback)(subscriber.context, EventSpan<T>(typedEvents, count));
+			} else {
+				Callback callback = reinterpret_cast<Callback>(subscriber.callback);
+				// Stops early if the subscriber unsubscribes in the middle of a batch.
+				for (size_t j = 0; j < count && channel.subscribers[i].callback; j++) {
+					callback(subscriber.context, typedEvents[j]);
+				}
+			}
+		}
+
+		EventBus::EndDispatch(channel);
+	}
 };
\ No newline at end of file
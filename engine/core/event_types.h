@@ -3,18 +3,9 @@
 #include "defines.h"
 #include "window/key_defines.h"
 
-enum EventType {
-	MouseMoved,
-	KeyboardEvent,
-	ApplicationQuit,
-	WindowResized,
+/* Events the engine sends through EventChannel<T>, any other trivially copyable struct works as an event too. */
 
-	MAX
-};
-
-struct EventData {};
-
-struct MouseEventData : EventData {
+struct MouseEventData {
 	// Relative mouse motion in the X direction. i.e: How much it has moved.
 	int32_t MouseXMotion;
 	// Relative mouse motion in the Y direction. i.e: How much it has moved.
@@ -25,12 +16,12 @@ struct MouseEventData : EventData {
 	int32_t MouseYScreen;
 };
 
-struct KeyboardEventData : EventData {
+struct KeyboardEventData {
 	Key Key;
 	bool Pressed;
 };
 
-struct WindowResizedEventData : EventData {
+struct WindowResizedEventData {
 	int32_t width;
 	int32_t height;
 };
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "fiber.h"
+
+#include "platform/platform.h"
+
+#include <cassert>
+#include <cstdint>
+
+#if defined(FIBER_TSAN)
+#include <sanitizer/tsan_interface.h>
+#endif
+
+static constexpr size_t FIBER_PAGE_SIZE = 4096;
+
+#if FIBERS_SUPPORTED
+
+extern "C" void stimply_fiber_switch(void** fromStackPointer, void* toStackPointer);
+extern "C" void stimply_fiber_start();
+
+/*
+ * stimply_fiber_switch pushes the callee saved registers, MXCSR and the x87 control word, stores the stack pointer
+ * in *fromStackPointer, then pops the same from toStackPointer and returns to wherever that context was suspended.
+ * A new context first returns to stimply_fiber_start, which calls r13 with r12 as its argument.
+ */
+asm(R"(
+	.text
+	.globl stimply_fiber_switch
+	.hidden stimply_fiber_switch
+	.type stimply_fiber_switch, @function
+	.p2align 4
+stimply_fiber_switch:
+	pushq %rbp
+	pushq %rbx
+	pushq %r12
+	pushq %r13
+	pushq %r14
+	pushq %r15
+	subq $8, %rsp
+	stmxcsr (%rsp)
+	fnstcw 4(%rsp)
+	movq %rsp, (%rdi)
+	movq %rsi, %rsp
+	ldmxcsr (%rsp)
+	fldcw 4(%rsp)
+	addq $8, %rsp
+	popq %r15
+	popq %r14
+	popq %r13
+	popq %r12
+	popq %rbx
+	popq %rbp
+	ret
+	.size stimply_fiber_switch, .-stimply_fiber_switch
+
+	.globl stimply_fiber_start
+	.hidden stimply_fiber_start
+	.type stimply_fiber_start, @function
+	.p2align 4
+stimply_fiber_start:
+	movq %r12, %rdi
+	callq *%r13
+	ud2
+	.size stimply_fiber_start, .-stimply_fiber_start
+)");
+
+bool fiber_create_stack(FiberStack& stack, size_t size) {
+	size = (size + FIBER_PAGE_SIZE - 1) & ~(FIBER_PAGE_SIZE - 1);
+	size_t reserveSize = size + FIBER_PAGE_SIZE;
+
+	uint8_t* memory = (uint8_t*)Platform::VReserve(reserveSize);
+	if (!memory) {
+		return false;
+	}
+
+	// The lowest page stays reserved only, that's the guard page.
+	if (!Platform::VCommit(memory + FIBER_PAGE_SIZE, size)) {
+		Platform::VRelease(memory, reserveSize);
+		return false;
+	}
+
+	stack.memory = memory;
+	stack.reserveSize = reserveSize;
+
+	return true;
+}
+
+void fiber_destroy_stack(FiberStack& stack) {
+	Platform::VRelease(stack.memory, stack.reserveSize);
+	stack.memory = nullptr;
+	stack.reserveSize = 0;
+}
+
+void fiber_make_context(FiberContext& context, const FiberStack& stack, void (*entry)(void*), void* argument) {
+	// What stimply_fiber_switch pops, in reverse. Returning to stimply_fiber_start leaves the stack 16 byte aligned for its call.
+	uint64_t* top = (uint64_t*)(((uintptr_t)stack.memory + stack.reserveSize) & ~(uintptr_t)15);
+	top[-1] = (uint64_t)&stimply_fiber_start;
+	top[-2] = 0;                   // rbp
+	top[-3] = 0;                   // rbx
+	top[-4] = (uint64_t)argument;  // r12
+	top[-5] = (uint64_t)entry;     // r13
+	top[-6] = 0;                   // r14
+	top[-7] = 0;                   // r15
+
+	uint32_t* control = (uint32_t*)&top[-8];
+	control[1] = 0;
+	asm volatile("stmxcsr %0" : "=m"(control[0]));
+	asm volatile("fnstcw %0" : "=m"(*(uint16_t*)&control[1]));
+
+	context.stackPointer = &top[-8];
+
+#if defined(FIBER_TSAN)
+	context.sanitizerFiber = __tsan_create_fiber(0);
+#endif
+}
+
+void fiber_release_context(FiberContext& context) {
+#if defined(FIBER_TSAN)
+	__tsan_destroy_fiber(context.sanitizerFiber);
+	context.sanitizerFiber = nullptr;
+#endif
+	context.stackPointer = nullptr;
+}
+
+void fiber_switch(FiberContext& from, FiberContext& to) {
+#if defined(FIBER_TSAN)
+	from.sanitizerFiber = __tsan_get_current_fiber();
+	__tsan_switch_to_fiber(to.sanitizerFiber, 0);
+#endif
+	stimply_fiber_switch(&from.stackPointer, to.stackPointer);
+}
+
+#else
+
+bool fiber_create_stack(FiberStack& stack, size_t size) {
+	return false;
+}
+
+void fiber_destroy_stack(FiberStack& stack) {}
+
+void fiber_make_context(FiberContext& context, const FiberStack& stack, void (*entry)(void*), void* argument) {
+	assert(false && "Fibers aren't supported on this platform");
+}
+
+void fiber_release_context(FiberContext& context) {}
+
+void fiber_switch(FiberContext& from, FiberContext& to) {
+	assert(false && "Fibers aren't supported on this platform");
+}
+
+#endif
\ No newline at end of file
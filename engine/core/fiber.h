@@ -0,0 +1,51 @@
+#pragma once
+
+#include "defines.h"
+
+#include <cstddef>
+
+/* Context switching is hand written, so far only for x86_64 with the System V calling convention. */
+#if defined(PLATFORM_LINUX) && defined(__x86_64__)
+#define FIBERS_SUPPORTED 1
+#else
+#define FIBERS_SUPPORTED 0
+#endif
+
+#if defined(__SANITIZE_THREAD__)
+#define FIBER_TSAN 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define FIBER_TSAN 1
+#endif
+#endif
+
+/*
+ * Where a fiber, or a thread that switched to one, was suspended. Callee saved registers are pushed
+ * on the suspended stack itself, so all that's kept here is the stack pointer.
+ */
+struct FiberContext {
+	void* stackPointer = nullptr;
+#if defined(FIBER_TSAN)
+	void* sanitizerFiber = nullptr;
+#endif
+};
+
+/* A fiber's stack, with an inaccessible guard page below it so an overflow faults instead of corrupting memory. */
+struct FiberStack {
+	void* memory = nullptr;
+	size_t reserveSize = 0;
+};
+
+/* size is rounded up to whole pages. Returns false if the address space couldn't be reserved. */
+bool fiber_create_stack(FiberStack& stack, size_t size);
+void fiber_destroy_stack(FiberStack& stack);
+
+/*
+ * The first switch to context calls entry(argument) at the top of stack, with the floating point modes
+ * of the calling thread. entry must never return, it switches to another context instead.
+ */
+void fiber_make_context(FiberContext& context, const FiberStack& stack, void (*entry)(void*), void* argument);
+void fiber_release_context(FiberContext& context);
+
+/* Suspends the running code into from and resumes to. */
+void fiber_switch(FiberContext& from, FiberContext& to);
\ No newline at end of file
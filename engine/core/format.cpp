@@ -0,0 +1,477 @@
+#include "format.h"
+
+#include <cassert>
+#include <charconv>
+#include <cmath>
+
+/* Enough for a fixed notation double (309 integer digits) with the largest precision we let through. */
+static constexpr int32_t MAX_FLOAT_PRECISION = 128;
+static constexpr uint64_t FLOAT_BUFFER_SIZE = 512;
+
+static constexpr char DIGIT_PAIRS[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+struct FormatSpec {
+	bool leftAlign = false;
+	bool zeroPad = false;
+	bool alternate = false;
+	/* '+', ' ' or 0. */
+	char positiveSign = 0;
+	int32_t width = 0;
+	/* -1 when none was given. */
+	int32_t precision = -1;
+	char conversion = 0;
+};
+
+/* Writes value backwards ending at end, returns where it starts. */
+static char* write_decimal(char* end, uint64_t value) {
+	while (value >= 100) {
+		uint64_t pair = (value % 100) * 2;
+		value /= 100;
+		end -= 2;
+		memcpy(end, DIGIT_PAIRS + pair, 2);
+	}
+
+	if (value >= 10) {
+		end -= 2;
+		memcpy(end, DIGIT_PAIRS + value * 2, 2);
+	} else {
+		*--end = (char)('0' + value);
+	}
+
+	return end;
+}
+
+static char* write_radix(char* end, uint64_t value, uint32_t shift, bool upper) {
+	const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+	uint64_t mask = (1ull << shift) - 1;
+
+	do {
+		*--end = digits[value & mask];
+		value >>= shift;
+	} while (value);
+
+	return end;
+}
+
+/* prefix (sign, 0x), leading zeros and body, padded to the spec's width. */
+static void put_padded(FormatSink& sink, const FormatSpec& spec, const char* prefix, uint64_t prefixSize, uint64_t zeros, const char* body, uint64_t bodySize, bool allowZeroPad) {
+	uint64_t size = prefixSize + zeros + bodySize;
+	if ((uint64_t)spec.width <= size) {
+		/* The common case, nothing to pad. */
+		if (prefixSize) {
+			sink.Put(prefix, prefixSize);
+		}
+		if (zeros) {
+			sink.Put('0', zeros);
+		}
+		sink.Put(body, bodySize);
+		return;
+	}
+
+	uint64_t padding = spec.width - size;
+	if (spec.leftAlign) {
+		sink.Put(prefix, prefixSize);
+		sink.Put('0', zeros);
+		sink.Put(body, bodySize);
+		sink.Put(' ', padding);
+	} else if (spec.zeroPad && allowZeroPad) {
+		sink.Put(prefix, prefixSize);
+		sink.Put('0', zeros + padding);
+		sink.Put(body, bodySize);
+	} else {
+		sink.Put(' ', padding);
+		sink.Put(prefix, prefixSize);
+		sink.Put('0', zeros);
+		sink.Put(body, bodySize);
+	}
+}
+
+static void put_integer(FormatSink& sink, const FormatSpec& spec, const FormatArg& arg) {
+	bool isSigned = arg.type == FormatArgType::Signed || arg.type == FormatArgType::Char;
+	bool negative = isSigned && arg.i < 0;
+	uint64_t magnitude = negative ? 0 - arg.u : arg.u;
+
+	char buffer[24];
+	char* end = buffer + sizeof(buffer);
+	char* start;
+
+	char prefix[2];
+	uint64_t prefixSize = 0;
+
+	switch (spec.conversion) {
+	case 'x':
+	case 'X':
+	case 'o': {
+		/* Two's complement at the argument's own width, like printf does for its promoted type. */
+		uint64_t bits = arg.u;
+		if (isSigned && arg.size < 8) {
+			bits &= (1ull << (arg.size * 8)) - 1;
+		}
+
+		if (spec.conversion == 'o') {
+			start = write_radix(end, bits, 3, false);
+			if (spec.alternate && *start != '0') {
+				*--start = '0';
+			}
+		} else {
+			start = write_radix(end, bits, 4, spec.conversion == 'X');
+			if (spec.alternate && bits != 0) {
+				prefix[prefixSize++] = '0';
+				prefix[prefixSize++] = spec.conversion;
+			}
+		}
+		break;
+	}
+	default:
+		start = write_decimal(end, magnitude);
+		if (negative) {
+			prefix[prefixSize++] = '-';
+		} else if (spec.positiveSign && isSigned && spec.conversion != 'u') {
+			prefix[prefixSize++] = spec.positiveSign;
+		}
+		break;
+	}
+
+	uint64_t digits = end - start;
+	/* An explicit zero precision prints nothing for zero, except the '0' that %#o always shows. */
+	if (spec.precision == 0 && magnitude == 0 && !(spec.conversion == 'o' && spec.alternate)) {
+		digits = 0;
+	}
+
+	uint64_t zeros = (uint64_t)spec.precision > digits && spec.precision > 0 ? spec.precision - digits : 0;
+	put_padded(sink, spec, prefix, prefixSize, zeros, start, digits, spec.precision < 0);
+}
+
+/* %#g: the %g choice between %e and %f, but without stripping trailing zeros. */
+static std::to_chars_result to_chars_general_alternate(char* first, char* last, double value, int32_t precision) {
+	if (precision == 0) {
+		precision = 1;
+	}
+
+	std::to_chars_result result = std::to_chars(first, last, value, std::chars_format::scientific, precision - 1);
+	if (result.ec != std::errc()) {
+		return result;
+	}
+
+	/* The exponent after 'e' as a sign and at least two digits, the buffer isn't null terminated. */
+	const char* exponent = result.ptr;
+	while (exponent[-1] != 'e') {
+		exponent--;
+	}
+	int32_t exponentValue = 0;
+	std::from_chars(exponent + 1, result.ptr, exponentValue);
+	if (*exponent == '-') {
+		exponentValue = -exponentValue;
+	}
+
+	if (exponentValue >= -4 && exponentValue < precision) {
+		result = std::to_chars(first, last, value, std::chars_format::fixed, precision - 1 - exponentValue);
+	}
+	return result;
+}
+
+/* '#' always shows the decimal point, even with no digits after it. Expects one spare byte past end. */
+static char* insert_decimal_point(char* start, char* end, std::chars_format format) {
+	char exponent = format == std::chars_format::hex ? 'p' : 'e';
+	char* position = start;
+	while (position < end && *position != exponent) {
+		if (*position == '.') {
+			return end;
+		}
+		position++;
+	}
+	memmove(position + 1, position, end - position);
+	*position = '.';
+	return end + 1;
+}
+
+static void put_float(FormatSink& sink, const FormatSpec& spec, double value) {
+	std::chars_format format;
+	char conversion = spec.conversion;
+	switch (conversion) {
+	case 'e': case 'E': format = std::chars_format::scientific; break;
+	case 'g': case 'G': format = std::chars_format::general; break;
+	case 'a': case 'A': format = std::chars_format::hex; break;
+	default: format = std::chars_format::fixed; break;
+	}
+
+	int32_t precision = spec.precision < 0 ? 6 : spec.precision;
+	if (precision > MAX_FLOAT_PRECISION) {
+		precision = MAX_FLOAT_PRECISION;
+	}
+
+	char buffer[FLOAT_BUFFER_SIZE];
+	char* bufferEnd = buffer + sizeof(buffer) - 1; /* Room for the point '#' may add */
+	std::to_chars_result result;
+	if (spec.alternate && format == std::chars_format::general && std::isfinite(value)) {
+		result = to_chars_general_alternate(buffer, bufferEnd, value, precision);
+	} else if (format == std::chars_format::hex && spec.precision < 0) {
+		result = std::to_chars(buffer, bufferEnd, value, format);
+	} else {
+		result = std::to_chars(buffer, bufferEnd, value, format, precision);
+	}
+	assert(result.ec == std::errc() && "Float didn't fit the format buffer");
+
+	char* start = buffer;
+	char* end = result.ptr;
+
+	if (spec.alternate && std::isfinite(value)) {
+		end = insert_decimal_point(start, end, format);
+	}
+
+	if (conversion >= 'A' && conversion <= 'Z') {
+		for (char* character = start; character < end; character++) {
+			if (*character >= 'a' && *character <= 'z') {
+				*character -= 'a' - 'A';
+			}
+		}
+	}
+
+	char prefix[3];
+	uint64_t prefixSize = 0;
+	if (*start == '-') {
+		prefix[prefixSize++] = '-';
+		start++;
+	} else if (spec.positiveSign) {
+		prefix[prefixSize++] = spec.positiveSign;
+	}
+
+	if (format == std::chars_format::hex && std::isfinite(value)) {
+		prefix[prefixSize++] = '0';
+		prefix[prefixSize++] = conversion == 'A' ? 'X' : 'x';
+	}
+
+	put_padded(sink, spec, prefix, prefixSize, 0, start, end - start, std::isfinite(value));
+}
+
+static void put_string(FormatSink& sink, const FormatSpec& spec, const char* data, uint64_t size) {
+	if (spec.precision >= 0 && (uint64_t)spec.precision < size) {
+		size = spec.precision;
+	}
+	put_padded(sink, spec, nullptr, 0, 0, data, size, false);
+}
+
+static void put_pointer(FormatSink& sink, const FormatSpec& spec, const void* pointer) {
+	char buffer[16];
+	char* end = buffer + sizeof(buffer);
+	char* start = write_radix(end, (uint64_t)(uintptr_t)pointer, 4, false);
+	put_padded(sink, spec, "0x", 2, 0, start, end - start, false);
+}
+
+static void put_float_vector(FormatSink& sink, const FormatSpec& spec, const float* floats, uint32_t count) {
+	sink.Put('(');
+	for (uint32_t i = 0; i < count; i++) {
+		if (i > 0) {
+			sink.Put(", ", 2);
+		}
+		put_float(sink, spec, floats[i]);
+	}
+	sink.Put(')');
+}
+
+static bool is_integer_conversion(char conversion) {
+	return conversion == 'd' || conversion == 'i' || conversion == 'u' || conversion == 'x' || conversion == 'X' || conversion == 'o' || conversion == 'c';
+}
+
+static bool is_float_conversion(char conversion) {
+	switch (conversion) {
+	case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+		return true;
+	default:
+		return false;
+	}
+}
+
+static bool is_compatible(char conversion, FormatArgType type) {
+	switch (type) {
+	case FormatArgType::Signed:
+	case FormatArgType::Unsigned:
+	case FormatArgType::Char:
+		return is_integer_conversion(conversion);
+	case FormatArgType::Bool:
+		return is_integer_conversion(conversion) || conversion == 's';
+	case FormatArgType::Double:
+	case FormatArgType::Float2:
+	case FormatArgType::Float3:
+	case FormatArgType::Float4:
+		return is_float_conversion(conversion);
+	case FormatArgType::String:
+		return conversion == 's';
+	case FormatArgType::Pointer:
+		return conversion == 'p';
+	}
+	return false;
+}
+
+static void put_arg(FormatSink& sink, FormatSpec spec, const FormatArg& arg) {
+	assert(is_compatible(spec.conversion, arg.type) && "Format conversion doesn't match the argument's type");
+
+	switch (arg.type) {
+	case FormatArgType::Bool:
+		if (spec.conversion == 's' || !is_integer_conversion(spec.conversion)) {
+			put_string(sink, spec, arg.u ? "true" : "false", arg.u ? 4 : 5);
+			return;
+		}
+		[[fallthrough]];
+	case FormatArgType::Signed:
+	case FormatArgType::Unsigned:
+	case FormatArgType::Char:
+		if (spec.conversion == 'c' || (arg.type == FormatArgType::Char && !is_integer_conversion(spec.conversion))) {
+			char character = (char)arg.i;
+			put_padded(sink, spec, nullptr, 0, 0, &character, 1, false);
+		} else {
+			if (!is_integer_conversion(spec.conversion)) {
+				spec.conversion = 'd';
+			}
+			put_integer(sink, spec, arg);
+		}
+		return;
+	case FormatArgType::Double:
+		if (!is_float_conversion(spec.conversion)) {
+			spec.conversion = 'g';
+		}
+		put_float(sink, spec, arg.d);
+		return;
+	case FormatArgType::String:
+		put_string(sink, spec, arg.string.data, arg.string.size);
+		return;
+	case FormatArgType::Pointer:
+		put_pointer(sink, spec, arg.pointer);
+		return;
+	case FormatArgType::Float2:
+	case FormatArgType::Float3:
+	case FormatArgType::Float4:
+		if (!is_float_conversion(spec.conversion)) {
+			spec.conversion = 'g';
+		}
+		put_float_vector(sink, spec, arg.floats, 2 + (uint32_t)arg.type - (uint32_t)FormatArgType::Float2);
+		return;
+	}
+}
+
+/* Width or precision given as '*', taken from the next argument. */
+static int32_t take_star(const FormatArg* args, uint32_t argCount, uint32_t& argIndex) {
+	if (argIndex >= argCount) {
+		assert(false && "Missing argument for '*' in format");
+		return 0;
+	}
+
+	const FormatArg& arg = args[argIndex++];
+	assert((arg.type == FormatArgType::Signed || arg.type == FormatArgType::Unsigned) && "'*' takes an integer argument");
+	return (int32_t)arg.i;
+}
+
+static int32_t parse_count(const char*& cursor) {
+	int32_t count = 0;
+	while (*cursor >= '0' && *cursor <= '9') {
+		count = count * 10 + (*cursor - '0');
+		cursor++;
+	}
+	return count;
+}
+
+void Formatter::Format(FormatSink& sink, const char* format, const FormatArg* args, uint32_t argCount) {
+	uint32_t argIndex = 0;
+	const char* cursor = format;
+
+	for (;;) {
+		const char* percent = strchr(cursor, '%');
+		if (!percent) {
+			sink.Put(cursor, strlen(cursor));
+			break;
+		}
+
+		sink.Put(cursor, percent - cursor);
+		cursor = percent + 1;
+
+		if (*cursor == '%') {
+			sink.Put('%');
+			cursor++;
+			continue;
+		}
+
+		FormatSpec spec;
+		for (;; cursor++) {
+			if (*cursor == '-') {
+				spec.leftAlign = true;
+			} else if (*cursor == '0') {
+				spec.zeroPad = true;
+			} else if (*cursor == '#') {
+				spec.alternate = true;
+			} else if (*cursor == '+') {
+				spec.positiveSign = '+';
+			} else if (*cursor == ' ') {
+				if (!spec.positiveSign) {
+					spec.positiveSign = ' ';
+				}
+			} else {
+				break;
+			}
+		}
+
+		if (*cursor == '*') {
+			spec.width = take_star(args, argCount, argIndex);
+			if (spec.width < 0) {
+				spec.leftAlign = true;
+				spec.width = -spec.width;
+			}
+			cursor++;
+		} else {
+			spec.width = parse_count(cursor);
+		}
+
+		if (*cursor == '.') {
+			cursor++;
+			if (*cursor == '*') {
+				spec.precision = take_star(args, argCount, argIndex);
+				cursor++;
+			} else {
+				spec.precision = parse_count(cursor);
+			}
+		}
+
+		while (*cursor == 'h' || *cursor == 'l' || *cursor == 'z' || *cursor == 'j' || *cursor == 't' || *cursor == 'L' || *cursor == 'q') {
+			cursor++;
+		}
+
+		spec.conversion = *cursor;
+		if (!spec.conversion) {
+			assert(false && "Format ends in the middle of a conversion");
+			break;
+		}
+		cursor++;
+
+		if (argIndex >= argCount) {
+			assert(false && "Missing argument for format conversion");
+			continue;
+		}
+
+		put_arg(sink, spec, args[argIndex++]);
+	}
+
+	assert(argIndex == argCount && "More arguments than the format uses");
+}
+
+uint64_t Formatter::FormatArgsTo(char* buffer, uint64_t bufferSize, const char* format, const FormatArg* args, uint32_t argCount) {
+	FormatSink sink;
+	sink.buffer = buffer;
+	sink.capacity = bufferSize > 0 ? bufferSize - 1 : 0;
+
+	Format(sink, format, args, argCount);
+
+	if (bufferSize > 0) {
+		buffer[sink.size < sink.capacity ? sink.size : sink.capacity] = 0;
+	}
+
+	return sink.size;
+}
\ No newline at end of file
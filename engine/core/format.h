@@ -0,0 +1,169 @@
+#pragma once
+
+#include "defines.h"
+#include "core/string_view.h"
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+enum class FormatArgType : uint8_t {
+	Signed,
+	Unsigned,
+	Char,
+	Bool,
+	Double,
+	String,
+	Pointer,
+	Float2,
+	Float3,
+	Float4
+};
+
+/* One argument with its type erased. What it holds comes from the type that was passed, never from the format string. */
+struct FormatArg {
+	FormatArgType type;
+	/* Size of integer arguments in bytes, so %x of a negative int32_t prints 8 digits like printf. */
+	uint8_t size;
+	union {
+		int64_t i;
+		uint64_t u;
+		double d;
+		const void* pointer;
+		const float* floats;
+		struct {
+			const char* data;
+			uint64_t size;
+		} string;
+	};
+};
+
+/*
+ * Where formatted text goes. Writes at most capacity characters into buffer but keeps counting past that,
+ * so after formatting size is the exact length of the whole output. With a capacity of 0 it only measures.
+ */
+struct FormatSink {
+	char* buffer = nullptr;
+	uint64_t capacity = 0;
+	uint64_t size = 0;
+
+	/* data may be nullptr when count is 0. */
+	AINLINE void Put(const char* data, uint64_t count) {
+		if (size < capacity && count != 0) {
+			uint64_t left = capacity - size;
+			memcpy(buffer + size, data, count < left ? count : left);
+		}
+		size += count;
+	}
+
+	AINLINE void Put(char character, uint64_t count = 1) {
+		if (size < capacity) {
+			uint64_t left = capacity - size;
+			memset(buffer + size, character, count < left ? count : left);
+		}
+		size += count;
+	}
+};
+
+template<typename T>
+struct format_unsupported : std::false_type {};
+
+/* Picks the representation of value from its type, types that can't be formatted fail to compile. */
+template<typename T>
+AINLINE FormatArg make_format_arg(const T& value) {
+	FormatArg arg{};
+
+	if constexpr (std::is_same_v<T, bool>) {
+		arg.type = FormatArgType::Bool;
+		arg.u = value;
+	} else if constexpr (std::is_same_v<T, char>) {
+		arg.type = FormatArgType::Char;
+		arg.size = sizeof(T);
+		arg.i = value;
+	} else if constexpr (std::is_enum_v<T>) {
+		return make_format_arg((std::underlying_type_t<T>)value);
+	} else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+		arg.type = FormatArgType::Signed;
+		arg.size = sizeof(T);
+		arg.i = value;
+	} else if constexpr (std::is_integral_v<T>) {
+		arg.type = FormatArgType::Unsigned;
+		arg.size = sizeof(T);
+		arg.u = value;
+	} else if constexpr (std::is_floating_point_v<T>) {
+		arg.type = FormatArgType::Double;
+		arg.d = (double)value;
+	} else if constexpr (std::is_convertible_v<const T&, StringView>) {
+		/* const char*, char arrays, String and StringView. */
+		StringView view = value;
+		arg.type = FormatArgType::String;
+		arg.string.data = view.Data();
+		arg.string.size = view.GetSize();
+	} else if constexpr (std::is_same_v<T, DirectX::XMFLOAT2>) {
+		arg.type = FormatArgType::Float2;
+		arg.floats = &value.x;
+	} else if constexpr (std::is_same_v<T, DirectX::XMFLOAT3>) {
+		arg.type = FormatArgType::Float3;
+		arg.floats = &value.x;
+	} else if constexpr (std::is_same_v<T, DirectX::XMFLOAT4>) {
+		arg.type = FormatArgType::Float4;
+		arg.floats = &value.x;
+	} else if constexpr (std::is_same_v<T, DirectX::XMVECTOR>) {
+		arg.type = FormatArgType::Float4;
+		arg.floats = (const float*)&value;
+	} else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) {
+		arg.type = FormatArgType::Pointer;
+		arg.pointer = (const void*)value;
+	} else {
+		static_assert(format_unsupported<T>::value, "This type can't be formatted");
+	}
+
+	return arg;
+}
+
+/* The arguments of one call, converted where the types are still known. */
+template<typename... Args>
+struct FormatArgs {
+	/* One extra slot so calls without arguments don't declare an empty array. */
+	FormatArg list[sizeof...(Args) + 1];
+
+	AINLINE FormatArgs(const Args&... args) : list{ make_format_arg(args)..., FormatArg{} } {}
+
+	static constexpr uint32_t COUNT = sizeof...(Args);
+};
+
+/*
+ * printf compatible formatting: %[flags][width][.precision][length]conversion with the flags "-+ 0#",
+ * '*' for width and precision, and the conversions d i u x X o c s p f F e E g G a A %.
+ * Length modifiers are accepted and ignored since every argument carries its real type.
+ * Besides what printf takes, %s also takes String and StringView, %s of a bool prints true/false and
+ * %f/%e/%g take DirectXMath vectors, printed as "(x, y, z)" with the width and precision applied per component.
+ * Floats are locale independent. A conversion that doesn't fit its argument or a missing or unused argument
+ * asserts, release builds print the argument the way its type would be printed by default.
+ */
+class RAPI Formatter {
+public:
+	static void Format(FormatSink& sink, const char* format, const FormatArg* args, uint32_t argCount);
+
+	/* Length of the output without the terminator. */
+	template<typename... Args>
+	static uint64_t GetSize(const char* format, const Args&... args) {
+		FormatSink sink;
+		FormatArgs<Args...> formatArgs(args...);
+		Format(sink, format, formatArgs.list, FormatArgs<Args...>::COUNT);
+		return sink.size;
+	}
+
+	/*
+	 * Formats into a caller provided buffer, truncating to bufferSize - 1 characters and always terminating it.
+	 * Returns the length the whole output needed, like snprintf.
+	 */
+	template<typename... Args>
+	static uint64_t FormatTo(char* buffer, uint64_t bufferSize, const char* format, const Args&... args) {
+		FormatArgs<Args...> formatArgs(args...);
+		return FormatArgsTo(buffer, bufferSize, format, formatArgs.list, FormatArgs<Args...>::COUNT);
+	}
+
+	static uint64_t FormatArgsTo(char* buffer, uint64_t bufferSize, const char* format, const FormatArg* args, uint32_t argCount);
+};
\ No newline at end of file
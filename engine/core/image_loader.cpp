@@ -94,7 +94,9 @@ ImageLoader::~ImageLoader() {
 Image* ImageLoader::LoadTga(const String& path) const {
 	static_assert(sizeof(TGA::TGAHeader) == 18, "size of TGAHeader is not 18 bytes, you're compiler is probably aligning it.");
 
-	String fileExtension = path.GetFileExtension();
+	if (!path.GetFileExtension().EqualsI(".tga")) {
+		LOG_WARNING("ImageLoader::LoadTga: %s doesn't have a .tga extension", path.CStr());
+	}
 
 	binary_info imageBinary = Platform::OpenBinary(path.CStr());
 
@@ -157,7 +159,7 @@ Image* ImageLoader::LoadTga(const String& path) const {
 			break;
 		}
 		default: {
-			Logger::Debug("Invalid TGA Format");
+			LOG_DEBUG("Invalid TGA Format");
 			return nullptr;
 		}
 	}
@@ -170,8 +172,6 @@ Image* ImageLoader::LoadTga(const String& path) const {
 
 	Platform::CloseBinary(&imageBinary);
 
-	Logger::Debug("");
-
 	return image;
 }
 
@@ -201,7 +201,8 @@ TGAImageType FindImageType(TGAHeader* header) {
 
 void DecodeUncompressedTrueColor(TGAHeader* header, uint64_t imageDataOffset, BGRA** outPixels) {
 	uint64_t outPixelsSize = header->width * header->height * 4;
-	*outPixels = (BGRA*)Platform::UAlloc(outPixelsSize);
+	// Every pixel is written below, so the buffer doesn't need to be cleared first.
+	*outPixels = (BGRA*)Platform::UAllocUninitialized(outPixelsSize, MemoryTag::Asset);
 	
 	if (header->bitsPerPixel == 32) {
 		ARGB* sourcePixelArray = (ARGB*)INC_POINTER(header, imageDataOffset);
@@ -227,28 +228,28 @@ void DecodeUncompressedTrueColor(TGAHeader* header, uint64_t imageDataOffset, BG
 		uint64_t iDest = 0;
 		for (uint64_t i = header->width * header->height; i > 0; i--) {
 			unsigned char* sPixel = (unsigned char*)&sourcePixelArray[iDest++];
-			BGRA& dPixel = (*outPixels)[i];
+			BGRA& dPixel = (*outPixels)[i - 1];
 
 			dPixel.a = 255;
 			dPixel.r = sPixel[2];
 			dPixel.g = sPixel[1];
 			dPixel.b = sPixel[0];
 
-			(*outPixels)[i].a = 255;
-			(*outPixels)[i].r = sPixel[2];
-			(*outPixels)[i].g = sPixel[1];
-			(*outPixels)[i].b = sPixel[0];
+			(*outPixels)[i - 1].a = 255;
+			(*outPixels)[i - 1].r = sPixel[2];
+			(*outPixels)[i - 1].g = sPixel[1];
+			(*outPixels)[i - 1].b = sPixel[0];
 		}
 	} else if (header->bitsPerPixel == 16) {
 		uint16_t* sourcePixelArray = (uint16_t*)INC_POINTER(header, imageDataOffset);
 		for (uint64_t i = header->width * header->height; i > 0; i--) {
-			unsigned char* sPixel = (unsigned char*)&sourcePixelArray[i];
-			BGRA& dPixel = (*outPixels)[i];
+			unsigned char* sPixel = (unsigned char*)&sourcePixelArray[i - 1];
+			BGRA& dPixel = (*outPixels)[i - 1];
 
-			(*outPixels)[i].a = (sPixel[1] & 0x80);
-			(*outPixels)[i].r = (sPixel[1] & 0x7c) << 1;
-			(*outPixels)[i].g = ((sPixel[1] & 0x03) << 6) | ((sPixel[0] & 0xe0) >> 2);
-			(*outPixels)[i].b = (sPixel[0] & 0x1f) << 3;
+			(*outPixels)[i - 1].a = (sPixel[1] & 0x80);
+			(*outPixels)[i - 1].r = (sPixel[1] & 0x7c) << 1;
+			(*outPixels)[i - 1].g = ((sPixel[1] & 0x03) << 6) | ((sPixel[0] & 0xe0) >> 2);
+			(*outPixels)[i - 1].b = (sPixel[0] & 0x1f) << 3;
 		}
 	}
 }
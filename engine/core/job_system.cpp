@@ -0,0 +1,530 @@
+#include "job_system.h"
+
+#include "containers/mpmc_queue.h"
+#include "core/fiber.h"
+#include "core/logger.h"
+#include "platform/platform.h"
+
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define cpu_relax() _mm_pause()
+#else
+#define cpu_relax()
+#endif
+
+static constexpr uint32_t MAX_WORKERS = 64;
+/* Jobs handed over by threads that aren't workers. */
+static constexpr uint32_t INJECTED_JOB_CAPACITY = 4096;
+/* Rounds of looking for work before an idle worker goes to sleep. */
+static constexpr uint32_t IDLE_SPIN_COUNT = 64;
+
+/*
+ * Fixed size Chase-Lev deque, after Lê, Pop, Cohen and Zappa Nardelli's C11 version, using sequentially consistent
+ * operations where the paper uses fences. Only the owner pushes and pops, at the bottom. Any thread steals from the top.
+ * Slots are read before the CAS that claims them, so their fields are atomics: a thief may read a slot the owner is
+ * rewriting, but then its CAS fails and the value is thrown away.
+ */
+class JobDeque {
+	struct Slot {
+		std::atomic<void (*)(void*)> function;
+		std::atomic<void*> data;
+		std::atomic<JobCounter*> counter;
+	};
+
+public:
+	void Initialize(uint32_t capacity) {
+		assert(capacity >= 2 && (capacity & (capacity - 1)) == 0 && "Job deque capacity must be a power of two");
+
+		m_Slots = (Slot*)Platform::AAllocUninitialized(CACHE_LINE_SIZE, sizeof(Slot) * capacity, MemoryTag::Core);
+		for (uint32_t i = 0; i < capacity; i++) {
+			new (&m_Slots[i]) Slot();
+		}
+		m_Mask = capacity - 1;
+	}
+
+	void Release() {
+		Platform::AFree(m_Slots);
+		m_Slots = nullptr;
+	}
+
+	/* Owner only. False when full. */
+	bool Push(const Job& job) {
+		int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+		int64_t top = m_Top.load(std::memory_order_acquire);
+		if (bottom - top > (int64_t)m_Mask) {
+			return false;
+		}
+
+		Store(m_Slots[bottom & m_Mask], job);
+		m_Bottom.store(bottom + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	/* Owner only, takes the newest job. */
+	bool Pop(Job& job) {
+		int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+		m_Bottom.store(bottom, std::memory_order_seq_cst);
+		int64_t top = m_Top.load(std::memory_order_seq_cst);
+
+		if (top > bottom) {
+			m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		Load(m_Slots[bottom & m_Mask], job);
+		if (top != bottom) {
+			return true;
+		}
+
+		// The last job, thieves may be after it as well.
+		bool won = m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+
+		return won;
+	}
+
+	/* Any thread, takes the oldest job. */
+	bool Steal(Job& job) {
+		int64_t top = m_Top.load(std::memory_order_seq_cst);
+		int64_t bottom = m_Bottom.load(std::memory_order_seq_cst);
+		if (top >= bottom) {
+			return false;
+		}
+
+		Load(m_Slots[top & m_Mask], job);
+		return m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+
+private:
+	static AINLINE void Store(Slot& slot, const Job& job) {
+		slot.function.store(job.function, std::memory_order_relaxed);
+		slot.data.store(job.data, std::memory_order_relaxed);
+		slot.counter.store(job.counter, std::memory_order_relaxed);
+	}
+
+	static AINLINE void Load(const Slot& slot, Job& job) {
+		job.function = slot.function.load(std::memory_order_relaxed);
+		job.data = slot.data.load(std::memory_order_relaxed);
+		job.counter = slot.counter.load(std::memory_order_relaxed);
+	}
+
+private:
+	alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_Top{ 0 };
+	alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_Bottom{ 0 };
+	Slot* m_Slots = nullptr;
+	uint64_t m_Mask = 0;
+};
+
+enum class FiberState : uint8_t {
+	Running,
+	Finished,
+	/* Waiting on waitCounter, the scheduler it switched back to parks it. */
+	Parking
+};
+
+struct JobFiber {
+	FiberContext context;
+	FiberStack stack;
+	Job job;
+	JobCounter* waitCounter;
+	FiberState state;
+};
+
+struct alignas(CACHE_LINE_SIZE) JobWorker {
+	JobDeque deque;
+	std::thread thread;
+};
+
+struct JobSystemState {
+	bool initialized = false;
+	uint32_t workerCount = 1;
+	JobWorker* workers = nullptr;
+	alignas(mpmc_queue<Job>) unsigned char injectedStorage[sizeof(mpmc_queue<Job>)];
+	mpmc_queue<Job>* injected = nullptr;
+
+	/* Jobs queued and not taken yet, idle workers sleep while there are none. Briefly negative when a job is taken before it's counted. */
+	alignas(CACHE_LINE_SIZE) std::atomic<int32_t> queuedJobs{ 0 };
+	std::atomic<uint32_t> sleepingWorkers{ 0 };
+	std::atomic<bool> running{ false };
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+
+	bool useFibers = false;
+	uint32_t fiberCount = 0;
+	JobFiber* fibers = nullptr;
+	alignas(mpmc_queue<JobFiber*>) unsigned char freeFiberStorage[sizeof(mpmc_queue<JobFiber*>)];
+	mpmc_queue<JobFiber*>* freeFibers = nullptr;
+	/* Parked fibers, resumed by whichever scheduler first sees their counter done. */
+	std::mutex parkedMutex;
+	list<JobFiber*> parkedFibers;
+	std::atomic<uint32_t> parkedCount{ 0 };
+};
+
+static JobSystemState s_Jobs;
+static thread_local uint32_t s_WorkerIndex = INVALID_ID;
+static thread_local uint32_t s_StealSeed = 0;
+/* Where the thread's own stack was suspended when it switched to a fiber. */
+static thread_local FiberContext s_ThreadContext;
+static thread_local JobFiber* s_CurrentFiber = nullptr;
+
+/*
+ * A fiber may be resumed on another thread, and compilers are free to keep the address of a thread_local
+ * across a function call. Code that runs on fibers gets at these through calls that can't be inlined instead.
+ */
+static NOINLINE FiberContext& get_thread_context() {
+	return s_ThreadContext;
+}
+
+static NOINLINE JobFiber* get_current_fiber() {
+	return s_CurrentFiber;
+}
+
+static void execute_job(const Job& job) {
+	job.function(job.data);
+
+	if (job.counter) {
+		job.counter->Finish();
+	}
+}
+
+static bool take_job(uint32_t workerIndex, Job& job) {
+	bool taken = (workerIndex != INVALID_ID && s_Jobs.workers[workerIndex].deque.Pop(job)) || s_Jobs.injected->try_pop(job);
+
+	if (!taken && s_Jobs.workerCount > 1) {
+		// xorshift, so thieves don't all go for the same victim.
+		uint32_t seed = s_StealSeed ? s_StealSeed : (workerIndex * 0x9e3779b9u) | 1;
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		s_StealSeed = seed;
+
+		for (uint32_t i = 0; i < s_Jobs.workerCount && !taken; i++) {
+			uint32_t victim = (seed + i) % s_Jobs.workerCount;
+			taken = victim != workerIndex && s_Jobs.workers[victim].deque.Steal(job);
+		}
+	}
+
+	if (taken) {
+		s_Jobs.queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	return taken;
+}
+
+static void fiber_main(void* argument) {
+	JobFiber* fiber = (JobFiber*)argument;
+
+	// Fibers are reused, every switch back here starts the next job.
+	while (true) {
+		execute_job(fiber->job);
+		fiber->state = FiberState::Finished;
+		fiber_switch(fiber->context, get_thread_context());
+	}
+}
+
+static JobFiber* take_ready_fiber() {
+	if (s_Jobs.parkedCount.load(std::memory_order_acquire) == 0) {
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(s_Jobs.parkedMutex);
+	for (size_t i = 0; i < s_Jobs.parkedFibers.size(); i++) {
+		JobFiber* fiber = s_Jobs.parkedFibers[i];
+		if (fiber->waitCounter->IsDone()) {
+			s_Jobs.parkedFibers.remove_at(i);
+			s_Jobs.parkedCount.fetch_sub(1, std::memory_order_relaxed);
+			return fiber;
+		}
+	}
+
+	return nullptr;
+}
+
+/* Only from a thread's own stack, never from a fiber. Returns once the fiber finished its job or parked. */
+static void run_fiber(JobFiber* fiber) {
+	fiber->state = FiberState::Running;
+	s_CurrentFiber = fiber;
+	fiber_switch(s_ThreadContext, fiber->context);
+	s_CurrentFiber = nullptr;
+
+	if (fiber->state == FiberState::Finished) {
+		s_Jobs.freeFibers->try_push(fiber);
+	} else {
+		// Parked only now that it's off its stack, so no other thread can resume it while it's still running here.
+		std::lock_guard<std::mutex> lock(s_Jobs.parkedMutex);
+		s_Jobs.parkedFibers.push_back(fiber);
+		s_Jobs.parkedCount.fetch_add(1, std::memory_order_release);
+	}
+}
+
+/* Resumes a parked job that can go on, or starts a new one. False when there's nothing to do. */
+static bool run_next(uint32_t workerIndex) {
+	if (s_Jobs.useFibers) {
+		if (JobFiber* fiber = take_ready_fiber()) {
+			run_fiber(fiber);
+			return true;
+		}
+	}
+
+	Job job;
+	if (!take_job(workerIndex, job)) {
+		return false;
+	}
+
+	JobFiber* fiber;
+	if (s_Jobs.useFibers && s_Jobs.freeFibers->try_pop(fiber)) {
+		fiber->job = job;
+		run_fiber(fiber);
+	} else {
+		// Every fiber is taken, this job blocks its worker if it waits.
+		execute_job(job);
+	}
+
+	return true;
+}
+
+static bool create_fibers(uint32_t fiberCount, uint32_t stackSize) {
+	uint32_t queueCapacity = 2;
+	while (queueCapacity < fiberCount) {
+		queueCapacity *= 2;
+	}
+
+	s_Jobs.fibers = (JobFiber*)Platform::UAllocZeroed(sizeof(JobFiber) * fiberCount, MemoryTag::Core);
+	s_Jobs.freeFibers = new (s_Jobs.freeFiberStorage) mpmc_queue<JobFiber*>(queueCapacity);
+	s_Jobs.parkedFibers.reserve(fiberCount);
+
+	for (uint32_t i = 0; i < fiberCount; i++) {
+		JobFiber* fiber = new (&s_Jobs.fibers[i]) JobFiber();
+		if (!fiber_create_stack(fiber->stack, stackSize)) {
+			LOG_WARNING("JobSystem: only %u of %u fiber stacks could be created", i, fiberCount);
+			break;
+		}
+
+		fiber_make_context(fiber->context, fiber->stack, fiber_main, fiber);
+		s_Jobs.freeFibers->try_push(fiber);
+		s_Jobs.fiberCount++;
+	}
+
+	return s_Jobs.fiberCount != 0;
+}
+
+static void destroy_fibers() {
+	assert(s_Jobs.parkedCount.load(std::memory_order_relaxed) == 0 && "Jobs were still waiting when the job system shut down");
+
+	for (uint32_t i = 0; i < s_Jobs.fiberCount; i++) {
+		fiber_release_context(s_Jobs.fibers[i].context);
+		fiber_destroy_stack(s_Jobs.fibers[i].stack);
+	}
+
+	Platform::UFree(s_Jobs.fibers);
+	s_Jobs.freeFibers->~mpmc_queue<JobFiber*>();
+	s_Jobs.parkedFibers = list<JobFiber*>();
+
+	s_Jobs.fibers = nullptr;
+	s_Jobs.freeFibers = nullptr;
+	s_Jobs.fiberCount = 0;
+	s_Jobs.useFibers = false;
+}
+
+static void wake_workers(uint32_t count) {
+	if (s_Jobs.sleepingWorkers.load(std::memory_order_seq_cst) == 0) {
+		return;
+	}
+
+	// Under the lock, so a worker between checking queuedJobs and waiting can't miss it.
+	std::lock_guard<std::mutex> lock(s_Jobs.sleepMutex);
+	if (count == 1) {
+		s_Jobs.wake.notify_one();
+	} else {
+		s_Jobs.wake.notify_all();
+	}
+}
+
+static void worker_main(uint32_t workerIndex) {
+	s_WorkerIndex = workerIndex;
+
+	uint32_t idleSpins = 0;
+	while (true) {
+		if (run_next(workerIndex)) {
+			idleSpins = 0;
+			continue;
+		}
+
+		// Only leaves once there's nothing left to take or resume.
+		if (!s_Jobs.running.load(std::memory_order_acquire) && s_Jobs.parkedCount.load(std::memory_order_acquire) == 0) {
+			break;
+		}
+
+		if (++idleSpins < IDLE_SPIN_COUNT) {
+			cpu_relax();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(s_Jobs.sleepMutex);
+		s_Jobs.sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+		while (s_Jobs.queuedJobs.load(std::memory_order_seq_cst) <= 0 && s_Jobs.running.load(std::memory_order_relaxed)) {
+			// Counters of parked jobs can be finished from outside the job system without waking anyone, so look again soon.
+			if (s_Jobs.parkedCount.load(std::memory_order_relaxed) != 0) {
+				s_Jobs.wake.wait_for(lock, std::chrono::milliseconds(1));
+				break;
+			}
+			s_Jobs.wake.wait(lock);
+		}
+		s_Jobs.sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+		idleSpins = 0;
+	}
+
+	s_WorkerIndex = INVALID_ID;
+}
+
+void JobSystem::Initialize(const JobSystemConfig& config) {
+	if (s_Jobs.initialized) {
+		LOG_WARNING("JobSystem::Initialize called more than once");
+		return;
+	}
+
+	uint32_t workerCount = config.workerCount;
+	if (workerCount == 0) {
+		uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+	if (workerCount + 1 > MAX_WORKERS) {
+		workerCount = MAX_WORKERS - 1;
+	}
+
+	s_Jobs.workerCount = workerCount + 1;
+	s_Jobs.workers = (JobWorker*)Platform::AAllocUninitialized(alignof(JobWorker), sizeof(JobWorker) * s_Jobs.workerCount, MemoryTag::Core);
+	for (uint32_t i = 0; i < s_Jobs.workerCount; i++) {
+		new (&s_Jobs.workers[i]) JobWorker();
+		s_Jobs.workers[i].deque.Initialize(config.dequeCapacity);
+	}
+	s_Jobs.injected = new (s_Jobs.injectedStorage) mpmc_queue<Job>(INJECTED_JOB_CAPACITY);
+
+	if (config.useFibers) {
+		if (!FIBERS_SUPPORTED) {
+			LOG_WARNING("JobSystem: fibers aren't supported on this platform, jobs run on the workers' stacks");
+		} else if (create_fibers(config.fiberCount, config.fiberStackSize)) {
+			s_Jobs.useFibers = true;
+		} else {
+			destroy_fibers();
+		}
+	}
+
+	s_Jobs.running.store(true, std::memory_order_release);
+	s_Jobs.initialized = true;
+	s_WorkerIndex = 0;
+
+	for (uint32_t i = 1; i < s_Jobs.workerCount; i++) {
+		s_Jobs.workers[i].thread = std::thread(worker_main, i);
+	}
+
+	LOG_INFO("Job system started with %u workers and %u fibers", s_Jobs.workerCount, s_Jobs.fiberCount);
+}
+
+void JobSystem::Shutdown() {
+	if (!s_Jobs.initialized) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(s_Jobs.sleepMutex);
+		s_Jobs.running.store(false, std::memory_order_release);
+		s_Jobs.wake.notify_all();
+	}
+
+	for (uint32_t i = 1; i < s_Jobs.workerCount; i++) {
+		s_Jobs.workers[i].thread.join();
+	}
+
+	// Whatever the workers left behind.
+	while (run_next(0)) {}
+
+	if (s_Jobs.fibers) {
+		destroy_fibers();
+	}
+
+	for (uint32_t i = 0; i < s_Jobs.workerCount; i++) {
+		s_Jobs.workers[i].deque.Release();
+		s_Jobs.workers[i].~JobWorker();
+	}
+	Platform::AFree(s_Jobs.workers);
+	s_Jobs.injected->~mpmc_queue<Job>();
+
+	s_Jobs.workers = nullptr;
+	s_Jobs.injected = nullptr;
+	s_Jobs.workerCount = 1;
+	s_Jobs.initialized = false;
+	s_WorkerIndex = INVALID_ID;
+}
+
+uint32_t JobSystem::GetWorkerCount() {
+	return s_Jobs.workerCount;
+}
+
+uint32_t JobSystem::GetWorkerIndex() {
+	return s_WorkerIndex;
+}
+
+void JobSystem::Run(const Job& job) {
+	Run(&job, 1);
+}
+
+void JobSystem::Run(const Job* jobs, uint32_t count) {
+	uint32_t queued = 0;
+
+	for (uint32_t i = 0; i < count; i++) {
+		const Job& job = jobs[i];
+		if (job.counter) {
+			job.counter->Add();
+		}
+
+		if (!s_Jobs.initialized) {
+			execute_job(job);
+			continue;
+		}
+
+		uint32_t workerIndex = s_WorkerIndex;
+		bool pushed = workerIndex != INVALID_ID ? s_Jobs.workers[workerIndex].deque.Push(job) : s_Jobs.injected->try_push(job);
+
+		if (pushed) {
+			queued++;
+		} else {
+			// No room left, running it here also slows down whoever keeps adding jobs.
+			execute_job(job);
+		}
+	}
+
+	if (queued != 0) {
+		s_Jobs.queuedJobs.fetch_add((int32_t)queued, std::memory_order_seq_cst);
+		wake_workers(queued);
+	}
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+	if (counter.IsDone()) {
+		return;
+	}
+
+	// On a fiber: hand the thread back to its scheduler, which parks this job until counter is done.
+	if (JobFiber* fiber = get_current_fiber()) {
+		fiber->waitCounter = &counter;
+		fiber->state = FiberState::Parking;
+		fiber_switch(fiber->context, get_thread_context());
+		return;
+	}
+
+	uint32_t workerIndex = s_WorkerIndex;
+	while (!counter.IsDone()) {
+		if (!s_Jobs.initialized || !run_next(workerIndex)) {
+			cpu_relax();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "defines.h"
+#include "containers/list.h"
+
+#include <atomic>
+#include <cstdint>
+
+/*
+ * Number of jobs still to finish. Every job run with a counter adds one to it and takes it back off once it's done,
+ * so jobs that depend on others wait on their counter.
+ */
+class RAPI JobCounter {
+public:
+	JobCounter() = default;
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	AINLINE bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+	AINLINE uint32_t GetPending() const { return m_Pending.load(std::memory_order_relaxed); }
+
+	/* Run does both for its jobs, these are for work tracked some other way, like a file read finishing. */
+	AINLINE void Add(uint32_t count = 1) { m_Pending.fetch_add(count, std::memory_order_relaxed); }
+	AINLINE void Finish() { m_Pending.fetch_sub(1, std::memory_order_acq_rel); }
+
+private:
+	std::atomic<uint32_t> m_Pending{ 0 };
+};
+
+struct Job {
+	void (*function)(void* data);
+	void* data;
+	/* Optional, decremented once function returns. */
+	JobCounter* counter;
+};
+
+struct JobSystemConfig {
+	/* Threads started besides the one calling Initialize, which works too. 0 means one per hardware thread. */
+	uint32_t workerCount = 0;
+	/* Jobs each worker's deque holds, a power of two. A worker runs jobs it can't queue right away. */
+	uint32_t dequeCapacity = 4096;
+	/*
+	 * Runs jobs on a pool of fibers, so a job waiting on a counter is parked and its worker goes on with other jobs
+	 * instead of being blocked. Only where FIBERS_SUPPORTED is set, elsewhere jobs run on the workers' own stacks.
+	 * A parked job may resume on another thread: it must not hold locks or references to thread_local data across Wait.
+	 */
+	bool useFibers = false;
+	/* Jobs started but not finished at the same time. Once all are in use, new jobs run on the worker's own stack. */
+	uint32_t fiberCount = 128;
+	/* Per fiber, rounded up to whole pages. */
+	uint32_t fiberStackSize = 64 * 1024;
+};
+
+/*
+ * Work stealing job system. Every worker, the thread that called Initialize included, owns a Chase-Lev deque:
+ * it pushes and pops its own jobs at the bottom without contention, idle workers steal from the top of the others'.
+ * Other threads hand their jobs to the workers through a shared queue. Workers with nothing to do sleep.
+ * Waiting on a counter runs other jobs in the meantime instead of blocking, so jobs can wait on jobs they started.
+ * With fibers, waiting jobs are set aside entirely, so long chains of jobs waiting on each other can be written
+ * as plain sequential code. Without Initialize, jobs run right away on the calling thread.
+ */
+class RAPI JobSystem {
+public:
+	static void Initialize(const JobSystemConfig& config = JobSystemConfig());
+	/* Waits for every worker to run out of jobs, then joins them. */
+	static void Shutdown();
+
+	/* Workers including the main thread, 1 when not initialized. */
+	static uint32_t GetWorkerCount();
+	/* Index of the calling worker, the main thread is 0. INVALID_ID on threads that aren't workers. */
+	static uint32_t GetWorkerIndex();
+
+	static void Run(const Job& job);
+	static void Run(const Job* jobs, uint32_t count);
+
+	/* Runs other jobs until counter reaches zero. Inside a job running on a fiber, parks the job until then instead. */
+	static void Wait(JobCounter& counter);
+
+	/*
+	 * Calls function(begin, end) on every batch of at most batchSize indices in [0, count), spread over all workers,
+	 * the calling thread included. Returns once every batch is done.
+	 */
+	template<typename Function>
+	static void ParallelFor(uint32_t count, uint32_t batchSize, Function&& function) {
+		if (count == 0) {
+			return;
+		}
+		if (batchSize == 0) {
+			batchSize = 1;
+		}
+
+		ParallelForData<Function> data(count, batchSize, function);
+
+		uint32_t batchCount = (count + batchSize - 1) / batchSize;
+		uint32_t helperCount = (batchCount < GetWorkerCount() ? batchCount : GetWorkerCount()) - 1;
+
+		JobCounter counter;
+		for (uint32_t i = 0; i < helperCount; i++) {
+			Run({ &ParallelForData<Function>::RunBatches, &data, &counter });
+		}
+
+		ParallelForData<Function>::RunBatches(&data);
+		Wait(counter);
+	}
+
+	/* Calls function(T&) on every element of items, batchSize elements per batch. */
+	template<typename T, typename Function>
+	static void ParallelFor(list<T>& items, uint32_t batchSize, Function&& function) {
+		T* elements = items.data();
+		ParallelFor(items.size_u32(), batchSize, [elements, &function](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; i++) {
+				function(elements[i]);
+			}
+		});
+	}
+
+private:
+	/* Helpers don't get a batch each, they take batches until none are left, so a slow batch doesn't hold up the rest. */
+	template<typename Function>
+	struct ParallelForData {
+		ParallelForData(uint32_t count, uint32_t batchSize, Function& function) : count(count), batchSize(batchSize), function(function) {}
+
+		static void RunBatches(void* pData) {
+			ParallelForData& data = *(ParallelForData*)pData;
+
+			uint32_t begin;
+			while ((begin = data.next.fetch_add(data.batchSize, std::memory_order_relaxed)) < data.count) {
+				uint32_t end = data.count - begin > data.batchSize ? begin + data.batchSize : data.count;
+				data.function(begin, end);
+			}
+		}
+
+		const uint32_t count;
+		const uint32_t batchSize;
+		Function& function;
+		std::atomic<uint32_t> next{ 0 };
+	};
+};
\ No newline at end of file
@@ -1,45 +1,471 @@
 #include "logger.h"
 
+#include "core/binary_log.h"
 #include "platform/platform.h"
 
-#include <cstdarg>
-#include <stdio.h>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
 
-#define internal_logger(level, format)                                                                      \
-    va_list va;                                                                                             \
-    va_start(va, format);                                                                                   \
-    char out_arg_message[10000];                                                                            \
-    vsprintf(out_arg_message, format, va);                                                                  \
-    va_end(va);                                                                                             \
-\
-    static constexpr const char* level_strings[] = { "[FATAL]: ", "[WARN]: ", "[DEBUG]: ", "[INFO]: " };   \
-\
-    char output_message[11000];                                                                             \
-    snprintf(output_message, sizeof(output_message) - 1, "%s%s", level_strings[level], out_arg_message);  \
-\
-    Platform::Log(level, output_message);                                                                   \
+/* Most synchronous messages fit here, longer ones are measured by the first attempt and formatted again into an exact buffer. */
+static constexpr uint64_t LOG_STACK_BUFFER_SIZE = 1024;
+/* Threads past this many log synchronously. */
+static constexpr uint32_t MAX_LOG_THREADS = 64;
+/* Lines handed to the console and the file per call. */
+static constexpr uint32_t LOG_BATCH_SIZE = 64;
+/* Record size that marks the rest of the ring as unused, the next record starts at the beginning. */
+static constexpr uint32_t LOG_WRAP_RECORD = ~0u;
+static constexpr uint64_t LOG_RECORD_ALIGNMENT = 8;
 
-// TODO: Save logs to file.
-void Logger::InitializeLogging() {
-    
+struct LogRecordHeader {
+    int64_t time;
+    uint32_t size;
+    log_level level;
+};
+
+static_assert(sizeof(LogRecordHeader) % LOG_RECORD_ALIGNMENT == 0, "Records must keep the ring aligned");
+
+enum class LogRingState : uint8_t {
+    Free,
+    Owned,
+    /* The owning thread exited, freed once the writer drained it. */
+    Orphaned
+};
+
+/*
+ * Single producer, single consumer byte ring. head and tail only grow, the offset into data is position & (size - 1).
+ * The owning thread formats records at head, the writer thread reads them up to head and moves tail once they're written.
+ */
+struct LogRing {
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head{ 0 };
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail{ 0 };
+    alignas(CACHE_LINE_SIZE) std::atomic<LogRingState> state{ LogRingState::Free };
+    std::atomic<char*> data{ nullptr };
+};
+
+struct LoggerState {
+    ~LoggerState() {
+        Logger::ShutdownLogging();
+    }
+
+    LoggerConfig config;
+    std::atomic<bool> running{ false };
+    /* Bumped by every InitializeLogging so rings claimed before a shutdown aren't used after it. */
+    std::atomic<uint32_t> generation{ 0 };
+    LogRing rings[MAX_LOG_THREADS];
+    /* threadBufferSize of the first InitializeLogging. Ring memory is never freed, a thread may still be writing to it. */
+    uint64_t ringSize = 0;
+
+    std::thread writer;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stop = false;
+
+    /* Held by whoever is draining the rings, the writer thread or a Flush. */
+    std::mutex drainMutex;
+    HANDLE file = nullptr;
+    uint64_t fileSize = 0;
+};
+
+static LoggerState s_Logger;
+
+struct ThreadLogRing {
+    ~ThreadLogRing() {
+        if (ring && generation == s_Logger.generation.load(std::memory_order_relaxed)) {
+            ring->state.store(LogRingState::Orphaned, std::memory_order_release);
+        }
+    }
+
+    LogRing* ring = nullptr;
+    uint32_t generation = 0;
+};
+
+static AINLINE uint64_t align_record(uint64_t size) {
+    return (size + LOG_RECORD_ALIGNMENT - 1) & ~(LOG_RECORD_ALIGNMENT - 1);
 }
 
-void Logger::ShutdownLogging() {
+static void format_message(FormatSink& sink, log_level level, const char* format, const FormatArg* args, uint32_t argCount) {
+    static constexpr const char* level_strings[] = { "[FATAL]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]: " };
 
+    sink.Put(level_strings[level], strlen(level_strings[level]));
+    Formatter::Format(sink, format, args, argCount);
 }
 
-void Logger::Fatal(const char* format, ...) {
-    internal_logger(log_level::fatal, format);
+static void wake_writer() {
+    s_Logger.wake.notify_one();
 }
 
-void Logger::Warning(const char* format, ...) {
-    internal_logger(log_level::warning, format);
+static LogRing* acquire_thread_ring() {
+    static thread_local ThreadLogRing threadRing;
+
+    uint32_t generation = s_Logger.generation.load(std::memory_order_relaxed);
+    if (threadRing.ring && threadRing.generation == generation) {
+        return threadRing.ring;
+    }
+
+    for (LogRing& ring : s_Logger.rings) {
+        LogRingState expected = LogRingState::Free;
+        if (ring.state.load(std::memory_order_relaxed) != LogRingState::Free ||
+            !ring.state.compare_exchange_strong(expected, LogRingState::Owned, std::memory_order_acquire)) {
+            continue;
+        }
+
+        // Rings keep their memory when a thread exits, the next thread to claim it reuses it.
+        if (!ring.data.load(std::memory_order_relaxed)) {
+            char* data = (char*)Platform::VAlloc(s_Logger.ringSize);
+            if (!data) {
+                ring.state.store(LogRingState::Free, std::memory_order_release);
+                return nullptr;
+            }
+            ring.data.store(data, std::memory_order_release);
+        }
+
+        threadRing.ring = &ring;
+        threadRing.generation = generation;
+        return &ring;
+    }
+
+    return nullptr;
 }
 
-void Logger::Debug(const char* format, ...) {
-    internal_logger(log_level::debug, format);
+/* Formats the message into the ring, false if it can't ever fit or the logger stopped while waiting for room. */
+static bool push_record(LogRing& ring, log_level level, const char* format, const FormatArg* args, uint32_t argCount) {
+    uint64_t capacity = s_Logger.ringSize;
+    char* data = ring.data.load(std::memory_order_relaxed);
+    int64_t time = Platform::GetTime();
+
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    uint64_t used = head - ring.tail.load(std::memory_order_acquire);
+    uint64_t offset = head & (capacity - 1);
+    uint64_t toEnd = capacity - offset;
+    uint64_t contiguous = capacity - used < toEnd ? capacity - used : toEnd;
+
+    FormatSink sink;
+    if (contiguous > sizeof(LogRecordHeader)) {
+        sink.buffer = data + offset + sizeof(LogRecordHeader);
+        sink.capacity = contiguous - sizeof(LogRecordHeader);
+    }
+    format_message(sink, level, format, args, argCount);
+
+    uint64_t recordSize = align_record(sizeof(LogRecordHeader) + sink.size);
+    if (recordSize > contiguous) {
+        // It was only measured, make room for it and format it again.
+        if (recordSize > capacity / 2) {
+            return false;
+        }
+
+        uint64_t required = recordSize > toEnd ? toEnd + recordSize : recordSize;
+        while (capacity - (head - ring.tail.load(std::memory_order_acquire)) < required) {
+            if (!s_Logger.running.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            wake_writer();
+            std::this_thread::yield();
+        }
+
+        if (recordSize > toEnd) {
+            // Less than a header left means the reader wraps without a marker.
+            if (toEnd >= sizeof(LogRecordHeader)) {
+                ((LogRecordHeader*)(data + offset))->size = LOG_WRAP_RECORD;
+            }
+            head += toEnd;
+            offset = 0;
+        }
+
+        sink.buffer = data + offset + sizeof(LogRecordHeader);
+        sink.capacity = recordSize - sizeof(LogRecordHeader);
+        sink.size = 0;
+        format_message(sink, level, format, args, argCount);
+    }
+
+    LogRecordHeader* header = (LogRecordHeader*)(data + offset);
+    header->time = time;
+    header->size = (uint32_t)sink.size;
+    header->level = level;
+
+    head += recordSize;
+    ring.head.store(head, std::memory_order_release);
+
+    // Only wake the writer early when the ring is filling up, otherwise it picks records up on its own.
+    if (head - ring.tail.load(std::memory_order_relaxed) > capacity / 2) {
+        wake_writer();
+    }
+
+    return true;
+}
+
+static void rotate_log_files() {
+    const LoggerConfig& config = s_Logger.config;
+
+    if (s_Logger.file) {
+        Platform::CloseLogFile(s_Logger.file);
+        s_Logger.file = nullptr;
+    }
+
+    char source[512];
+    char destination[512];
+    for (uint32_t i = config.maxFileCount > 0 ? config.maxFileCount - 1 : 0; i > 0; i--) {
+        if (i == 1) {
+            Formatter::FormatTo(source, sizeof(source), "%s", config.filePath);
+        } else {
+            Formatter::FormatTo(source, sizeof(source), "%s.%u", config.filePath, i - 1);
+        }
+        Formatter::FormatTo(destination, sizeof(destination), "%s.%u", config.filePath, i);
+        Platform::RenameFile(source, destination);
+    }
+
+    s_Logger.file = Platform::OpenLogFile(config.filePath);
+    s_Logger.fileSize = 0;
+}
+
+static void write_lines(const LogLine* lines, uint32_t count) {
+    Platform::WriteLogConsole(lines, count);
+
+    if (s_Logger.file) {
+        s_Logger.fileSize += Platform::WriteLogFile(s_Logger.file, lines, count);
+        if (s_Logger.fileSize >= s_Logger.config.maxFileSize) {
+            rotate_log_files();
+        }
+    }
 }
 
-void Logger::Info(const char* format, ...) {
-    internal_logger(log_level::info, format);
+struct LogRingCursor {
+    LogRing* ring;
+    const char* data;
+    uint64_t position;
+    uint64_t end;
+};
+
+/* Next record of a ring, skipping wrap markers, nullptr once it reached end. */
+static const LogRecordHeader* peek_record(LogRingCursor& cursor, uint64_t capacity) {
+    while (cursor.position < cursor.end) {
+        uint64_t offset = cursor.position & (capacity - 1);
+        uint64_t toEnd = capacity - offset;
+
+        const LogRecordHeader* header = (const LogRecordHeader*)(cursor.data + offset);
+        if (toEnd < sizeof(LogRecordHeader) || header->size == LOG_WRAP_RECORD) {
+            cursor.position += toEnd;
+            continue;
+        }
+
+        return header;
+    }
+
+    return nullptr;
+}
+
+/* Writes out every record pushed so far, oldest first across all threads. */
+static void drain() {
+    std::lock_guard<std::mutex> lock(s_Logger.drainMutex);
+
+    uint64_t capacity = s_Logger.ringSize;
+    LogRingCursor cursors[MAX_LOG_THREADS];
+    uint32_t cursorCount = 0;
+
+    for (LogRing& ring : s_Logger.rings) {
+        // The state is read before head, an orphaned ring's head is final.
+        LogRingState state = ring.state.load(std::memory_order_acquire);
+        if (state == LogRingState::Free) {
+            continue;
+        }
+
+        uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+        uint64_t head = ring.head.load(std::memory_order_acquire);
+        if (head != tail) {
+            cursors[cursorCount++] = { &ring, ring.data.load(std::memory_order_relaxed), tail, head };
+        } else if (state == LogRingState::Orphaned) {
+            ring.state.store(LogRingState::Free, std::memory_order_release);
+        }
+    }
+
+    LogLine lines[LOG_BATCH_SIZE];
+    uint32_t lineCount = 0;
+
+    for (;;) {
+        LogRingCursor* next = nullptr;
+        const LogRecordHeader* nextHeader = nullptr;
+
+        for (uint32_t i = 0; i < cursorCount; i++) {
+            const LogRecordHeader* header = peek_record(cursors[i], capacity);
+            if (header && (!nextHeader || header->time < nextHeader->time)) {
+                next = &cursors[i];
+                nextHeader = header;
+            }
+        }
+
+        if (next) {
+            lines[lineCount++] = { (const char*)(nextHeader + 1), nextHeader->size, nextHeader->level };
+            next->position += align_record(sizeof(LogRecordHeader) + nextHeader->size);
+        }
+
+        if (lineCount == LOG_BATCH_SIZE || (!next && lineCount > 0)) {
+            write_lines(lines, lineCount);
+            lineCount = 0;
+
+            // The lines pointed into the rings, only now can their producers reuse that memory.
+            for (uint32_t i = 0; i < cursorCount; i++) {
+                cursors[i].ring->tail.store(cursors[i].position, std::memory_order_release);
+            }
+        }
+
+        if (!next) {
+            break;
+        }
+    }
+}
+
+static void writer_main() {
+    std::unique_lock<std::mutex> lock(s_Logger.wakeMutex);
+
+    while (!s_Logger.stop) {
+        s_Logger.wake.wait_for(lock, std::chrono::milliseconds(s_Logger.config.flushIntervalMs));
+
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+}
+
+/* Formats and writes on the calling thread, to the log file too while the logger runs. */
+static void write_synchronously(log_level level, const char* format, const FormatArg* args, uint32_t argCount) {
+    char stackBuffer[LOG_STACK_BUFFER_SIZE];
+    char* buffer = stackBuffer;
+
+    FormatSink sink;
+    sink.buffer = stackBuffer;
+    sink.capacity = sizeof(stackBuffer) - 1;
+    format_message(sink, level, format, args, argCount);
+
+    uint64_t size = sink.size;
+    if (size > sink.capacity) {
+        buffer = (char*)Platform::UAllocUninitialized(size + 1, MemoryTag::String);
+
+        sink.buffer = buffer;
+        sink.capacity = size;
+        sink.size = 0;
+        format_message(sink, level, format, args, argCount);
+    }
+    buffer[size] = 0;
+
+    if (s_Logger.running.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(s_Logger.drainMutex);
+        LogLine line{ buffer, (uint32_t)size, level };
+        write_lines(&line, 1);
+    } else {
+        Platform::Log(level, buffer);
+    }
+
+    if (buffer != stackBuffer) {
+        Platform::UFree(buffer);
+    }
+}
+
+void Logger::InitializeLogging(const LoggerConfig& config) {
+    if (s_Logger.running.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    assert(config.threadBufferSize >= 4096 && (config.threadBufferSize & (config.threadBufferSize - 1)) == 0 &&
+        "LoggerConfig::threadBufferSize must be a power of two of at least a page");
+
+    s_Logger.config = config;
+    if (!s_Logger.ringSize) {
+        s_Logger.ringSize = config.threadBufferSize;
+    }
+    s_Logger.generation.fetch_add(1, std::memory_order_relaxed);
+
+    if (config.filePath) {
+        rotate_log_files();
+        if (!s_Logger.file) {
+            Logger::Warning("Failed to open log file %s, logging to the console only", config.filePath);
+        }
+    }
+
+    if (config.binaryLogPath && !BinaryLog::Open(config.binaryLogPath, config.binaryLogSize)) {
+        Logger::Warning("Failed to create binary log %s, logging text only", config.binaryLogPath);
+    }
+
+    s_Logger.stop = false;
+    s_Logger.running.store(true, std::memory_order_release);
+    s_Logger.writer = std::thread(writer_main);
+}
+
+void Logger::ShutdownLogging() {
+    if (!s_Logger.running.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    s_Logger.generation.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(s_Logger.wakeMutex);
+        s_Logger.stop = true;
+    }
+    s_Logger.wake.notify_one();
+    s_Logger.writer.join();
+
+    drain();
+    BinaryLog::Close();
+
+    if (s_Logger.file) {
+        Platform::CloseLogFile(s_Logger.file);
+        s_Logger.file = nullptr;
+    }
+
+    // The memory of the rings stays, a thread that started logging before the shutdown may still be writing to its ring.
+    for (LogRing& ring : s_Logger.rings) {
+        ring.head.store(0, std::memory_order_relaxed);
+        ring.tail.store(0, std::memory_order_relaxed);
+        ring.state.store(LogRingState::Free, std::memory_order_relaxed);
+    }
+}
+
+void Logger::Flush() {
+    if (s_Logger.running.load(std::memory_order_acquire)) {
+        drain();
+    }
+}
+
+bool LogRateLimiter::Allow(uint32_t& suppressed) {
+    static constexpr int64_t WINDOW = 1000000000;
+
+    int64_t now = Platform::GetTime();
+    int64_t windowStart = m_WindowStart.load(std::memory_order_relaxed);
+    if (now - windowStart >= WINDOW && m_WindowStart.compare_exchange_strong(windowStart, now, std::memory_order_relaxed)) {
+        m_Count.store(0, std::memory_order_relaxed);
+    }
+
+    if (m_Count.fetch_add(1, std::memory_order_relaxed) < m_Limit) {
+        suppressed = m_Suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    m_Suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void Logger::Write(log_level level, const char* format, const FormatArg* args, uint32_t argCount) {
+    if (s_Logger.running.load(std::memory_order_acquire)) {
+        // Binary records replace the text, except for warnings and errors that somebody should see right away.
+        if (BinaryLog::IsOpen() && BinaryLog::Write(level, format, args, argCount) && level > log_level::warning) {
+            return;
+        }
+
+        LogRing* ring = acquire_thread_ring();
+        if (ring && push_record(*ring, level, format, args, argCount)) {
+            if (level == log_level::fatal) {
+                Flush();
+            }
+            return;
+        }
+
+        // Whatever this thread queued before has to come out first.
+        Flush();
+    }
+
+    write_synchronously(level, format, args, argCount);
 }
\ No newline at end of file
@@ -1,18 +1,168 @@
 #pragma once
 
+#include "defines.h"
+#include "core/format.h"
+
+#include <atomic>
+
+/* From most to least severe, so a level enables everything before it. */
 enum log_level : char {
     fatal,
     warning,
-    debug,
-    info
+    info,
+    debug
+};
+
+/* Least severe level compiled in, LOG_* calls past it are removed along with their arguments. */
+#if !defined(STIMPLY_LOG_LEVEL)
+#if defined(DEBUG)
+#define STIMPLY_LOG_LEVEL 3
+#else
+#define STIMPLY_LOG_LEVEL 2
+#endif
+#endif
+
+/* Messages a single LOG_* call site may write per second, the rest are counted and dropped. */
+#if !defined(STIMPLY_LOG_RATE_LIMIT)
+#define STIMPLY_LOG_RATE_LIMIT 32
+#endif
+
+/* One formatted message on its way to the console or the log file, not null terminated. */
+struct LogLine {
+    const char* message;
+    uint32_t size;
+    log_level level;
+};
+
+struct LoggerConfig {
+    /* Rotated to "<path>.1", "<path>.2"... when it grows past maxFileSize. nullptr logs to the console only. */
+    const char* filePath = "stimply.log";
+    uint64_t maxFileSize = 16ull * 1024 * 1024;
+    /* Including the one being written. */
+    uint32_t maxFileCount = 4;
+    /* Size of each thread's buffer, a power of two of at least a page. Set by the first InitializeLogging, the buffers are kept until the process exits. */
+    uint64_t threadBufferSize = 256 * 1024;
+    /* How often the writer thread wakes up on its own. */
+    uint32_t flushIntervalMs = 10;
+    /*
+     * Binary mode: messages are recorded as their format's id and the raw bytes of their arguments into this
+     * memory mapped file, nothing is formatted at runtime. Stimply-LogDecode turns it into text. The file outlives
+     * a crash, so the last messages before it can always be recovered. On startup an existing file is renamed to
+     * "<path>.prev" first, so the next run doesn't overwrite the log of one that crashed. Warnings and fatal errors
+     * are printed as text as well. Formats must be string literals in this mode. nullptr disables it.
+     */
+    const char* binaryLogPath = nullptr;
+    /* Once full, the oldest messages are overwritten. */
+    uint64_t binaryLogSize = 64ull * 1024 * 1024;
 };
 
+/*
+ * Formats go through Formatter, so arguments are type checked and printf specifiers work as before.
+ * Between InitializeLogging and ShutdownLogging messages are formatted straight into a buffer owned by
+ * the calling thread and written out in batches by a background thread. Outside of that window, or when
+ * a message doesn't fit the buffer, it's written synchronously. Fatal messages are flushed right away.
+ * Threads still logging when ShutdownLogging is called may lose their last messages, the buffers and the binary log
+ * stay mapped until the process exits so they never write to freed memory.
+ */
 class RAPI Logger {
 public:
-    static void InitializeLogging();
+    static void InitializeLogging(const LoggerConfig& config = LoggerConfig());
     static void ShutdownLogging();
-    static void Fatal(const char* format, ...);
-    static void Warning(const char* format, ...);
-    static void Debug(const char* format, ...);
-    static void Info(const char* format, ...);
-};
\ No newline at end of file
+    /* Blocks until everything logged so far is written. */
+    static void Flush();
+
+    /* Runtime filter on top of STIMPLY_LOG_LEVEL, messages less severe than level are skipped. */
+    static AINLINE void SetLevel(log_level level) { s_Level.store(level, std::memory_order_relaxed); }
+    static AINLINE log_level GetLevel() { return s_Level.load(std::memory_order_relaxed); }
+    static AINLINE bool IsEnabled(log_level level) { return level <= s_Level.load(std::memory_order_relaxed); }
+
+    template<typename... Args>
+    static void Fatal(const char* format, const Args&... args) { Log(log_level::fatal, format, args...); }
+
+    template<typename... Args>
+    static void Warning(const char* format, const Args&... args) { Log(log_level::warning, format, args...); }
+
+    template<typename... Args>
+    static void Debug(const char* format, const Args&... args) { Log(log_level::debug, format, args...); }
+
+    template<typename... Args>
+    static void Info(const char* format, const Args&... args) { Log(log_level::info, format, args...); }
+
+    template<typename... Args>
+    static AINLINE void Log(log_level level, const char* format, const Args&... args) {
+        if (!IsEnabled(level)) {
+            return;
+        }
+
+        FormatArgs<Args...> formatArgs(args...);
+        Write(level, format, formatArgs.list, FormatArgs<Args...>::COUNT);
+    }
+
+private:
+    static void Write(log_level level, const char* format, const FormatArg* args, uint32_t argCount);
+
+private:
+    static inline std::atomic<log_level> s_Level{ (log_level)STIMPLY_LOG_LEVEL };
+};
+
+/* Fixed one second window budget for a call site, shared by every thread that reaches it. */
+class RAPI LogRateLimiter {
+public:
+    constexpr LogRateLimiter(uint32_t messagesPerSecond) : m_Limit(messagesPerSecond) {}
+
+    /* True if the call may log, suppressed is set to how many calls were dropped since the last one that could. */
+    bool Allow(uint32_t& suppressed);
+
+private:
+    const uint32_t m_Limit;
+    std::atomic<int64_t> m_WindowStart{ 0 };
+    std::atomic<uint32_t> m_Count{ 0 };
+    std::atomic<uint32_t> m_Suppressed{ 0 };
+};
+
+/*
+ * Preferred over calling Logger directly: calls past STIMPLY_LOG_LEVEL compile to nothing, calls disabled at runtime
+ * don't evaluate their arguments and every call site is limited to STIMPLY_LOG_RATE_LIMIT messages per second,
+ * so a log line inside a hot loop can't flood the output. What's dropped is reported with the next message that isn't.
+ * Fatal errors are never limited, every one of them is written and flushed.
+ */
+#define LOG_FATAL(...) STIMPLY_LOG_UNLIMITED(log_level::fatal, __VA_ARGS__)
+#define LOG_WARNING(...) STIMPLY_LOG(log_level::warning, __VA_ARGS__)
+#define LOG_INFO(...) STIMPLY_LOG(log_level::info, __VA_ARGS__)
+#define LOG_DEBUG(...) STIMPLY_LOG(log_level::debug, __VA_ARGS__)
+
+/* Logs only the first time the call site is reached. */
+#define LOG_ONCE(level, ...)                                                                                \
+    do {                                                                                                    \
+        if constexpr ((level) <= STIMPLY_LOG_LEVEL) {                                                       \
+            static std::atomic<bool> stimply_log_done{ false };                                             \
+            if (Logger::IsEnabled(level) && !stimply_log_done.exchange(true, std::memory_order_relaxed)) { \
+                Logger::Log(level, __VA_ARGS__);                                                            \
+            }                                                                                               \
+        }                                                                                                   \
+    } while (0)
+
+#define STIMPLY_LOG_UNLIMITED(level, ...)                     \
+    do {                                                      \
+        if constexpr ((level) <= STIMPLY_LOG_LEVEL) {         \
+            if (Logger::IsEnabled(level)) {                   \
+                Logger::Log(level, __VA_ARGS__);              \
+            }                                                 \
+        }                                                     \
+    } while (0)
+
+#define STIMPLY_LOG(level, ...) STIMPLY_LOG_RATE_LIMITED(level, STIMPLY_LOG_RATE_LIMIT, __VA_ARGS__)
+
+#define STIMPLY_LOG_RATE_LIMITED(level, messagesPerSecond, ...)                                                                 \
+    do {                                                                                                                        \
+        if constexpr ((level) <= STIMPLY_LOG_LEVEL) {                                                                           \
+            static LogRateLimiter stimply_log_limiter(messagesPerSecond);                                                       \
+            uint32_t stimply_log_suppressed = 0;                                                                                \
+            if (Logger::IsEnabled(level) && stimply_log_limiter.Allow(stimply_log_suppressed)) {                                \
+                if (stimply_log_suppressed) {                                                                                   \
+                    Logger::Log(level, "%s:%d: %u similar messages were dropped", __FILE__, __LINE__, stimply_log_suppressed); \
+                }                                                                                                               \
+                Logger::Log(level, __VA_ARGS__);                                                                                \
+            }                                                                                                                   \
+        }                                                                                                                       \
+    } while (0)
@@ -0,0 +1,439 @@
+#include "number_parser.h"
+
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static constexpr uint64_t MAX_EXACT_MANTISSA = 1ull << 53;
+static constexpr int32_t MAX_EXACT_POWER = 22;
+static constexpr uint32_t MAX_MANTISSA_DIGITS = 19;
+static constexpr uint64_t MAX_EXACT_FLOAT_MANTISSA = 1ull << 24;
+static constexpr int32_t MAX_EXACT_FLOAT_POWER = 10;
+
+/* Every power of ten up to 1e22 is exactly representable as a double. */
+static constexpr double s_ExactPowersOfTen[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Same for floats, up to 1e10. */
+static constexpr float s_ExactFloatPowersOfTen[] = {
+	1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+static constexpr uint64_t s_IntegerPowersOfTen[] = {
+	1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+	100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull,
+	10000000000000ull, 100000000000000ull, 1000000000000000ull
+};
+
+static AINLINE bool is_digit(char character) {
+	return (unsigned char)(character - '0') < 10;
+}
+
+static AINLINE uint32_t count_trailing_zeros(uint64_t mask) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, mask);
+	return index;
+#else
+	return (uint32_t)__builtin_ctzll(mask);
+#endif
+}
+
+/*
+ * Eight digit values, one per byte with the first digit in the lowest byte, to their number.
+ * Each step merges neighbouring lanes with one multiply: 8 x 1 digit -> 4 x 2 -> 2 x 4 -> 8.
+ */
+static AINLINE uint64_t combine_eight_digits(uint64_t digits) {
+	digits = (digits * 10 + (digits >> 8)) & 0x00ff00ff00ff00ffull;
+	digits = (digits * 100 + (digits >> 16)) & 0x0000ffff0000ffffull;
+	return (digits * 10000 + (digits >> 32)) & 0xffffffffull;
+}
+
+/*
+ * Appends the digits at p to mantissa and returns the first non digit. Works on eight characters at a time,
+ * so numbers of different lengths don't cost a mispredicted branch per digit. Wraps past 19 digits.
+ */
+static AINLINE const char* accumulate_digits(const char* p, const char* last, uint64_t& mantissa) {
+	while (last - p >= 8) {
+		uint64_t chunk;
+		memcpy(&chunk, p, sizeof(chunk));
+
+		// Bytes below '0' borrow and bytes above '9' carry into their top bit. Only the lowest
+		// flagged byte matters, everything above it is thrown away.
+		uint64_t digits = chunk - 0x3030303030303030ull;
+		uint64_t nonDigits = (digits | (chunk + 0x4646464646464646ull)) & 0x8080808080808080ull;
+
+		if (nonDigits == 0) {
+			mantissa = mantissa * 100000000 + combine_eight_digits(digits);
+			p += 8;
+			continue;
+		}
+
+		uint32_t count = count_trailing_zeros(nonDigits) / 8;
+		if (count > 0) {
+			// Shifting the digits up leaves zero lanes in front of them, which are leading zeros.
+			mantissa = mantissa * s_IntegerPowersOfTen[count] + combine_eight_digits(digits << (64 - 8 * count));
+		}
+
+		return p + count;
+	}
+
+	for (; p != last && is_digit(*p); p++) {
+		mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+	}
+
+	return p;
+}
+
+static AINLINE char to_lower_ascii(char character) {
+	return character >= 'A' && character <= 'Z' ? character - 'A' + 'a' : character;
+}
+
+/* Case insensitive match of word at p, returns the end of the match or nullptr. */
+static const char* match_word(const char* p, const char* last, const char* word) {
+	for (; *word; word++, p++) {
+		if (p == last || to_lower_ascii(*p) != *word) {
+			return nullptr;
+		}
+	}
+	return p;
+}
+
+/* value = mantissa * 10^exponent, mantissa holds the first 19 significant digits. */
+struct DecimalNumber {
+	uint64_t mantissa = 0;
+	int64_t exponent = 0;
+	bool negative = false;
+	/* A non zero digit didn't fit the mantissa. */
+	bool truncated = false;
+	bool infinity = false;
+	bool nan = false;
+};
+
+/* Redoes the mantissa of a number with more digits than fit, keeping the first 19 significant ones. */
+static void scan_long_mantissa(const char* p, const char* end, DecimalNumber& number) {
+	uint32_t significantDigits = 0;
+	bool fraction = false;
+
+	number.mantissa = 0;
+	number.exponent = 0;
+
+	for (; p != end; p++) {
+		if (*p == '.') {
+			fraction = true;
+			continue;
+		}
+
+		uint32_t digit = *p - '0';
+
+		if (significantDigits < MAX_MANTISSA_DIGITS) {
+			number.mantissa = number.mantissa * 10 + digit;
+			number.exponent -= fraction;
+			significantDigits += number.mantissa != 0;
+		} else {
+			number.exponent += !fraction;
+			number.truncated |= digit != 0;
+		}
+	}
+}
+
+/* "inf", "infinity" or "nan" after the sign at p. */
+static ParseResult scan_special(const char* first, const char* p, const char* last, DecimalNumber& number) {
+	if (const char* end = match_word(p, last, "infinity")) {
+		number.infinity = true;
+		return { end, ParseError::None };
+	}
+	if (const char* end = match_word(p, last, "inf")) {
+		number.infinity = true;
+		return { end, ParseError::None };
+	}
+	if (const char* end = match_word(p, last, "nan")) {
+		number.nan = true;
+		return { end, ParseError::None };
+	}
+	return { first, ParseError::Invalid };
+}
+
+static AINLINE ParseResult scan_decimal(const char* first, const char* last, DecimalNumber& number) {
+	const char* p = first;
+
+	// Signs are about as random as the data, so skip them without a branch.
+	if (p != last) {
+		number.negative = *p == '-';
+		p += number.negative | (*p == '+');
+	}
+
+	// Accumulate every digit blindly, leading zeros add nothing so the mantissa is right
+	// unless there are more than 19 significant digits, which is checked once at the end.
+	const char* digitsStart = p;
+	uint64_t mantissa = 0;
+
+	p = accumulate_digits(p, last, mantissa);
+	int64_t digitCount = p - digitsStart;
+	int64_t exponent = 0;
+
+	if (p != last && *p == '.') {
+		p++;
+		const char* fractionStart = p;
+		p = accumulate_digits(p, last, mantissa);
+
+		exponent = -(p - fractionStart);
+		digitCount += p - fractionStart;
+	}
+
+	if (digitCount == 0) {
+		return scan_special(first, digitsStart, last, number);
+	}
+
+	number.mantissa = mantissa;
+	number.exponent = exponent;
+
+	if (digitCount > MAX_MANTISSA_DIGITS) {
+		scan_long_mantissa(digitsStart, p, number);
+	}
+
+	// The exponent only counts if it has digits, "1e" parses as 1 followed by "e".
+	if (p != last && (*p == 'e' || *p == 'E')) {
+		const char* q = p + 1;
+		bool negativeExponent = false;
+
+		if (q != last && (*q == '-' || *q == '+')) {
+			negativeExponent = *q == '-';
+			q++;
+		}
+
+		if (q != last && is_digit(*q)) {
+			int64_t exponent = 0;
+			for (; q != last && is_digit(*q); q++) {
+				// Anything this big is already 0 or infinity, stop before it overflows.
+				if (exponent < 100000) {
+					exponent = exponent * 10 + (*q - '0');
+				}
+			}
+
+			number.exponent += negativeExponent ? -exponent : exponent;
+			p = q;
+		}
+	}
+
+	return { p, ParseError::None };
+}
+
+/*
+ * Clinger's fast path: when both the mantissa and the power of ten are exact doubles,
+ * a single IEEE multiplication or division is correctly rounded.
+ */
+static AINLINE bool try_fast_path(const DecimalNumber& number, double& value) {
+	if (number.mantissa == 0) {
+		value = number.negative ? -0.0 : 0.0;
+		return true;
+	}
+
+	if (number.truncated || number.mantissa > MAX_EXACT_MANTISSA) {
+		return false;
+	}
+
+	double result;
+	int64_t exponent = number.exponent;
+
+	if (exponent >= 0 && exponent <= MAX_EXACT_POWER) {
+		result = (double)number.mantissa * s_ExactPowersOfTen[exponent];
+	} else if (exponent < 0 && exponent >= -MAX_EXACT_POWER) {
+		result = (double)number.mantissa / s_ExactPowersOfTen[-exponent];
+	} else if (exponent > MAX_EXACT_POWER && exponent <= MAX_EXACT_POWER + 15) {
+		// Small mantissas with big exponents ("3e30") can move some of the power into the mantissa.
+		uint64_t shift = s_IntegerPowersOfTen[exponent - MAX_EXACT_POWER];
+		if (number.mantissa > MAX_EXACT_MANTISSA / shift) {
+			return false;
+		}
+		result = (double)(number.mantissa * shift) * s_ExactPowersOfTen[MAX_EXACT_POWER];
+	} else {
+		return false;
+	}
+
+	value = number.negative ? -result : result;
+	return true;
+}
+
+/*
+ * Everything the fast paths can't do exactly goes to std::from_chars, which is locale independent, correctly
+ * rounded and reads the span in place. It only takes the text scan_decimal accepted, minus a leading '+'.
+ */
+template<typename T>
+static ParseResult parse_slow_path(const char* first, ParseResult result, const DecimalNumber& number, T& value) {
+	const char* start = first + (*first == '+');
+
+	T parsed;
+	std::from_chars_result converted = std::from_chars(start, result.end, parsed);
+	if (converted.ec == std::errc::result_out_of_range) {
+		// Too small rounds to zero like strtod did, too big is an error.
+		if (number.exponent > 0) {
+			return { result.end, ParseError::OutOfRange };
+		}
+		parsed = number.negative ? -(T)0 : (T)0;
+	} else if (converted.ec != std::errc() || std::isinf(parsed)) {
+		return { result.end, ParseError::OutOfRange };
+	}
+
+	value = parsed;
+	return result;
+}
+
+ParseResult NumberParser::Parse(const char* first, const char* last, double& value) {
+	DecimalNumber number;
+	ParseResult result = scan_decimal(first, last, number);
+	if (!result.IsOk()) {
+		return result;
+	}
+
+	if (number.infinity || number.nan) {
+		double special = number.nan ? std::numeric_limits<double>::quiet_NaN() : std::numeric_limits<double>::infinity();
+		value = number.negative ? -special : special;
+		return result;
+	}
+
+	if (try_fast_path(number, value)) {
+		return result;
+	}
+
+	return parse_slow_path(first, result, number, value);
+}
+
+ParseResult NumberParser::Parse(const char* first, const char* last, float& value) {
+	DecimalNumber number;
+	ParseResult result = scan_decimal(first, last, number);
+	if (!result.IsOk()) {
+		return result;
+	}
+
+	if (number.infinity || number.nan) {
+		float special = number.nan ? std::numeric_limits<float>::quiet_NaN() : std::numeric_limits<float>::infinity();
+		value = number.negative ? -special : special;
+		return result;
+	}
+
+	// Same idea in single precision, covers the usual "%f" output of exporters.
+	if (number.mantissa <= MAX_EXACT_FLOAT_MANTISSA && number.exponent >= -MAX_EXACT_FLOAT_POWER && number.exponent <= MAX_EXACT_FLOAT_POWER && !number.truncated) {
+		float single = (float)number.mantissa;
+		single = number.exponent < 0 ? single / s_ExactFloatPowersOfTen[-number.exponent] : single * s_ExactFloatPowersOfTen[number.exponent];
+		value = number.negative ? -single : single;
+		return result;
+	}
+
+	// A correctly rounded double rounds to the correctly rounded float, unless it landed exactly
+	// halfway between two floats (double rounding). Those, and float subnormals, take the slow path.
+	double exact;
+	if (try_fast_path(number, exact)) {
+		double magnitude = fabs(exact);
+
+		if (magnitude == 0.0) {
+			value = (float)exact;
+			return result;
+		}
+
+		if (magnitude >= FLT_MIN && magnitude <= FLT_MAX) {
+			uint64_t bits;
+			memcpy(&bits, &exact, sizeof(bits));
+
+			// 52 - 23 = 29 mantissa bits are dropped, halfway means only the highest of them is set.
+			if ((bits & ((1ull << 29) - 1)) != (1ull << 28)) {
+				value = (float)exact;
+				return result;
+			}
+		}
+	}
+
+	return parse_slow_path(first, result, number, value);
+}
+
+/* Parses the digits at p as a magnitude no bigger than max, a constant so the divisions below fold away. */
+template<uint64_t max>
+static AINLINE ParseResult parse_magnitude(const char* first, const char* p, const char* last, uint64_t& magnitude) {
+	const char* digitsStart = p;
+	uint64_t result = 0;
+
+	p = accumulate_digits(p, last, result);
+	if (p == digitsStart) {
+		return { first, ParseError::Invalid };
+	}
+
+	// Up to 19 digits the mantissa can't wrap, so a plain compare finds overflow.
+	// Longer numbers (leading zeros, or past the range of uint64_t) redo it carefully.
+	if ((uint64_t)(p - digitsStart) <= MAX_MANTISSA_DIGITS) {
+		if (result > max) {
+			return { p, ParseError::OutOfRange };
+		}
+	} else {
+		constexpr uint64_t maxTens = max / 10;
+		constexpr uint64_t maxLastDigit = max % 10;
+
+		result = 0;
+		for (const char* digit = digitsStart; digit != p; digit++) {
+			uint64_t value = *digit - '0';
+
+			if (result > maxTens || (result == maxTens && value > maxLastDigit)) {
+				return { p, ParseError::OutOfRange };
+			}
+			result = result * 10 + value;
+		}
+	}
+
+	magnitude = result;
+	return { p, ParseError::None };
+}
+
+template<typename T>
+static ParseResult parse_unsigned(const char* first, const char* last, T& value) {
+	const char* p = first;
+	if (p != last && *p == '+') {
+		p++;
+	}
+
+	uint64_t magnitude;
+	ParseResult result = parse_magnitude<std::numeric_limits<T>::max()>(first, p, last, magnitude);
+	if (result.IsOk()) {
+		value = (T)magnitude;
+	}
+
+	return result;
+}
+
+template<typename T>
+static ParseResult parse_signed(const char* first, const char* last, T& value) {
+	const char* p = first;
+	bool negative = false;
+
+	if (p != last && (*p == '-' || *p == '+')) {
+		negative = *p == '-';
+		p++;
+	}
+
+	// The negative range is one bigger than the positive one.
+	constexpr uint64_t max = (uint64_t)std::numeric_limits<T>::max();
+
+	uint64_t magnitude;
+	ParseResult result = negative ? parse_magnitude<max + 1>(first, p, last, magnitude) : parse_magnitude<max>(first, p, last, magnitude);
+	if (result.IsOk()) {
+		value = negative ? (T)(0 - magnitude) : (T)magnitude;
+	}
+
+	return result;
+}
+
+ParseResult NumberParser::Parse(const char* first, const char* last, uint8_t& value) { return parse_unsigned(first, last, value); }
+ParseResult NumberParser::Parse(const char* first, const char* last, uint16_t& value) { return parse_unsigned(first, last, value); }
+ParseResult NumberParser::Parse(const char* first, const char* last, uint32_t& value) { return parse_unsigned(first, last, value); }
+ParseResult NumberParser::Parse(const char* first, const char* last, uint64_t& value) { return parse_unsigned(first, last, value); }
+
+ParseResult NumberParser::Parse(const char* first, const char* last, int8_t& value) { return parse_signed(first, last, value); }
+ParseResult NumberParser::Parse(const char* first, const char* last, int16_t& value) { return parse_signed(first, last, value); }
+ParseResult NumberParser::Parse(const char* first, const char* last, int32_t& value) { return parse_signed(first, last, value); }
+ParseResult NumberParser::Parse(const char* first, const char* last, int64_t& value) { return parse_signed(first, last, value); }
\ No newline at end of file
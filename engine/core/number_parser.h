@@ -0,0 +1,49 @@
+#pragma once
+
+#include "defines.h"
+#include "core/string_view.h"
+
+#include <cstdint>
+
+enum class ParseError : uint8_t {
+	None,
+	/* No number at the start of the input. */
+	Invalid,
+	/* Syntactically fine but doesn't fit the type. */
+	OutOfRange
+};
+
+struct ParseResult {
+	/* First character that isn't part of the number. */
+	const char* end;
+	ParseError error;
+
+	AINLINE bool IsOk() const { return error == ParseError::None; }
+};
+
+/*
+ * Locale independent number parsing over [first, last), the input doesn't need a terminator.
+ * Leading whitespace is not skipped and value is only written on success.
+ * Integers are decimal with an optional sign. Floats accept [+-]digits[.digits][(e|E)[+-]digits],
+ * "inf", "infinity" and "nan", and are correctly rounded: values with at most 15 significant digits
+ * and small exponents (almost everything found in asset files) take an exact floating point fast path,
+ * the rest goes through std::from_chars.
+ */
+class RAPI NumberParser {
+public:
+	static ParseResult Parse(const char* first, const char* last, float& value);
+	static ParseResult Parse(const char* first, const char* last, double& value);
+
+	static ParseResult Parse(const char* first, const char* last, uint8_t& value);
+	static ParseResult Parse(const char* first, const char* last, uint16_t& value);
+	static ParseResult Parse(const char* first, const char* last, uint32_t& value);
+	static ParseResult Parse(const char* first, const char* last, uint64_t& value);
+
+	static ParseResult Parse(const char* first, const char* last, int8_t& value);
+	static ParseResult Parse(const char* first, const char* last, int16_t& value);
+	static ParseResult Parse(const char* first, const char* last, int32_t& value);
+	static ParseResult Parse(const char* first, const char* last, int64_t& value);
+
+	template<typename T>
+	static AINLINE ParseResult Parse(StringView text, T& value) { return Parse(text.begin(), text.end(), value); }
+};
\ No newline at end of file
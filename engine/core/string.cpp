@@ -1,24 +1,17 @@
 #include "string.h"
 
 #include "core/logger.h"
+#include "core/number_parser.h"
 #include "platform/platform.h"
 
-#include <cstdarg>
-#include <cstdio>
 #include <exception>
 
 class StringException : public std::exception {
 public:
-	StringException(const char* error_message, ...) {
-		__builtin_va_list va;
-		va_start(va, error_message);
-		char buffer[20000];
-		int32_t written = vsprintf(buffer, error_message, va);
-		buffer[written] = 0;
-		va_end(va);
-
-		m_What = String(buffer, written);
-	}
+	template<typename... Args>
+	StringException(const char* format, const Args&... args)
+		:
+		m_What(String::Format(format, args...)) {}
 
 	const char* what() const noexcept {
 		return m_What.CStr();
@@ -27,47 +20,168 @@ private:
 	String m_What;
 };
 
-String::String() 
-	:
-	m_Buffer(0) {}
+String::String() {
+	InitEmpty();
+}
 
 String::String(const char* string) {
-	uint64_t stringSize = strlen(string);
+	InitEmpty();
+	Assign(string, strlen(string));
+}
 
-	if (stringSize > 0) {
-		m_Buffer.resize(stringSize + 1);
-		memcpy(m_Buffer.data(), string, stringSize);
-		m_Buffer[stringSize] = 0;
+String::String(const char* string, uint64_t stringSize) {
+	InitEmpty();
+	Assign(string, stringSize);
+}
+
+String::String(StringView view) {
+	InitEmpty();
+	Assign(view.Data(), view.GetSize());
+}
+
+String::String(const String& other) {
+	InitEmpty();
+	Assign(other.CStr(), other.GetSize());
+}
+
+String::String(String&& other) noexcept {
+	memcpy(m_Inline, other.m_Inline, sizeof(m_Inline));
+	other.InitEmpty();
+}
+
+String::~String() {
+	FreeHeap();
+}
+
+String& String::operator=(const String& other) {
+	if (this != &other) {
+		Assign(other.CStr(), other.GetSize());
 	}
+	return *this;
 }
 
-String::String(const char* string, uint64_t stringSize) {
-	if (stringSize > 0) {
-		m_Buffer.resize(stringSize + 1);
-		memcpy(m_Buffer.data(), string, stringSize);
-		m_Buffer[stringSize] = 0;
+String& String::operator=(String&& other) noexcept {
+	if (this != &other) {
+		FreeHeap();
+		memcpy(m_Inline, other.m_Inline, sizeof(m_Inline));
+		other.InitEmpty();
+	}
+	return *this;
+}
+
+String& String::operator=(const char* string) {
+	Assign(string, strlen(string));
+	return *this;
+}
+
+String operator+(const String& string0, const String& string1) {
+	String result;
+	result.Reserve(string0.GetSize() + string1.GetSize());
+	result.Append(string0.CStr(), string0.GetSize());
+	result.Append(string1.CStr(), string1.GetSize());
+	return result;
+}
+
+String operator+(const String& string0, const char* string1) {
+	uint64_t size1 = strlen(string1);
+
+	String result;
+	result.Reserve(string0.GetSize() + size1);
+	result.Append(string0.CStr(), string0.GetSize());
+	result.Append(string1, size1);
+	return result;
+}
+
+String operator+(const char* string0, const String& string1) {
+	uint64_t size0 = strlen(string0);
+
+	String result;
+	result.Reserve(size0 + string1.GetSize());
+	result.Append(string0, size0);
+	result.Append(string1.CStr(), string1.GetSize());
+	return result;
+}
+
+void String::InitEmpty() {
+	m_Inline[0] = 0;
+	m_Inline[INLINE_CAPACITY] = (char)INLINE_CAPACITY;
+}
+
+void String::Assign(const char* string, uint64_t stringSize) {
+	if (stringSize > GetCapacity()) {
+		// string can't live in our buffer if it doesn't fit in it, so dropping the old contents is fine.
+		Clear();
+		Grow(stringSize);
 	}
+
+	memmove(Data(), string, stringSize);
+	SetSize(stringSize);
 }
 
-String String::Format(const char* format, ...) {
+void String::SetSize(uint64_t size) {
+	if (IsInline()) {
+		m_Inline[size] = 0;
+		m_Inline[INLINE_CAPACITY] = (char)(INLINE_CAPACITY - size);
+	} else {
+		m_Heap.data[size] = 0;
+		m_Heap.size = size;
+	}
+}
+
+void String::Grow(uint64_t minCapacity) {
+	uint64_t capacity = GetCapacity();
+	if (minCapacity <= capacity) {
+		return;
+	}
+
+	uint64_t newCapacity = capacity * 2 > minCapacity ? capacity * 2 : minCapacity;
+	uint64_t size = GetSize();
+
+	char* data = (char*)Platform::UAllocUninitialized(newCapacity + 1, MemoryTag::String);
+	memcpy(data, CStr(), size + 1);
+
+	FreeHeap();
+
+	m_Heap.data = data;
+	m_Heap.size = size;
+	m_Heap.capacity = newCapacity | HEAP_FLAG;
+}
+
+void String::FreeHeap() {
+	if (!IsInline()) {
+		Platform::UFree(m_Heap.data);
+		InitEmpty();
+	}
+}
+
+void String::Reserve(uint64_t capacity) {
+	Grow(capacity);
+}
+
+void String::AppendFormatArgs(const char* format, const FormatArg* args, uint32_t argCount) {
 	if (!format) {
 		throw StringException("Trying to format a string that's null");
 	}
 
-	String string;
+	uint64_t size = GetSize();
 
-	__builtin_va_list va;
-	va_start(va, format);
-	char buffer[20000];
-	int32_t written = vsprintf(buffer, format, va);
-	buffer[written] = 0;
-	va_end(va);
+	FormatSink sink;
+	sink.buffer = Data() + size;
+	sink.capacity = GetCapacity() - size;
+	Formatter::Format(sink, format, args, argCount);
 
-	string.m_Buffer.resize(written + 1);
-	memcpy(string.m_Buffer.data(), buffer, written);
-	string[written] = 0;
+	if (sink.size > sink.capacity) {
+		/* Only measured, now that the size is known grow once and write it for real. */
+		uint64_t formattedSize = sink.size;
+		Grow(size + formattedSize);
 
-	return string;
+		sink.buffer = Data() + size;
+		sink.capacity = formattedSize;
+		sink.size = 0;
+		Formatter::Format(sink, format, args, argCount);
+	}
+
+	SetSize(size + sink.size);
 }
 
 bool String::StringEqual(const char* string0, const char* string1) {
@@ -82,13 +196,45 @@ bool String::StringEqualI(const char* string0, const char* string1) {
 #endif
 }
 
+/* sscanf used to skip leading whitespace, the wrappers keep doing that. */
+static AINLINE const char* skip_whitespace(const char* p, const char* last) {
+	while (p != last && StringView::IsWhitespace(*p)) {
+		p++;
+	}
+	return p;
+}
+
+template<typename T>
+static T parse_number(const char* source) {
+	const char* last = source + strlen(source);
+
+	T value = 0;
+	NumberParser::Parse(skip_whitespace(source, last), last, value);
+	return value;
+}
+
+/* Whitespace separated floats, the ones that fail to parse stay 0. */
+static void parse_floats(const char* source, float* values, uint32_t count) {
+	const char* p = source;
+	const char* last = source + strlen(source);
+
+	for (uint32_t i = 0; i < count; i++) {
+		ParseResult result = NumberParser::Parse(skip_whitespace(p, last), last, values[i]);
+		if (!result.IsOk()) {
+			break;
+		}
+
+		p = result.end;
+	}
+}
+
 DirectX::XMFLOAT4 String::ToFloat4(const char* source) {
 	if (!source) {
 		throw StringException("Trying to convert string to float but source is nullptr");
 	}
 
 	DirectX::XMFLOAT4 float4{};
-	sscanf(source, "%f %f %f %f", &float4.x, &float4.y, &float4.z, &float4.w);
+	parse_floats(source, &float4.x, 4);
 
 	return float4;
 }
@@ -99,7 +245,7 @@ DirectX::XMFLOAT3 String::ToFloat3(const char* source) {
 	}
 	
 	DirectX::XMFLOAT3 float3{};
-	sscanf(source, "%f %f %f", &float3.x, &float3.y, &float3.z);
+	parse_floats(source, &float3.x, 3);
 
 	return float3;
 }
@@ -110,7 +256,7 @@ DirectX::XMFLOAT2 String::ToFloat2(const char* source) {
 	}
 
 	DirectX::XMFLOAT2 float2{};
-	sscanf(source, "%f %f", &float2.x, &float2.y);
+	parse_floats(source, &float2.x, 2);
 
 	return float2;
 }
@@ -125,225 +271,139 @@ bool String::IsBool(const char* source) {
 
 float String::ToFloat(const char* source) {
 	if (!source) {
-		Logger::Warning("String::ToFloat called with a null source string");
+		LOG_WARNING("String::ToFloat called with a null source string");
 		return MAX_FLOAT;
 	}
 
-	float float_res = 0.0f;
-	sscanf(source, "%f", &float_res);
-
-	return float_res;
+	return parse_number<float>(source);
 }
 
 double String::ToDouble(const char* source) {
 	if (!source) {
-		Logger::Warning("String::ToDouble called with a null source string");
+		LOG_WARNING("String::ToDouble called with a null source string");
 		return MAX_DOUBLE;
 	}
 
-	double double_res = 0.0f;
-	sscanf(source, "%lf", &double_res);
-
-	return double_res;
+	return parse_number<double>(source);
 }
 
 uint8_t String::Tou8(const char* source) {
 	if (!source) {
-		Logger::Warning("String::Tou8 called with a null source string");
+		LOG_WARNING("String::Tou8 called with a null source string");
 		return MAX_U8;
 	}
 
-	uint8_t u8_res = 0;
-	sscanf(source, "%hhu", &u8_res);
-
-	return u8_res;
+	return parse_number<uint8_t>(source);
 }
 
 uint16_t String::Tou16(const char* source) {
 	if (!source) {
-		Logger::Warning("String::Tou16 called with a null source string");
+		LOG_WARNING("String::Tou16 called with a null source string");
 		return MAX_U16;
 	}
 
-	uint16_t u16_res = 0;
-	sscanf(source, "%hu", &u16_res);
-
-	return u16_res;
+	return parse_number<uint16_t>(source);
 }
 
 uint32_t String::Tou32(const char* source) {
 	if (!source) {
-		Logger::Warning("String::Tou32 called with a null source string");
+		LOG_WARNING("String::Tou32 called with a null source string");
 		return MAX_U32;
 	}
 
-	uint32_t u32_res = 0;
-	sscanf(source, "%u", &u32_res);
-
-	return u32_res;
+	return parse_number<uint32_t>(source);
 }
 
 uint64_t String::Tou64(const char* source) {
 	if (!source) {
-		Logger::Warning("String::Tou64 called with a null source string");
+		LOG_WARNING("String::Tou64 called with a null source string");
 		return MAX_U64;
 	}
 
-	uint64_t u64_res = 0;
-	sscanf(source, "%llu", &u64_res);
-
-	return u64_res;
+	return parse_number<uint64_t>(source);
 }
 
 int8_t String::Toi8(const char* source) {
 	if (!source) {
-		Logger::Warning("String::Toi8 called with a null source string");
+		LOG_WARNING("String::Toi8 called with a null source string");
 		return MAX_I8;
 	}
 
-	int8_t i8_res = 0;
-	sscanf(source, "%hhi", &i8_res);
-
-	return i8_res;
+	return parse_number<int8_t>(source);
 }
 
 int16_t String::Toi16(const char* source) {
 	if (!source) {
-		Logger::Warning("String::Toi16 called with a null source string");
+		LOG_WARNING("String::Toi16 called with a null source string");
 		return MAX_I16;
 	}
 
-	int16_t i16_res = 0;
-	sscanf(source, "%hi", &i16_res);
-
-	return i16_res;
+	return parse_number<int16_t>(source);
 }
 
 int32_t String::Toi32(const char* source) {
 	if (!source) {
-		Logger::Warning("String::Toi32 called with a null source string");
+		LOG_WARNING("String::Toi32 called with a null source string");
 		return MAX_I32;
 	}
 
-	int32_t i32_res = 0;
-	sscanf(source, "%i", &i32_res);
-
-	return i32_res;
+	return parse_number<int32_t>(source);
 }
 
 int64_t String::Toi64(const char* source) {
 	if (!source) {
-		Logger::Warning("String::Toi64 called with a null source string");
+		LOG_WARNING("String::Toi64 called with a null source string");
 		return MAX_I64;
 	}
 
-	int64_t i64_res = 0;
-	sscanf(source, "%lli", &i64_res);
-
-	return i64_res;
+	return parse_number<int64_t>(source);
 }
 
 void String::Append(const String& string) {
-	uint64_t old_size = GetSize();
-	uint64_t new_size = GetSize() + string.GetSize();
-
-	m_Buffer.resize(new_size + 1);	
-	memcpy((m_Buffer.data() + old_size), string.CStr(), string.GetSize());
-	m_Buffer[new_size] = 0;
+	Append(string.CStr(), string.GetSize());
 }
 
 void String::Append(const char* string) {
-	uint64_t old_size = GetSize();
-	uint64_t new_size = GetSize() + strlen(string);
-
-	m_Buffer.resize(new_size + 1);	
-	memcpy((m_Buffer.data() + old_size), string, strlen(string));
-	m_Buffer[new_size] = 0;
+	Append(string, strlen(string));
 }
 
-void String::Append(float floatingPoint) {
-	char buffer[100]{};
-	snprintf(buffer, sizeof(buffer), "%f", floatingPoint);
-
-	uint64_t old_size = GetSize();
-	uint64_t new_size = GetSize() + strlen(buffer);
+void String::Append(const char* string, uint64_t stringSize) {
+	uint64_t oldSize = GetSize();
+	uint64_t newSize = oldSize + stringSize;
 
-	m_Buffer.resize(new_size + 1);	
-	memcpy((m_Buffer.data() + old_size), buffer, strlen(buffer));
-	m_Buffer[new_size] = 0;
-}
+	if (newSize > GetCapacity()) {
+		// string may point into our own buffer, keep it alive until it's copied.
+		const char* oldData = CStr();
+		bool aliased = string >= oldData && string < oldData + oldSize;
+		uint64_t offset = aliased ? string - oldData : 0;
 
-void String::Append(bool boolean) {
-	const char* buffer = boolean ? "true" : "false";
+		Grow(newSize);
 
-	uint64_t old_size = GetSize();
-	uint64_t new_size = GetSize() + strlen(buffer);
+		if (aliased) {
+			string = CStr() + offset;
+		}
+	}
 
-	m_Buffer.resize(new_size + 1);	
-	memcpy((m_Buffer.data() + old_size), buffer, strlen(buffer));
-	m_Buffer[new_size] = 0;
+	memmove(Data() + oldSize, string, stringSize);
+	SetSize(newSize);
 }
 
-void String::Append(char character) {
-	uint64_t old_size = GetSize();
-
-	m_Buffer.resize(GetSize() + 2);
-	
-	m_Buffer[old_size - 1] = character;
-	m_Buffer[old_size] = 0;
+void String::Append(float floatingPoint) {
+	AppendFormat("%f", floatingPoint);
 }
 
-String String::GetFileExtension() const {
-	// uint8_t header[18]{};
-	// list<uint8_t> image_bytes;
-	// static constexpr uint8_t DeCompressed[12] = {0x0, 0x0, 0x2, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0};
-    // static constexpr uint8_t IsCompressed[12] = {0x0, 0x0, 0xA, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0};
-
-	uint64_t stringSize = GetSize();
-
-	char* buffer = (char*)Platform::UAlloc(stringSize + 1);
-	uint64_t bufferSize = 0;
-
-	memset(buffer, 0, stringSize + 1);
-
-	bool found = false;
-
-	if (stringSize >= 2) {
-		for (uint64_t i = stringSize - 1; i >= 0; i--) {
-			buffer[bufferSize++] = m_Buffer[i];
-
-			if (m_Buffer[i] == '.' && (bufferSize > 1)) {
-				// found something.
-				found = true;
-				break;
-			}
-		}
+void String::Append(bool boolean) {
+	if (boolean) {
+		Append("true", 4);
 	} else {
-		Platform::UFree(buffer);
-		return "";
-	}
-
-	if (!found) {
-		Platform::UFree(buffer);
-		return "";
-	}
-
-	// buffer will be backwards, so reverse it.
-	char* reversedBuffer = (char*)Platform::UAlloc(bufferSize + 1);
-	uint64_t reversedBufferIndex = bufferSize;
-	
-	for (uint64_t i = 0; i < bufferSize; i++) {
-		reversedBuffer[reversedBufferIndex - i - 1] = buffer[i];
+		Append("false", 5);
 	}
+}
 
-	String formatString = reversedBuffer;
-
-	Platform::UFree(reversedBuffer);
-	Platform::UFree(buffer);
-
-	return formatString;
+void String::Append(char character) {
+	Append(&character, 1);
 }
 
 void String::Clear() {
-	m_Buffer.remove_all();
+	SetSize(0);
 }
\ No newline at end of file
@@ -1,24 +1,48 @@
 #pragma once
 
 #include "defines.h"
-#include "containers/list.h"
+#include "core/format.h"
+#include "core/string_view.h"
 
+#include <cstring>
 #include <DirectXMath.h>
 
+/*
+ * Null terminated string with small-string optimization: up to INLINE_CAPACITY characters
+ * live inside the object itself, only longer strings go to the heap.
+ * Inline, the last byte holds INLINE_CAPACITY - size, so it doubles as the terminator of a full buffer.
+ * On the heap, the top bit of the capacity (the same byte on little endian) marks the string as heap backed.
+ */
 class String {
 public:
+	static constexpr uint64_t INLINE_CAPACITY = 23;
+
 	String();
 	String(const char* string);
 	String(const char* string, uint64_t stringSize);
-
-	static String Format(const char* format, ...);  
+	explicit String(StringView view);
+	String(const String& other);
+	String(String&& other) noexcept;
+	~String();
+
+	String& operator=(const String& other);
+	String& operator=(String&& other) noexcept;
+	String& operator=(const char* string);
+
+	/* See Formatter for what the format accepts. The result is measured first and allocated once. */
+	template<typename... Args>
+	static String Format(const char* format, const Args&... args) {
+		String string;
+		string.AppendFormat(format, args...);
+		return string;
+	}
 
 	AINLINE uint64_t GetSize() const { 
-		if (m_Buffer.size() == 0) {
-			return 0;
-		} else {
-			return m_Buffer.size() - 1; 
-		}
+		return IsInline() ? INLINE_CAPACITY - (uint8_t)m_Inline[INLINE_CAPACITY] : m_Heap.size;
+	}
+
+	AINLINE uint64_t GetCapacity() const {
+		return IsInline() ? INLINE_CAPACITY : m_Heap.capacity & ~HEAP_FLAG;
 	}
 
 	static bool StringEqual(const char* string0, const char* string1);
@@ -33,27 +57,34 @@ public:
 	}
 
 	AINLINE friend bool operator==(const String& string0, const String& string1) {
-		return String::StringEqual(string0.CStr(), string1.CStr());
+		return string0.GetSize() == string1.GetSize() && memcmp(string0.CStr(), string1.CStr(), string0.GetSize()) == 0;
 	}
 
 	AINLINE friend bool operator!=(const String& string0, const String& string1) {
-		return String::StringNotEqual(string0.CStr(), string1.CStr());
+		return !(string0 == string1);
 	}
 
-	AINLINE String operator+(const String& string) {
-		Append(string);
-		return *this;
-	}
+	friend String operator+(const String& string0, const String& string1);
+	friend String operator+(const String& string0, const char* string1);
+	friend String operator+(const char* string0, const String& string1);
+
+	AINLINE String& operator+=(const String& string) { Append(string); return *this; }
+	AINLINE String& operator+=(const char* string) { Append(string); return *this; }
+	AINLINE String& operator+=(char character) { Append(character); return *this; }
 
 	AINLINE char operator[](uint64_t index) const {
-		return m_Buffer[index];
+		return CStr()[index];
 	}
 
 	AINLINE char& operator[](uint64_t index) {
-		return m_Buffer[index];
+		return Data()[index];
 	}
 
-	AINLINE const char* CStr() const { return m_Buffer.data(); }
+	/* Never null, an empty string gives "". */
+	AINLINE const char* CStr() const { return IsInline() ? m_Inline : m_Heap.data; }
+
+	AINLINE StringView View() const { return StringView(CStr(), GetSize()); }
+	AINLINE operator StringView() const { return View(); }
 
 	static DirectX::XMFLOAT4 ToFloat4(const char* source);
 	static DirectX::XMFLOAT3 ToFloat3(const char* source);
@@ -76,17 +107,55 @@ public:
 
 	void Append(const String& string);
 	void Append(const char* string);
+	void Append(const char* string, uint64_t stringSize);
+	AINLINE void Append(StringView view) { Append(view.Data(), view.GetSize()); }
 	void Append(float floatingPoint);
 	void Append(bool boolean);
 	void Append(char character);
 
-	/* if this is an file, will get the extension */
-	String GetFileExtension() const;
+	/* Formats straight into the spare capacity, growing to the exact size first when it doesn't fit. */
+	template<typename... Args>
+	AINLINE void AppendFormat(const char* format, const Args&... args) {
+		FormatArgs<Args...> formatArgs(args...);
+		AppendFormatArgs(format, formatArgs.list, FormatArgs<Args...>::COUNT);
+	}
+
+	void AppendFormatArgs(const char* format, const FormatArg* args, uint32_t argCount);
+
+	/* Makes room for capacity characters without counting the terminator. */
+	void Reserve(uint64_t capacity);
+
+	/* if this is an file, will get the extension (with the dot), empty if there is none. Points into this string. */
+	AINLINE StringView GetFileExtension() const { return View().GetFileExtension(); }
 
+	/* Keeps the capacity. */
 	void Clear();
 
-	AINLINE bool IsEmpty() const { return !m_Buffer.size(); }
+	AINLINE bool IsEmpty() const { return GetSize() == 0; }
 
 private:
-	list<char> m_Buffer;
-};
\ No newline at end of file
+	static constexpr uint64_t HEAP_FLAG = 1ull << 63;
+
+	struct HeapStorage {
+		char* data;
+		uint64_t size;
+		uint64_t capacity;
+	};
+
+	AINLINE bool IsInline() const { return (m_Inline[INLINE_CAPACITY] & 0x80) == 0; }
+	AINLINE char* Data() { return IsInline() ? m_Inline : m_Heap.data; }
+
+	void InitEmpty();
+	void Assign(const char* string, uint64_t stringSize);
+	/* Size must fit the current capacity, writes the terminator. */
+	void SetSize(uint64_t size);
+	void Grow(uint64_t minCapacity);
+	void FreeHeap();
+
+	union {
+		HeapStorage m_Heap;
+		char m_Inline[INLINE_CAPACITY + 1];
+	};
+};
+
+static_assert(sizeof(String) == String::INLINE_CAPACITY + 1, "String must stay three words big");
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "string_id.h"
+
+#include "allocator/linear_allocator.h"
+#include "core/logger.h"
+#include "platform/platform.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+/* Interned names are never freed, this only reserves address space. */
+static constexpr size_t INTERN_STRING_RESERVE = 64 * 1024 * 1024;
+static constexpr uint64_t INTERN_INITIAL_CAPACITY = 1024;
+
+struct InternEntry {
+	uint64_t hash;
+	uint64_t length;
+	char string[1];
+};
+
+/* One generation of the open addressing slot array. Old generations stay alive for readers still probing them. */
+struct InternSlots {
+	uint64_t capacity;
+	InternSlots* previous;
+	std::atomic<const InternEntry*> slots[1];
+
+	/* Rounded up to whole pages, VAlloc and VFree take page multiples. */
+	static size_t GetAllocationSize(uint64_t capacity) {
+		constexpr size_t pageSize = 4096;
+		size_t size = sizeof(InternSlots) + sizeof(std::atomic<const InternEntry*>) * (capacity - 1);
+		return (size + pageSize - 1) & ~(pageSize - 1);
+	}
+};
+
+/*
+ * Readers load the current slot array and probe it without locking: entries are published with a release
+ * store after they're fully written and never move or change afterwards. Writers serialize on a mutex,
+ * growing the table means publishing a new slot array, the old one is kept until shutdown.
+ */
+class InternTable {
+public:
+	InternTable()
+		:
+		m_Strings(INTERN_STRING_RESERVE) {
+		m_Slots.store(AllocateSlots(INTERN_INITIAL_CAPACITY, nullptr), std::memory_order_relaxed);
+	}
+
+	~InternTable() {
+		InternSlots* slots = m_Slots.load(std::memory_order_relaxed);
+		while (slots) {
+			InternSlots* previous = slots->previous;
+			Platform::VFree(slots, InternSlots::GetAllocationSize(slots->capacity));
+			slots = previous;
+		}
+	}
+
+	const InternEntry* Find(uint64_t hash) const {
+		const InternSlots* slots = m_Slots.load(std::memory_order_acquire);
+		uint64_t mask = slots->capacity - 1;
+
+		for (uint64_t index = hash & mask;; index = (index + 1) & mask) {
+			const InternEntry* entry = slots->slots[index].load(std::memory_order_acquire);
+			if (!entry || entry->hash == hash) {
+				return entry;
+			}
+		}
+	}
+
+	const InternEntry* Insert(uint64_t hash, StringView string) {
+		std::lock_guard<std::mutex> lock(m_WriteMutex);
+
+		// Another thread may have added it since the lock free lookup.
+		if (const InternEntry* entry = Find(hash)) {
+			return entry;
+		}
+
+		InternSlots* slots = m_Slots.load(std::memory_order_relaxed);
+		if ((m_Count + 1) * 4 > slots->capacity * 3) {
+			slots = Grow(slots);
+		}
+
+		InternEntry* entry = (InternEntry*)m_Strings.Allocate(offsetof(InternEntry, string) + string.GetSize() + 1, alignof(InternEntry));
+		if (!entry) {
+			return nullptr;
+		}
+
+		entry->hash = hash;
+		entry->length = string.GetSize();
+		memcpy(entry->string, string.Data(), string.GetSize());
+		entry->string[string.GetSize()] = 0;
+
+		Store(slots, entry);
+		m_Count++;
+
+		return entry;
+	}
+
+private:
+	static InternSlots* AllocateSlots(uint64_t capacity, InternSlots* previous) {
+		InternSlots* slots = (InternSlots*)Platform::VAlloc(InternSlots::GetAllocationSize(capacity));
+		assert(slots && "Out of memory for the StringId intern table");
+
+		slots->capacity = capacity;
+		slots->previous = previous;
+		for (uint64_t i = 0; i < capacity; i++) {
+			new (&slots->slots[i]) std::atomic<const InternEntry*>(nullptr);
+		}
+
+		return slots;
+	}
+
+	static void Store(InternSlots* slots, const InternEntry* entry) {
+		uint64_t mask = slots->capacity - 1;
+		uint64_t index = entry->hash & mask;
+
+		while (slots->slots[index].load(std::memory_order_relaxed)) {
+			index = (index + 1) & mask;
+		}
+
+		slots->slots[index].store(entry, std::memory_order_release);
+	}
+
+	InternSlots* Grow(InternSlots* slots) {
+		InternSlots* grown = AllocateSlots(slots->capacity * 2, slots);
+
+		for (uint64_t i = 0; i < slots->capacity; i++) {
+			if (const InternEntry* entry = slots->slots[i].load(std::memory_order_relaxed)) {
+				Store(grown, entry);
+			}
+		}
+
+		m_Slots.store(grown, std::memory_order_release);
+		return grown;
+	}
+
+private:
+	std::atomic<InternSlots*> m_Slots;
+	std::mutex m_WriteMutex;
+	LinearAllocator m_Strings;
+	uint64_t m_Count = 0;
+};
+
+static InternTable& get_intern_table() {
+	static InternTable table;
+	return table;
+}
+
+StringId StringId::Intern(StringView string) {
+	StringId id(string);
+	InternTable& table = get_intern_table();
+
+	const InternEntry* entry = table.Find(id.m_Hash);
+	if (!entry) {
+		entry = table.Insert(id.m_Hash, string);
+	}
+
+#ifdef DEBUG
+	if (entry && StringView(entry->string, entry->length) != string) {
+		LOG_FATAL("StringId collision: \"%s\" and \"%.*s\" both hash to %llx", entry->string, (int)string.GetSize(), string.Data(), (unsigned long long)id.m_Hash);
+		assert(false && "StringId hash collision");
+	}
+#endif
+
+	return id;
+}
+
+const char* StringId::GetString() const {
+	const InternEntry* entry = get_intern_table().Find(m_Hash);
+	return entry ? entry->string : nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "defines.h"
+#include "core/string_view.h"
+
+#include <cstddef>
+#include <cstdint>
+
+static inline constexpr uint64_t FNV1A_OFFSET_BASIS = 0xcbf29ce484222325ull;
+static inline constexpr uint64_t FNV1A_PRIME = 0x100000001b3ull;
+
+/* 64 bit FNV-1a, constexpr so names known at compile time cost nothing at runtime. */
+static constexpr uint64_t fnv1a_64(const char* data, uint64_t size) {
+	uint64_t hash = FNV1A_OFFSET_BASIS;
+	for (uint64_t i = 0; i < size; i++) {
+		hash ^= (uint8_t)data[i];
+		hash *= FNV1A_PRIME;
+	}
+	return hash;
+}
+
+/*
+ * A name reduced to its 64 bit hash, comparing two ids is a single integer compare.
+ * Literals are hashed at compile time: StringId("albedo") or "albedo"_sid.
+ * Runtime strings go through Intern, which also records them in a global table
+ * so GetString can turn an id back into its name for logs and debugging.
+ */
+class RAPI StringId {
+public:
+	constexpr StringId() = default;
+
+	/* Stops at the first null, so fixed size char buffers (e.g. VkLayerProperties::layerName) hash their contents only. */
+	template<size_t N>
+	constexpr StringId(const char (&literal)[N]) : m_Hash(fnv1a_64(literal, LiteralLength(literal, N))) {}
+
+	/* Hashes without recording the string, GetString won't find it unless it's interned somewhere else. */
+	explicit StringId(StringView string) : m_Hash(fnv1a_64(string.Data(), string.GetSize())) {}
+
+	static constexpr StringId FromHash(uint64_t hash) { StringId id; id.m_Hash = hash; return id; }
+
+	/* Hashes string and records it. Safe to call from any thread, lookups of known strings never lock. */
+	static StringId Intern(StringView string);
+
+	/* The interned name, or nullptr if this id never went through Intern. */
+	const char* GetString() const;
+
+	constexpr uint64_t GetHash() const { return m_Hash; }
+	constexpr bool IsValid() const { return m_Hash != 0; }
+
+	friend constexpr bool operator==(StringId id0, StringId id1) { return id0.m_Hash == id1.m_Hash; }
+	friend constexpr bool operator!=(StringId id0, StringId id1) { return id0.m_Hash != id1.m_Hash; }
+	friend constexpr bool operator<(StringId id0, StringId id1) { return id0.m_Hash < id1.m_Hash; }
+
+private:
+	template<size_t N>
+	static constexpr uint64_t LiteralLength(const char (&literal)[N], size_t size) {
+		uint64_t length = 0;
+		while (length < size && literal[length] != 0) {
+			length++;
+		}
+		return length;
+	}
+
+private:
+	uint64_t m_Hash = 0;
+};
+
+constexpr StringId operator""_sid(const char* string, size_t size) {
+	return StringId::FromHash(fnv1a_64(string, size));
+}
\ No newline at end of file
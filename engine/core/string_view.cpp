@@ -0,0 +1,160 @@
+#include "string_view.h"
+
+static AINLINE bool is_path_separator(char character) {
+	return character == '/' || character == '\\';
+}
+
+static AINLINE char to_lower_ascii(char character) {
+	return character >= 'A' && character <= 'Z' ? character - 'A' + 'a' : character;
+}
+
+uint64_t StringView::Find(char character, uint64_t offset) const {
+	if (offset >= m_Size) {
+		return NOT_FOUND;
+	}
+
+	const char* found = (const char*)memchr(m_Data + offset, character, m_Size - offset);
+	return found ? (uint64_t)(found - m_Data) : NOT_FOUND;
+}
+
+uint64_t StringView::Find(StringView string, uint64_t offset) const {
+	if (string.m_Size == 0) {
+		return offset <= m_Size ? offset : NOT_FOUND;
+	}
+
+	while (offset + string.m_Size <= m_Size) {
+		uint64_t candidate = Find(string.m_Data[0], offset);
+		if (candidate == NOT_FOUND || candidate + string.m_Size > m_Size) {
+			return NOT_FOUND;
+		}
+
+		if (memcmp(m_Data + candidate, string.m_Data, string.m_Size) == 0) {
+			return candidate;
+		}
+
+		offset = candidate + 1;
+	}
+
+	return NOT_FOUND;
+}
+
+uint64_t StringView::FindLast(char character) const {
+	for (uint64_t i = m_Size; i > 0; i--) {
+		if (m_Data[i - 1] == character) {
+			return i - 1;
+		}
+	}
+	return NOT_FOUND;
+}
+
+uint64_t StringView::FindLastOf(StringView characters) const {
+	for (uint64_t i = m_Size; i > 0; i--) {
+		if (characters.Contains(m_Data[i - 1])) {
+			return i - 1;
+		}
+	}
+	return NOT_FOUND;
+}
+
+bool StringView::EqualsI(StringView other) const {
+	if (m_Size != other.m_Size) {
+		return false;
+	}
+
+	for (uint64_t i = 0; i < m_Size; i++) {
+		if (to_lower_ascii(m_Data[i]) != to_lower_ascii(other.m_Data[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+StringView StringView::TrimStart() const {
+	uint64_t start = 0;
+	while (start < m_Size && IsWhitespace(m_Data[start])) {
+		start++;
+	}
+	return StringView(m_Data + start, m_Size - start);
+}
+
+StringView StringView::TrimEnd() const {
+	uint64_t size = m_Size;
+	while (size > 0 && IsWhitespace(m_Data[size - 1])) {
+		size--;
+	}
+	return StringView(m_Data, size);
+}
+
+StringView StringView::GetFileExtension() const {
+	StringView fileName = GetFileName();
+	uint64_t dot = fileName.FindLast('.');
+
+	// Neither a trailing dot nor the leading dot of ".bashrc" starts an extension.
+	if (dot == NOT_FOUND || dot == 0 || dot + 1 == fileName.m_Size) {
+		return StringView();
+	}
+
+	return fileName.Substring(dot);
+}
+
+StringView StringView::GetFileName() const {
+	uint64_t separator = FindLastOf("/\\");
+	return separator == NOT_FOUND ? *this : Substring(separator + 1);
+}
+
+StringView StringView::GetFileStem() const {
+	StringView fileName = GetFileName();
+	StringView extension = fileName.GetFileExtension();
+	return fileName.First(fileName.m_Size - extension.m_Size);
+}
+
+StringView StringView::GetDirectory() const {
+	uint64_t separator = FindLastOf("/\\");
+	if (separator == NOT_FOUND) {
+		return StringView();
+	}
+
+	// Keep the root separator of absolute paths, "/file" -> "/".
+	StringView directory = First(separator);
+	while (directory.m_Size > 1 && is_path_separator(directory.m_Data[directory.m_Size - 1])) {
+		directory.m_Size--;
+	}
+
+	return directory.IsEmpty() ? First(1) : directory;
+}
+
+bool StringView::NextToken(char delimiter, StringView& token) {
+	if (IsEmpty()) {
+		return false;
+	}
+
+	uint64_t end = Find(delimiter);
+	if (end == NOT_FOUND) {
+		token = *this;
+		*this = Substring(m_Size);
+	} else {
+		token = First(end);
+		*this = Substring(end + 1);
+	}
+
+	return true;
+}
+
+bool StringView::NextToken(StringView& token) {
+	StringView rest = TrimStart();
+	if (rest.IsEmpty()) {
+		*this = rest;
+		return false;
+	}
+
+	uint64_t end = 0;
+	while (end < rest.m_Size && !IsWhitespace(rest.m_Data[end])) {
+		end++;
+	}
+
+	token = rest.First(end);
+	*this = rest.Substring(end);
+
+	return true;
+}
\ No newline at end of file
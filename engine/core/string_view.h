@@ -0,0 +1,97 @@
+#pragma once
+
+#include "defines.h"
+
+#include <cassert>
+#include <cstring>
+
+/*
+ * Non-owning slice of characters, not necessarily null terminated.
+ * Whatever it points to (a String, a literal, a mapped file) must outlive it.
+ * Every helper returns another slice of the same memory, nothing here allocates.
+ */
+class RAPI StringView {
+public:
+	static constexpr uint64_t NOT_FOUND = ~0ull;
+
+	constexpr StringView() = default;
+	constexpr StringView(const char* data, uint64_t size) : m_Data(data), m_Size(size) {}
+	StringView(const char* string) : m_Data(string ? string : ""), m_Size(string ? strlen(string) : 0) {}
+
+	AINLINE const char* Data() const { return m_Data; }
+	AINLINE uint64_t GetSize() const { return m_Size; }
+	AINLINE bool IsEmpty() const { return m_Size == 0; }
+
+	AINLINE char operator[](uint64_t index) const {
+		assert(index < m_Size);
+		return m_Data[index];
+	}
+
+	AINLINE const char* begin() const { return m_Data; }
+	AINLINE const char* end() const { return m_Data + m_Size; }
+
+	/* count is clamped to what's left after offset. */
+	AINLINE StringView Substring(uint64_t offset, uint64_t count = NOT_FOUND) const {
+		if (offset > m_Size) {
+			offset = m_Size;
+		}
+		uint64_t left = m_Size - offset;
+		return StringView(m_Data + offset, count < left ? count : left);
+	}
+
+	AINLINE StringView First(uint64_t count) const { return Substring(0, count); }
+	AINLINE StringView Last(uint64_t count) const { return count < m_Size ? Substring(m_Size - count) : *this; }
+
+	uint64_t Find(char character, uint64_t offset = 0) const;
+	uint64_t Find(StringView string, uint64_t offset = 0) const;
+	uint64_t FindLast(char character) const;
+	/* Last occurrence of any character in characters. */
+	uint64_t FindLastOf(StringView characters) const;
+
+	AINLINE bool Contains(char character) const { return Find(character) != NOT_FOUND; }
+	AINLINE bool StartsWith(StringView prefix) const { return m_Size >= prefix.m_Size && memcmp(m_Data, prefix.m_Data, prefix.m_Size) == 0; }
+	AINLINE bool EndsWith(StringView suffix) const { return m_Size >= suffix.m_Size && memcmp(m_Data + m_Size - suffix.m_Size, suffix.m_Data, suffix.m_Size) == 0; }
+
+	/* ASCII case insensitive. */
+	bool EqualsI(StringView other) const;
+
+	AINLINE friend bool operator==(StringView view0, StringView view1) {
+		return view0.m_Size == view1.m_Size && (view0.m_Size == 0 || memcmp(view0.m_Data, view1.m_Data, view0.m_Size) == 0);
+	}
+
+	AINLINE friend bool operator!=(StringView view0, StringView view1) {
+		return !(view0 == view1);
+	}
+
+	static AINLINE bool IsWhitespace(char character) {
+		return character == ' ' || character == '\t' || character == '\n' || character == '\r' || character == '\v' || character == '\f';
+	}
+
+	StringView TrimStart() const;
+	StringView TrimEnd() const;
+	AINLINE StringView Trim() const { return TrimStart().TrimEnd(); }
+
+	/* Path helpers, both '/' and '\\' separate directories. */
+
+	/* "dir/file.tga" -> ".tga", empty if there is no extension. */
+	StringView GetFileExtension() const;
+	/* "dir/file.tga" -> "file.tga" */
+	StringView GetFileName() const;
+	/* "dir/file.tga" -> "file" */
+	StringView GetFileStem() const;
+	/* "dir/file.tga" -> "dir", empty if there is no directory. */
+	StringView GetDirectory() const;
+
+	/*
+	 * Splits off everything before the first delimiter and advances past it.
+	 * Returns false once nothing is left. Empty fields are kept, so "a,,b" gives "a", "", "b",
+	 * but a trailing delimiter doesn't add an empty last field.
+	 */
+	bool NextToken(char delimiter, StringView& token);
+	/* Same, but tokens are separated by runs of whitespace and are never empty. */
+	bool NextToken(StringView& token);
+
+private:
+	const char* m_Data = "";
+	uint64_t m_Size = 0;
+};
\ No newline at end of file
@@ -4,16 +4,23 @@
 
 typedef void* HANDLE;
 static inline constexpr unsigned int INVALID_ID = 0xffffffff;
+static inline constexpr uint64_t MINIMUM_ALIGNMENT_SIZE = 16;
+/* Used to keep data written by different threads on separate cache lines. */
+static inline constexpr uint64_t CACHE_LINE_SIZE = 64;
 
 #if defined(__GNUC__)
 #define string_cmpi_length(str0, str1, length) (strncasecmp(str0, str1, length) == 0);
 #define string_cmpi(str0, str1) (strcasecmp(str0, str1) == 0);
 #define string_append_string(dest, source, append)
 #define AINLINE __attribute__((always_inline))
+#define FUNCTION_SIGNATURE __PRETTY_FUNCTION__
+#define NOINLINE __attribute__((noinline))
 #elif defined(_MSC_VER)
 #define string_cmpi_length(str0, str1, length) (_strnicmp(str0, str1, length) == 0);
 #define string_cmpi(str0, str1) (_strcmpi(str0, str1) == 0);
 #define AINLINE __force_inline
+#define FUNCTION_SIGNATURE __FUNCSIG__
+#define NOINLINE __declspec(noinline)
 #endif
 
 static constexpr inline double MAX_DOUBLE = 1.7976931348623157e+308;
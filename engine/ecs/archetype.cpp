@@ -0,0 +1,137 @@
+#include "archetype.h"
+
+#include "platform/platform.h"
+
+#include <cstring>
+
+static constexpr size_t COLUMN_ALIGNMENT = CACHE_LINE_SIZE;
+
+static AINLINE size_t align_up(size_t value, size_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/* Lays the columns out for capacity entities and returns the bytes used. */
+static size_t layout_columns(ArchetypeColumn* columns, uint32_t columnCount, uint32_t capacity) {
+	size_t offset = sizeof(Entity) * capacity;
+
+	for (uint32_t i = 0; i < columnCount; i++) {
+		size_t alignment = columns[i].alignment > COLUMN_ALIGNMENT ? columns[i].alignment : COLUMN_ALIGNMENT;
+		offset = align_up(offset, alignment);
+		columns[i].offset = (uint32_t)offset;
+		offset += (size_t)columns[i].size * capacity;
+	}
+
+	return offset;
+}
+
+ChunkAllocator::~ChunkAllocator() {
+	for (uint8_t* block : m_Blocks) {
+		Platform::VFree(block, ARCHETYPE_CHUNK_SIZE * CHUNKS_PER_BLOCK);
+	}
+}
+
+uint8_t* ChunkAllocator::Allocate() {
+	if (m_FreeChunks.is_empty()) {
+		uint8_t* block = (uint8_t*)Platform::VAlloc(ARCHETYPE_CHUNK_SIZE * CHUNKS_PER_BLOCK);
+		if (!block) {
+			return nullptr;
+		}
+
+		m_Blocks.push_back(block);
+		m_FreeChunks.reserve(m_FreeChunks.size() + CHUNKS_PER_BLOCK);
+
+		// Pushed backwards so chunks are handed out in address order.
+		for (size_t i = CHUNKS_PER_BLOCK; i > 0; i--) {
+			m_FreeChunks.push_back(block + (i - 1) * ARCHETYPE_CHUNK_SIZE);
+		}
+	}
+
+	uint8_t* chunk = m_FreeChunks[m_FreeChunks.size() - 1];
+	m_FreeChunks.remove_last();
+
+	return chunk;
+}
+
+void ChunkAllocator::Free(uint8_t* chunk) {
+	m_FreeChunks.push_back(chunk);
+}
+
+Archetype::Archetype(const ComponentMask& mask, const ArchetypeColumn* columns, uint32_t columnCount, ChunkAllocator& allocator)
+	:
+	m_Mask(mask),
+	m_Allocator(allocator) {
+	m_Columns.resize(columnCount);
+	for (uint32_t i = 0; i < columnCount; i++) {
+		m_Columns[i] = columns[i];
+	}
+
+	size_t rowSize = sizeof(Entity);
+	for (uint32_t i = 0; i < columnCount; i++) {
+		rowSize += columns[i].size;
+	}
+
+	// Start from the capacity without padding and back off until the aligned layout fits.
+	uint32_t capacity = (uint32_t)(ARCHETYPE_CHUNK_SIZE / rowSize);
+	while (capacity > 0 && layout_columns(m_Columns.data(), columnCount, capacity) > ARCHETYPE_CHUNK_SIZE) {
+		capacity--;
+	}
+
+	assert(capacity > 0 && "Components are too big to fit a single entity in an archetype chunk");
+	m_ChunkCapacity = capacity;
+}
+
+Archetype::~Archetype() {
+	for (uint8_t* chunk : m_Chunks) {
+		m_Allocator.Free(chunk);
+	}
+}
+
+int32_t Archetype::FindColumn(uint32_t componentId) const {
+	for (uint32_t i = 0; i < m_Columns.size_u32(); i++) {
+		if (m_Columns[i].componentId == componentId) {
+			return (int32_t)i;
+		}
+	}
+	return -1;
+}
+
+uint32_t Archetype::AddRow(Entity entity) {
+	uint32_t row = m_EntityCount;
+	uint32_t chunk = row / m_ChunkCapacity;
+
+	if (chunk == m_Chunks.size()) {
+		m_Chunks.push_back(m_Allocator.Allocate());
+	}
+
+	GetEntities(chunk)[row % m_ChunkCapacity] = entity;
+	m_EntityCount++;
+
+	return row;
+}
+
+Entity Archetype::RemoveRow(uint32_t row) {
+	assert(row < m_EntityCount);
+
+	uint32_t last = m_EntityCount - 1;
+	Entity moved;
+
+	if (row != last) {
+		moved = GetEntity(last);
+		GetEntities(row / m_ChunkCapacity)[row % m_ChunkCapacity] = moved;
+
+		for (uint32_t column = 0; column < m_Columns.size_u32(); column++) {
+			memcpy(GetComponent(row, column), GetComponent(last, column), m_Columns[column].size);
+		}
+	}
+
+	m_EntityCount--;
+
+	// Keep one spare chunk around so an entity bouncing across a chunk boundary doesn't churn chunks.
+	uint32_t usedChunks = GetChunkCount();
+	while (m_Chunks.size() > usedChunks + 1) {
+		m_Allocator.Free(m_Chunks[m_Chunks.size() - 1]);
+		m_Chunks.remove_last();
+	}
+
+	return moved;
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "defines.h"
+#include "containers/hash_table.h"
+#include "containers/list.h"
+#include "ecs/entity.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+static inline constexpr size_t ARCHETYPE_CHUNK_SIZE = 16 * 1024;
+static inline constexpr uint32_t MAX_ARCHETYPE_COMPONENT_TYPES = 128;
+
+/* Set of component type ids, identifies an archetype. */
+struct ComponentMask {
+	uint64_t bits[MAX_ARCHETYPE_COMPONENT_TYPES / 64] = {};
+
+	AINLINE void Set(uint32_t id) {
+		assert(id < MAX_ARCHETYPE_COMPONENT_TYPES && "Too many component types for archetype storage");
+		bits[id / 64] |= 1ull << (id % 64);
+	}
+
+	AINLINE void Clear(uint32_t id) { bits[id / 64] &= ~(1ull << (id % 64)); }
+	AINLINE bool Has(uint32_t id) const { return id < MAX_ARCHETYPE_COMPONENT_TYPES && (bits[id / 64] & (1ull << (id % 64))) != 0; }
+
+	/* True if every component in other is also in this mask. */
+	AINLINE bool Contains(const ComponentMask& other) const {
+		for (size_t i = 0; i < MAX_ARCHETYPE_COMPONENT_TYPES / 64; i++) {
+			if ((bits[i] & other.bits[i]) != other.bits[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	friend bool operator==(const ComponentMask& a, const ComponentMask& b) { return memcmp(a.bits, b.bits, sizeof(a.bits)) == 0; }
+	friend bool operator!=(const ComponentMask& a, const ComponentMask& b) { return !(a == b); }
+};
+
+struct ComponentMaskHasher {
+	AINLINE uint64_t operator()(const ComponentMask& mask) const { return hash_bytes(mask.bits, sizeof(mask.bits)); }
+};
+
+/* One component array inside a chunk. offset is relative to the start of the chunk. */
+struct ArchetypeColumn {
+	uint32_t componentId;
+	uint32_t size;
+	uint32_t alignment;
+	uint32_t offset;
+};
+
+/*
+ * Hands out page aligned ARCHETYPE_CHUNK_SIZE blocks. Chunks are carved from bigger blocks
+ * taken from the OS and recycled through a free list, they're only returned when the allocator dies.
+ */
+class ChunkAllocator {
+public:
+	ChunkAllocator() = default;
+	ChunkAllocator(const ChunkAllocator&) = delete;
+	ChunkAllocator& operator=(const ChunkAllocator&) = delete;
+	~ChunkAllocator();
+
+	uint8_t* Allocate();
+	void Free(uint8_t* chunk);
+
+private:
+	static constexpr size_t CHUNKS_PER_BLOCK = 64;
+
+	list<uint8_t*> m_Blocks;
+	list<uint8_t*> m_FreeChunks;
+};
+
+/*
+ * Every entity with exactly the same set of components. Entities are packed in fixed size chunks,
+ * each chunk stores the entity ids followed by one array per component (structure of arrays),
+ * every array starting on its own cache line. Rows are kept dense across chunks:
+ * removing a row moves the archetype's last row into the hole.
+ * Components are moved with memcpy, so they must be trivially copyable.
+ */
+class Archetype {
+public:
+	/* columns must be sorted by componentId, their offsets are filled in here. */
+	Archetype(const ComponentMask& mask, const ArchetypeColumn* columns, uint32_t columnCount, ChunkAllocator& allocator);
+	Archetype(const Archetype&) = delete;
+	Archetype& operator=(const Archetype&) = delete;
+	~Archetype();
+
+	AINLINE const ComponentMask& GetMask() const { return m_Mask; }
+	AINLINE uint32_t GetEntityCount() const { return m_EntityCount; }
+	AINLINE uint32_t GetChunkCapacity() const { return m_ChunkCapacity; }
+	/* Chunks that hold at least one entity. */
+	AINLINE uint32_t GetChunkCount() const { return (m_EntityCount + m_ChunkCapacity - 1) / m_ChunkCapacity; }
+
+	AINLINE uint32_t GetChunkEntityCount(uint32_t chunk) const {
+		uint32_t first = chunk * m_ChunkCapacity;
+		return m_EntityCount - first < m_ChunkCapacity ? m_EntityCount - first : m_ChunkCapacity;
+	}
+
+	AINLINE uint32_t GetColumnCount() const { return m_Columns.size_u32(); }
+	AINLINE const ArchetypeColumn& GetColumn(uint32_t column) const { return m_Columns[column]; }
+	/* Returns -1 if the archetype doesn't have the component. */
+	int32_t FindColumn(uint32_t componentId) const;
+
+	AINLINE Entity* GetEntities(uint32_t chunk) { return (Entity*)m_Chunks[chunk]; }
+	AINLINE void* GetColumnData(uint32_t chunk, uint32_t column) { return m_Chunks[chunk] + m_Columns[column].offset; }
+
+	AINLINE Entity GetEntity(uint32_t row) { return GetEntities(row / m_ChunkCapacity)[row % m_ChunkCapacity]; }
+	AINLINE void* GetComponent(uint32_t row, uint32_t column) {
+		return (uint8_t*)GetColumnData(row / m_ChunkCapacity, column) + (size_t)(row % m_ChunkCapacity) * m_Columns[column].size;
+	}
+
+	/* Appends a row for entity and returns it, the components are left uninitialized. */
+	uint32_t AddRow(Entity entity);
+	/* Moves the last row into row. Returns the entity that moved, or an invalid entity if row was the last one. */
+	Entity RemoveRow(uint32_t row);
+
+private:
+	ComponentMask m_Mask;
+	list<ArchetypeColumn> m_Columns;
+	list<uint8_t*> m_Chunks;
+	ChunkAllocator& m_Allocator;
+	uint32_t m_ChunkCapacity = 0;
+	uint32_t m_EntityCount = 0;
+};
\ No newline at end of file
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "defines.h"
+#include "containers/list.h"
+#include "core/job_system.h"
+#include "ecs/archetype.h"
+#include "ecs/component_type.h"
+#include "ecs/entity.h"
+#include "platform/platform.h"
+
+#include <cassert>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+/* The entities of one chunk and their Ts arrays, all indexed by the same row. */
+template<typename... Ts>
+class ChunkView {
+public:
+	ChunkView(const Entity* entities, uint32_t count, Ts*... columns)
+		:
+		m_Entities(entities),
+		m_Count(count),
+		m_Columns(columns...)
+	{}
+
+	AINLINE uint32_t GetCount() const { return m_Count; }
+	AINLINE const Entity* GetEntities() const { return m_Entities; }
+
+	template<typename T>
+	AINLINE T* Get() const { return std::get<T*>(m_Columns); }
+
+private:
+	const Entity* m_Entities;
+	uint32_t m_Count;
+	std::tuple<Ts*...> m_Columns;
+};
+
+/*
+ * Chunks of every archetype that has all of Ts, gathered when the query is made.
+ * Chunks never share rows, so they can be processed independently of each other.
+ * Creating or destroying entities, or adding and removing components, invalidates the query.
+ * The chunk list comes from the frame allocator, so queries are made on the main thread and live at most until the end of the next frame.
+ */
+template<typename... Ts>
+class ArchetypeQuery {
+	static_assert(sizeof...(Ts) > 0, "A query needs at least one component type");
+
+	struct ChunkRef {
+		Archetype* archetype;
+		uint32_t chunk;
+		uint32_t columns[sizeof...(Ts)];
+	};
+
+public:
+	ArchetypeQuery(const list<Archetype*>& archetypes) {
+		ComponentMask mask;
+		uint32_t ids[] = { ComponentTypeId::Get<Ts>()... };
+		for (uint32_t id : ids) {
+			mask.Set(id);
+		}
+
+		uint32_t chunkCount = 0;
+		for (Archetype* archetype : archetypes) {
+			if (archetype->GetEntityCount() != 0 && archetype->GetMask().Contains(mask)) {
+				chunkCount += archetype->GetChunkCount();
+			}
+		}
+
+		m_Chunks = Platform::GetFrameAllocator().AllocateArray<ChunkRef>(chunkCount);
+		assert((m_Chunks || chunkCount == 0) && "Frame allocator is out of memory");
+
+		for (Archetype* archetype : archetypes) {
+			if (archetype->GetEntityCount() == 0 || !archetype->GetMask().Contains(mask)) {
+				continue;
+			}
+
+			ChunkRef ref;
+			ref.archetype = archetype;
+			for (size_t i = 0; i < sizeof...(Ts); i++) {
+				ref.columns[i] = (uint32_t)archetype->FindColumn(ids[i]);
+			}
+
+			for (uint32_t chunk = 0; chunk < archetype->GetChunkCount(); chunk++) {
+				ref.chunk = chunk;
+				m_Chunks[m_ChunkCount++] = ref;
+			}
+
+			m_EntityCount += archetype->GetEntityCount();
+		}
+	}
+
+	AINLINE uint32_t GetChunkCount() const { return m_ChunkCount; }
+	AINLINE size_t GetEntityCount() const { return m_EntityCount; }
+
+	ChunkView<Ts...> GetChunk(uint32_t index) const {
+		return MakeView(m_Chunks[index], std::index_sequence_for<Ts...>());
+	}
+
+	/* Calls function(ChunkView<Ts...>&) for every chunk. */
+	template<typename Function>
+	void ForEachChunk(Function&& function) const {
+		for (uint32_t i = 0; i < m_ChunkCount; i++) {
+			ChunkView<Ts...> view = GetChunk(i);
+			function(view);
+		}
+	}
+
+	/* Calls function(Entity, Ts&...) for every entity. */
+	template<typename Function>
+	void Each(Function&& function) const {
+		ForEachChunk([&function](ChunkView<Ts...>& view) {
+			EachInChunk(view, function);
+		});
+	}
+
+	/*
+	 * ForEachChunk with the chunks spread over the job system's workers, one chunk per batch.
+	 * function is called from several threads at once and returns before this does.
+	 */
+	template<typename Function>
+	void ParallelForEachChunk(Function&& function) const {
+		JobSystem::ParallelFor(m_ChunkCount, 1, [this, &function](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; i++) {
+				ChunkView<Ts...> view = GetChunk(i);
+				function(view);
+			}
+		});
+	}
+
+	/* Each with the chunks spread over the job system's workers. */
+	template<typename Function>
+	void ParallelEach(Function&& function) const {
+		ParallelForEachChunk([&function](ChunkView<Ts...>& view) {
+			EachInChunk(view, function);
+		});
+	}
+
+private:
+	template<typename Function>
+	static AINLINE void EachInChunk(ChunkView<Ts...>& view, Function& function) {
+		const Entity* entities = view.GetEntities();
+		std::tuple<Ts*...> columns(view.template Get<Ts>()...);
+
+		for (uint32_t row = 0; row < view.GetCount(); row++) {
+			function(entities[row], std::get<Ts*>(columns)[row]...);
+		}
+	}
+
+	template<size_t... Indices>
+	static ChunkView<Ts...> MakeView(const ChunkRef& ref, std::index_sequence<Indices...>) {
+		return ChunkView<Ts...>(
+			ref.archetype->GetEntities(ref.chunk),
+			ref.archetype->GetChunkEntityCount(ref.chunk),
+			(Ts*)ref.archetype->GetColumnData(ref.chunk, ref.columns[Indices])...);
+	}
+
+private:
+	ChunkRef* m_Chunks = nullptr;
+	uint32_t m_ChunkCount = 0;
+	size_t m_EntityCount = 0;
+};
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "defines.h"
+#include "containers/list.h"
+#include "ecs/entity.h"
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+/*
+ * Sparse set keyed by entity index. The sparse array maps an entity index to a slot in the
+ * dense arrays, which hold the entities and their components packed with no holes.
+ * Removing swaps the last element into the hole.
+ */
+class IComponentPool {
+public:
+	virtual ~IComponentPool() = default;
+
+	/* Does nothing if the entity doesn't have the component. */
+	virtual void Remove(Entity entity) = 0;
+
+	AINLINE bool Contains(Entity entity) const {
+		return entity.index < m_Sparse.size() && m_Sparse[entity.index] != INVALID_ID && m_Entities[m_Sparse[entity.index]] == entity;
+	}
+
+	AINLINE size_t GetSize() const { return m_Entities.size(); }
+	AINLINE const Entity* GetEntities() const { return m_Entities.data(); }
+
+protected:
+	/* Returns the dense slot the new component goes to. */
+	uint32_t Insert(Entity entity) {
+		if (entity.index >= m_Sparse.size()) {
+			size_t oldSize = m_Sparse.size();
+			m_Sparse.resize(entity.index + 1);
+			for (size_t i = oldSize; i < m_Sparse.size(); i++) {
+				m_Sparse[i] = INVALID_ID;
+			}
+		}
+
+		uint32_t slot = m_Entities.size_u32();
+		m_Sparse[entity.index] = slot;
+		m_Entities.push_back(entity);
+
+		return slot;
+	}
+
+	/* Moves the last entity into slot, the caller does the same for its components. */
+	void Erase(Entity entity, uint32_t slot) {
+		uint32_t last = m_Entities.size_u32() - 1;
+
+		if (slot != last) {
+			Entity moved = m_Entities[last];
+			m_Entities[slot] = moved;
+			m_Sparse[moved.index] = slot;
+		}
+
+		m_Entities.remove_last();
+		m_Sparse[entity.index] = INVALID_ID;
+	}
+
+	AINLINE uint32_t GetSlot(Entity entity) const { return m_Sparse[entity.index]; }
+
+protected:
+	list<uint32_t> m_Sparse;
+	list<Entity> m_Entities;
+};
+
+template<typename T>
+class ComponentPool : public IComponentPool {
+public:
+	/* The entity must not have the component yet. */
+	template<typename... Args>
+	T& Add(Entity entity, Args&&... args) {
+		assert(!Contains(entity) && "Entity already has this component");
+		Insert(entity);
+		return m_Components.emplace_back(std::forward<Args>(args)...);
+	}
+
+	virtual void Remove(Entity entity) override {
+		if (!Contains(entity)) {
+			return;
+		}
+
+		uint32_t slot = GetSlot(entity);
+		uint32_t last = m_Components.size_u32() - 1;
+
+		if (slot != last) {
+			m_Components[slot] = std::move(m_Components[last]);
+		}
+		m_Components.remove_last();
+
+		Erase(entity, slot);
+	}
+
+	/* Returns nullptr if the entity doesn't have the component. */
+	AINLINE T* Get(Entity entity) {
+		return Contains(entity) ? &m_Components[GetSlot(entity)] : nullptr;
+	}
+
+	/* Same order as GetEntities. */
+	AINLINE T* GetComponents() { return m_Components.data(); }
+
+private:
+	list<T> m_Components;
+};
\ No newline at end of file
@@ -0,0 +1,22 @@
+#include "component_type.h"
+
+#include "containers/list.h"
+
+#include <mutex>
+
+static std::mutex s_TypeMutex;
+/* Indexed by id. */
+static list<uint64_t> s_TypeHashes;
+
+uint32_t ComponentTypeId::Register(uint64_t typeHash) {
+	std::lock_guard<std::mutex> lock(s_TypeMutex);
+
+	for (uint32_t id = 0; id < s_TypeHashes.size_u32(); id++) {
+		if (s_TypeHashes[id] == typeHash) {
+			return id;
+		}
+	}
+
+	s_TypeHashes.push_back(typeHash);
+	return s_TypeHashes.size_u32() - 1;
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "defines.h"
+#include "core/string_id.h"
+
+#include <cstdint>
+
+template<typename T>
+uint64_t get_component_type_hash() {
+	return fnv1a_64(FUNCTION_SIGNATURE, sizeof(FUNCTION_SIGNATURE) - 1);
+}
+
+/*
+ * Hands out a small sequential id per component type, shared by Registry and World. Ids are keyed by a hash of the
+ * type's name and handed out by the engine, so the game module and the engine agree on them.
+ */
+class RAPI ComponentTypeId {
+public:
+	template<typename T>
+	static uint32_t Get() {
+		static const uint32_t id = Register(get_component_type_hash<T>());
+		return id;
+	}
+
+private:
+	static uint32_t Register(uint64_t typeHash);
+};
\ No newline at end of file
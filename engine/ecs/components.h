@@ -0,0 +1,24 @@
+#pragma once
+
+#include "defines.h"
+#include "containers/handle_pool.h"
+#include "renderer/renderer_types.inl"
+
+#include <DirectXMath.h>
+
+struct TransformComponent {
+	DirectX::XMFLOAT3 position = { 0.0f, 0.0f, 0.0f };
+	/* Pitch, yaw and roll in radians. */
+	DirectX::XMFLOAT3 rotation = { 0.0f, 0.0f, 0.0f };
+	DirectX::XMFLOAT3 scale = { 1.0f, 1.0f, 1.0f };
+};
+
+/* Model matrix built from TransformComponent every frame. */
+struct WorldMatrixComponent {
+	DirectX::XMFLOAT4X4 world;
+};
+
+/* Links an entity to the render item the renderer draws for it. */
+struct RenderItemComponent {
+	Handle<RenderItem> renderItem;
+};
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "defines.h"
+
+#include <cstdint>
+
+/*
+ * An entity is only an id, its data lives in the registry's component pools.
+ * The generation is bumped every time the index is recycled, so an id kept
+ * after DestroyEntity never refers to the entity that reused its index.
+ */
+struct Entity {
+	uint32_t index = INVALID_ID;
+	uint32_t generation = 0;
+
+	AINLINE bool IsValid() const { return index != INVALID_ID; }
+
+	friend bool operator==(const Entity& a, const Entity& b) { return a.index == b.index && a.generation == b.generation; }
+	friend bool operator!=(const Entity& a, const Entity& b) { return !(a == b); }
+};
\ No newline at end of file
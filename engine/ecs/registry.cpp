@@ -0,0 +1,46 @@
+#include "registry.h"
+
+#include "core/logger.h"
+
+Registry::~Registry() {
+	for (IComponentPool* pool : m_Pools) {
+		Platform::Destroy(pool);
+	}
+}
+
+Entity Registry::CreateEntity() {
+	uint32_t index;
+
+	if (!m_FreeIndices.is_empty()) {
+		index = m_FreeIndices[m_FreeIndices.size() - 1];
+		m_FreeIndices.remove_last();
+	} else {
+		index = m_Generations.size_u32();
+		m_Generations.push_back(0);
+	}
+
+	m_AliveCount++;
+
+	return Entity{ index, m_Generations[index] };
+}
+
+void Registry::DestroyEntity(Entity entity) {
+	if (!IsAlive(entity)) {
+		LOG_WARNING("Registry::DestroyEntity: entity (%u, %u) is not alive", entity.index, entity.generation);
+		return;
+	}
+
+	for (IComponentPool* pool : m_Pools) {
+		if (pool) {
+			pool->Remove(entity);
+		}
+	}
+
+	m_Generations[entity.index]++;
+	m_FreeIndices.push_back(entity.index);
+	m_AliveCount--;
+}
+
+bool Registry::IsAlive(Entity entity) const {
+	return entity.index < m_Generations.size() && m_Generations[entity.index] == entity.generation;
+}
\ No newline at end of file
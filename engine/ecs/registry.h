@@ -0,0 +1,82 @@
+#pragma once
+
+#include "defines.h"
+#include "containers/list.h"
+#include "ecs/component_pool.h"
+#include "ecs/component_type.h"
+#include "ecs/entity.h"
+#include "ecs/view.h"
+#include "platform/platform.h"
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+/*
+ * Owns every entity and component. Each component type has its own ComponentPool,
+ * so all components of a type sit in one contiguous array that systems can stream through.
+ */
+class RAPI Registry {
+public:
+	Registry() = default;
+	Registry(const Registry&) = delete;
+	Registry(Registry&&) = delete;
+	Registry& operator=(const Registry&) = delete;
+	~Registry();
+
+	Entity CreateEntity();
+	/* Removes every component of the entity. */
+	void DestroyEntity(Entity entity);
+	bool IsAlive(Entity entity) const;
+	AINLINE size_t GetEntityCount() const { return m_AliveCount; }
+
+	template<typename T, typename... Args>
+	T& AddComponent(Entity entity, Args&&... args) {
+		assert(IsAlive(entity) && "Adding a component to a dead entity");
+		return GetPool<T>().Add(entity, std::forward<Args>(args)...);
+	}
+
+	template<typename T>
+	void RemoveComponent(Entity entity) {
+		GetPool<T>().Remove(entity);
+	}
+
+	/* Returns nullptr if the entity doesn't have the component. */
+	template<typename T>
+	T* GetComponent(Entity entity) {
+		return GetPool<T>().Get(entity);
+	}
+
+	template<typename T>
+	bool HasComponent(Entity entity) {
+		return GetPool<T>().Contains(entity);
+	}
+
+	template<typename... Ts>
+	View<Ts...> GetView() {
+		return View<Ts...>(&GetPool<Ts>()...);
+	}
+
+private:
+	/* Pools are created the first time a component type is used. */
+	template<typename T>
+	ComponentPool<T>& GetPool() {
+		uint32_t id = ComponentTypeId::Get<T>();
+
+		if (id >= m_Pools.size()) {
+			m_Pools.resize(id + 1);
+		}
+
+		if (!m_Pools[id]) {
+			m_Pools[id] = Platform::Construct<ComponentPool<T>, MemoryTag::Core>();
+		}
+
+		return *static_cast<ComponentPool<T>*>(m_Pools[id]);
+	}
+
+private:
+	list<uint32_t> m_Generations;
+	list<uint32_t> m_FreeIndices;
+	list<IComponentPool*> m_Pools;
+	size_t m_AliveCount = 0;
+};
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "defines.h"
+#include "ecs/component_pool.h"
+#include "ecs/entity.h"
+
+#include <cstddef>
+#include <tuple>
+
+/*
+ * Entities that have every component in Ts. Iteration walks the smallest pool
+ * and skips entities missing from the others.
+ * Components of the viewed types must not be added or removed from inside Each.
+ */
+template<typename... Ts>
+class View {
+public:
+	View(ComponentPool<Ts>*... pools)
+		:
+		m_Pools(pools...)
+	{}
+
+	/* Calls function(Entity, Ts&...) for every matching entity. */
+	template<typename Function>
+	void Each(Function&& function) {
+		if constexpr (sizeof...(Ts) == 1) {
+			// Single component, the dense arrays are the result.
+			auto* pool = std::get<0>(m_Pools);
+			const Entity* entities = pool->GetEntities();
+			auto* components = pool->GetComponents();
+
+			for (size_t i = 0; i < pool->GetSize(); i++) {
+				function(entities[i], components[i]);
+			}
+		} else {
+			const IComponentPool* smallest = GetSmallestPool();
+			const Entity* entities = smallest->GetEntities();
+
+			for (size_t i = 0; i < smallest->GetSize(); i++) {
+				Entity entity = entities[i];
+				if ((std::get<ComponentPool<Ts>*>(m_Pools)->Contains(entity) && ...)) {
+					function(entity, *std::get<ComponentPool<Ts>*>(m_Pools)->Get(entity)...);
+				}
+			}
+		}
+	}
+
+	/* Upper bound, the actual count is only known after iterating. */
+	size_t GetSizeHint() const {
+		return GetSmallestPool()->GetSize();
+	}
+
+private:
+	const IComponentPool* GetSmallestPool() const {
+		const IComponentPool* pools[] = { std::get<ComponentPool<Ts>*>(m_Pools)... };
+		const IComponentPool* smallest = pools[0];
+
+		for (const IComponentPool* pool : pools) {
+			if (pool->GetSize() < smallest->GetSize()) {
+				smallest = pool;
+			}
+		}
+
+		return smallest;
+	}
+
+private:
+	std::tuple<ComponentPool<Ts>*...> m_Pools;
+};
\ No newline at end of file
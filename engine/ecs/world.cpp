@@ -0,0 +1,173 @@
+#include "world.h"
+
+#include "core/logger.h"
+#include "platform/platform.h"
+
+#include <cstring>
+
+World::~World() {
+	for (Archetype* archetype : m_ArchetypeList) {
+		Platform::Destroy(archetype);
+	}
+}
+
+Entity World::CreateEntityFromColumns(ArchetypeColumn* columns, const void** data, uint32_t count) {
+	// Sort by component id (insertion sort, there's only a handful) so every order of Ts maps to one archetype.
+	for (uint32_t i = 1; i < count; i++) {
+		for (uint32_t j = i; j > 0 && columns[j].componentId < columns[j - 1].componentId; j--) {
+			ArchetypeColumn column = columns[j];
+			columns[j] = columns[j - 1];
+			columns[j - 1] = column;
+
+			const void* component = data[j];
+			data[j] = data[j - 1];
+			data[j - 1] = component;
+		}
+	}
+
+	uint32_t index;
+	if (!m_FreeIndices.is_empty()) {
+		index = m_FreeIndices[m_FreeIndices.size() - 1];
+		m_FreeIndices.remove_last();
+	} else {
+		index = m_Generations.size_u32();
+		m_Generations.push_back(0);
+		m_Locations.push_back(EntityLocation{ nullptr, 0 });
+	}
+
+	Entity entity{ index, m_Generations[index] };
+	Archetype* archetype = GetOrCreateArchetype(columns, count);
+	uint32_t row = archetype->AddRow(entity);
+
+	for (uint32_t i = 0; i < count; i++) {
+		memcpy(archetype->GetComponent(row, i), data[i], columns[i].size);
+	}
+
+	m_Locations[index] = EntityLocation{ archetype, row };
+	m_AliveCount++;
+
+	return entity;
+}
+
+void World::DestroyEntity(Entity entity) {
+	if (!IsAlive(entity)) {
+		LOG_WARNING("World::DestroyEntity: entity (%u, %u) is not alive", entity.index, entity.generation);
+		return;
+	}
+
+	EntityLocation& location = m_Locations[entity.index];
+	RemoveRow(location.archetype, location.row);
+	location = EntityLocation{ nullptr, 0 };
+
+	m_Generations[entity.index]++;
+	m_FreeIndices.push_back(entity.index);
+	m_AliveCount--;
+}
+
+bool World::IsAlive(Entity entity) const {
+	return entity.index < m_Generations.size() && m_Generations[entity.index] == entity.generation;
+}
+
+void* World::AddColumn(Entity entity, const ArchetypeColumn& column) {
+	assert(IsAlive(entity) && "Adding a component to a dead entity");
+
+	Archetype* source = m_Locations[entity.index].archetype;
+	int32_t existing = source->FindColumn(column.componentId);
+	if (existing != -1) {
+		return source->GetComponent(m_Locations[entity.index].row, (uint32_t)existing);
+	}
+
+	// Source columns are sorted, insert the new one in place.
+	small_list<ArchetypeColumn, 16> columns;
+	bool inserted = false;
+	for (uint32_t i = 0; i < source->GetColumnCount(); i++) {
+		if (!inserted && column.componentId < source->GetColumn(i).componentId) {
+			columns.push_back(column);
+			inserted = true;
+		}
+		columns.push_back(source->GetColumn(i));
+	}
+	if (!inserted) {
+		columns.push_back(column);
+	}
+
+	Archetype* destination = GetOrCreateArchetype(columns.data(), columns.size_u32());
+	uint32_t row = MoveEntity(entity, destination);
+
+	return destination->GetComponent(row, (uint32_t)destination->FindColumn(column.componentId));
+}
+
+void World::RemoveColumn(Entity entity, uint32_t componentId) {
+	if (!IsAlive(entity)) {
+		return;
+	}
+
+	Archetype* source = m_Locations[entity.index].archetype;
+	if (source->FindColumn(componentId) == -1) {
+		return;
+	}
+
+	small_list<ArchetypeColumn, 16> columns;
+	for (uint32_t i = 0; i < source->GetColumnCount(); i++) {
+		if (source->GetColumn(i).componentId != componentId) {
+			columns.push_back(source->GetColumn(i));
+		}
+	}
+
+	MoveEntity(entity, GetOrCreateArchetype(columns.data(), columns.size_u32()));
+}
+
+void* World::FindColumnData(Entity entity, uint32_t componentId) {
+	if (!IsAlive(entity)) {
+		return nullptr;
+	}
+
+	const EntityLocation& location = m_Locations[entity.index];
+	int32_t column = location.archetype->FindColumn(componentId);
+
+	return column != -1 ? location.archetype->GetComponent(location.row, (uint32_t)column) : nullptr;
+}
+
+Archetype* World::GetOrCreateArchetype(const ArchetypeColumn* columns, uint32_t count) {
+	ComponentMask mask;
+	for (uint32_t i = 0; i < count; i++) {
+		mask.Set(columns[i].componentId);
+	}
+
+	if (Archetype** archetype = m_Archetypes.find(mask)) {
+		return *archetype;
+	}
+
+	Archetype* archetype = Platform::Construct<Archetype, MemoryTag::Core>(mask, columns, count, m_ChunkAllocator);
+	m_Archetypes.insert(mask, archetype);
+	m_ArchetypeList.push_back(archetype);
+
+	return archetype;
+}
+
+uint32_t World::MoveEntity(Entity entity, Archetype* destination) {
+	EntityLocation& location = m_Locations[entity.index];
+	Archetype* source = location.archetype;
+	uint32_t sourceRow = location.row;
+
+	uint32_t row = destination->AddRow(entity);
+
+	for (uint32_t i = 0; i < destination->GetColumnCount(); i++) {
+		int32_t sourceColumn = source->FindColumn(destination->GetColumn(i).componentId);
+		if (sourceColumn != -1) {
+			memcpy(destination->GetComponent(row, i), source->GetComponent(sourceRow, (uint32_t)sourceColumn), destination->GetColumn(i).size);
+		}
+	}
+
+	RemoveRow(source, sourceRow);
+	m_Locations[entity.index] = EntityLocation{ destination, row };
+
+	return row;
+}
+
+void World::RemoveRow(Archetype* archetype, uint32_t row) {
+	Entity moved = archetype->RemoveRow(row);
+	if (moved.IsValid()) {
+		m_Locations[moved.index].row = row;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "defines.h"
+#include "containers/hash_map.h"
+#include "containers/list.h"
+#include "containers/small_list.h"
+#include "ecs/archetype.h"
+#include "ecs/archetype_query.h"
+#include "ecs/component_type.h"
+#include "ecs/entity.h"
+
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+/*
+ * Archetype based entity storage, for large numbers of entities that systems sweep every frame.
+ * Entities with the same component set share chunks of structure of arrays columns, so a query
+ * over them is a linear walk over tightly packed arrays. Changing an entity's component set
+ * moves it to another archetype, which is more expensive than with Registry.
+ * Entities of a World are not valid in a Registry and the other way around.
+ */
+class RAPI World {
+public:
+	World() = default;
+	World(const World&) = delete;
+	World(World&&) = delete;
+	World& operator=(const World&) = delete;
+	~World();
+
+	template<typename... Ts>
+	Entity CreateEntity(const Ts&... components) {
+		static_assert((std::is_trivially_copyable_v<Ts> && ...), "Archetype components must be trivially copyable");
+
+		ArchetypeColumn columns[sizeof...(Ts) + 1] = { DescribeColumn<Ts>()... };
+		const void* data[sizeof...(Ts) + 1] = { &components... };
+
+		return CreateEntityFromColumns(columns, data, sizeof...(Ts));
+	}
+
+	void DestroyEntity(Entity entity);
+	bool IsAlive(Entity entity) const;
+	AINLINE size_t GetEntityCount() const { return m_AliveCount; }
+
+	/* Moves the entity to the archetype with T added. Overwrites T if the entity already has it. */
+	template<typename T>
+	T& AddComponent(Entity entity, const T& component = T()) {
+		static_assert(std::is_trivially_copyable_v<T>, "Archetype components must be trivially copyable");
+		return *new (AddColumn(entity, DescribeColumn<T>())) T(component);
+	}
+
+	template<typename T>
+	void RemoveComponent(Entity entity) {
+		RemoveColumn(entity, ComponentTypeId::Get<T>());
+	}
+
+	/* Returns nullptr if the entity doesn't have the component. Invalidated when the entity changes archetype. */
+	template<typename T>
+	T* GetComponent(Entity entity) {
+		return (T*)FindColumnData(entity, ComponentTypeId::Get<T>());
+	}
+
+	template<typename T>
+	bool HasComponent(Entity entity) const {
+		return IsAlive(entity) && m_Locations[entity.index].archetype->GetMask().Has(ComponentTypeId::Get<T>());
+	}
+
+	template<typename... Ts>
+	ArchetypeQuery<Ts...> Query() const {
+		return ArchetypeQuery<Ts...>(m_ArchetypeList);
+	}
+
+private:
+	struct EntityLocation {
+		Archetype* archetype;
+		uint32_t row;
+	};
+
+	template<typename T>
+	static ArchetypeColumn DescribeColumn() {
+		return ArchetypeColumn{ ComponentTypeId::Get<T>(), (uint32_t)sizeof(T), (uint32_t)alignof(T), 0 };
+	}
+
+	Entity CreateEntityFromColumns(ArchetypeColumn* columns, const void** data, uint32_t count);
+	void* AddColumn(Entity entity, const ArchetypeColumn& column);
+	void RemoveColumn(Entity entity, uint32_t componentId);
+	void* FindColumnData(Entity entity, uint32_t componentId);
+
+	/* columns must be sorted by component id. */
+	Archetype* GetOrCreateArchetype(const ArchetypeColumn* columns, uint32_t count);
+	/* Copies the components both archetypes share and returns the new row. */
+	uint32_t MoveEntity(Entity entity, Archetype* destination);
+	void RemoveRow(Archetype* archetype, uint32_t row);
+
+private:
+	list<uint32_t> m_Generations;
+	list<uint32_t> m_FreeIndices;
+	list<EntityLocation> m_Locations;
+	hash_map<ComponentMask, Archetype*, ComponentMaskHasher> m_Archetypes;
+	list<Archetype*> m_ArchetypeList;
+	ChunkAllocator m_ChunkAllocator;
+	size_t m_AliveCount = 0;
+};
\ No newline at end of file
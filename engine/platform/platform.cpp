@@ -0,0 +1,29 @@
+#include "platform.h"
+
+#include "core/logger.h"
+
+const char* Platform::GetMemoryTagName(MemoryTag tag) {
+    static constexpr const char* tag_names[] = { "Unknown", "Core", "Renderer", "String", "Container", "Asset", "Game" };
+    static_assert(sizeof(tag_names) / sizeof(*tag_names) == (size_t)MemoryTag::MAX, "Every MemoryTag needs a name");
+
+    if (tag >= MemoryTag::MAX) {
+        return "Invalid";
+    }
+
+    return tag_names[(size_t)tag];
+}
+
+void Platform::ReportMemoryUsage() {
+    LOG_INFO("Memory usage: %zu B total", GetTotalAllocation());
+
+    for (size_t i = 0; i < (size_t)MemoryTag::MAX; i++) {
+        MemoryTag tag = (MemoryTag)i;
+        size_t bytes = GetTaggedAllocation(tag);
+
+        if (bytes == 0) {
+            continue;
+        }
+
+        LOG_INFO("\t%-10s %12zu B in %zu allocations", GetMemoryTagName(tag), bytes, GetTaggedAllocationCount(tag));
+    }
+}
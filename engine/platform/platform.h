@@ -1,23 +1,50 @@
 #pragma once
 
+#include "allocator/linear_allocator.h"
 #include "core/logger.h"
-#include "core/string.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
 class Window;
+class String;
+template<typename T, size_t InlineCapacity> class small_list;
+
+/* Subsystem an allocation is accounted to. */
+enum class MemoryTag : uint8_t {
+    Unknown,
+    Core,
+    Renderer,
+    String,
+    Container,
+    Asset,
+    Game,
+
+    MAX
+};
 
 struct binary_info {
     uint64_t size;
     char* binary;
 };
 
-static inline constexpr uint64_t MINIMUM_ALIGNMENT_SIZE = 16;
+static inline constexpr uint64_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+#if defined(POISON_MEMORY)
+/* Patterns written over uninitialized and freed memory when POISON_MEMORY is defined. */
+static inline constexpr uint8_t UNINITIALIZED_MEMORY_PATTERN = 0xcd;
+static inline constexpr uint8_t FREED_MEMORY_PATTERN = 0xdd;
+#endif
+
+struct PlatformConfig {
+    /* Address space reserved for each of the two frame allocators. */
+    size_t frameArenaReserveSize = 256ull * 1024 * 1024;
+};
 
 class RAPI Platform {
 public:
-    Platform();
+    Platform(const PlatformConfig& config = PlatformConfig());
     Platform(const Platform&) = delete;
     Platform(Platform&&) = delete;
     Platform& operator=(const Platform&) = delete;
@@ -25,20 +52,66 @@ public:
 
     static Platform* Get();
 
-    static void* UAlloc(size_t size);
+    /* Returns zeroed memory, same as UAllocZeroed. */
+    static AINLINE void* UAlloc(size_t size, MemoryTag tag = MemoryTag::Unknown) { return UAllocZeroed(size, tag); }
+    /* Zeroed memory. Blocks that come straight from the OS are already zero and aren't cleared again. */
+    static void* UAllocZeroed(size_t size, MemoryTag tag = MemoryTag::Unknown);
+    /* For buffers that are overwritten right away, e.g. file contents and decoded pixels. */
+    static void* UAllocUninitialized(size_t size, MemoryTag tag = MemoryTag::Unknown);
     static void UFree(void* memory);
-    static void* AAlloc(size_t alignment, size_t size);
+    /* Returns zeroed memory, same as AAllocZeroed. */
+    static AINLINE void* AAlloc(size_t alignment, size_t size, MemoryTag tag = MemoryTag::Unknown) { return AAllocZeroed(alignment, size, tag); }
+    static void* AAllocZeroed(size_t alignment, size_t size, MemoryTag tag = MemoryTag::Unknown);
+    static void* AAllocUninitialized(size_t alignment, size_t size, MemoryTag tag = MemoryTag::Unknown);
     static void AFree(void* memory);
     static void* ZeroMemory(void* memory, size_t size);
 
+    /* Allocates whole pages straight from the OS, the memory is zeroed. size must be a multiple of the page size. */
+    static void* VAlloc(size_t size);
+    static void VFree(void* memory, size_t size);
+
+    /* Reserves address space without backing it with memory. Huge page reservations are aligned to HUGE_PAGE_SIZE. */
+    static void* VReserve(size_t size, bool hugePages = false);
+    /* Backs a page aligned range of reserved address space with zeroed memory. */
+    static bool VCommit(void* memory, size_t size);
+    /* Gives the memory of a committed range back to the OS, the address space stays reserved. */
+    static void VDecommit(void* memory, size_t size);
+    static void VRelease(void* memory, size_t size);
+
+    /* Bytes currently allocated through UAlloc/AAlloc. */
+    static AINLINE size_t GetTotalAllocation() { return m_TotalAllocation.load(std::memory_order_relaxed); }
+    static AINLINE size_t GetTaggedAllocation(MemoryTag tag) { return m_TaggedAllocations[(size_t)tag].load(std::memory_order_relaxed); }
+    /* Number of live allocations of a tag. */
+    static AINLINE size_t GetTaggedAllocationCount(MemoryTag tag) { return m_TaggedAllocationCounts[(size_t)tag].load(std::memory_order_relaxed); }
+    static const char* GetMemoryTagName(MemoryTag tag);
+    /* Logs the memory usage of every tag. */
+    static void ReportMemoryUsage();
+
     static void Log(log_level level, const char* message);
+    /* Writes each line in its level's color followed by a newline, with as few system calls as the platform allows. */
+    static void WriteLogConsole(const LogLine* lines, uint32_t count);
+
+    /* Creates or truncates a log file, nullptr on failure. */
+    static HANDLE OpenLogFile(const char* path);
+    static void CloseLogFile(HANDLE file);
+    /* Appends each line followed by a newline, returns the number of bytes written. */
+    static uint64_t WriteLogFile(HANDLE file, const LogLine* lines, uint32_t count);
+    /* Replaces destination if it exists. */
+    static bool RenameFile(const char* source, const char* destination);
+
+    /*
+     * Creates or truncates path to size zeroed bytes and maps it for reading and writing, nullptr on failure.
+     * Writes go to the OS file cache, they reach the file even if the process crashes right after.
+     */
+    static void* MapFile(const char* path, uint64_t size);
+    static void UnmapFile(void* memory, uint64_t size);
 
     static void* LoadLibrary(const char* libraryPath);
     static void UnloadLibrary(void* library);
     static void* LoadLibraryFunction(void* library, const char* functionName);
 
     static void* CreateVulkanSurface(const Window* window, void* instance);
-    static list<const char*> GetRequiredExtensionNames(const Window& window);
+    static small_list<const char*, 8> GetRequiredExtensionNames(const Window& window);
 
     [[nodiscard("binary_info contains a dynamically allocated string")]] 
     static binary_info OpenBinary(const char* path);
@@ -49,10 +122,15 @@ public:
 
     static String GetCurrentWorkingDirectory();
 
+    /* Scratch memory that lives until the end of the next frame. */
+    static LinearAllocator& GetFrameAllocator();
+    /* Switches to the other frame allocator and resets it. Called once at the beginning of every frame. */
+    static void AdvanceFrameAllocator();
+
     /* Construct an object with Args...*/
-    template<typename Type, typename... Args>
+    template<typename Type, MemoryTag Tag = MemoryTag::Unknown, typename... Args>
     static AINLINE Type* Construct(Args&&... args) {
-        void* memory = UAlloc(sizeof(Type));
+        void* memory = UAlloc(sizeof(Type), Tag);
         try {
             new(memory) Type(std::forward<Args>(args)...);
         } catch (...) {
@@ -64,9 +142,9 @@ public:
     }
 
     /* Construct an object with Arg */
-    template<typename Type, typename Arg>
+    template<typename Type, MemoryTag Tag = MemoryTag::Unknown, typename Arg>
     static AINLINE Type* Construct(Arg&& arg) {
-        void* memory = UAlloc(sizeof(Type));
+        void* memory = UAlloc(sizeof(Type), Tag);
         try {
             new (memory) Type(std::forward<Arg>(arg));
         } catch (...) {
@@ -78,9 +156,9 @@ public:
     }
 
     /* Construct an object without args */
-    template<typename Type>
+    template<typename Type, MemoryTag Tag = MemoryTag::Unknown>
     static AINLINE Type* Construct() {
-        void* memory = UAlloc(sizeof(Type));
+        void* memory = UAlloc(sizeof(Type), Tag);
         try {
             new (memory) Type();
         } catch (...) {
@@ -100,10 +178,24 @@ public:
         }
     }
 
+private:
+    static AINLINE void TrackAllocation(size_t size, MemoryTag tag) {
+        m_TotalAllocation.fetch_add(size, std::memory_order_relaxed);
+        m_TaggedAllocations[(size_t)tag].fetch_add(size, std::memory_order_relaxed);
+        m_TaggedAllocationCounts[(size_t)tag].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static AINLINE void TrackFree(size_t size, MemoryTag tag) {
+        m_TotalAllocation.fetch_sub(size, std::memory_order_relaxed);
+        m_TaggedAllocations[(size_t)tag].fetch_sub(size, std::memory_order_relaxed);
+        m_TaggedAllocationCounts[(size_t)tag].fetch_sub(1, std::memory_order_relaxed);
+    }
+
 private:
     static inline Platform* platform_ptr = nullptr;
-    /* HACK: Temporary */
-    static inline uint8_t* m_BaseLinearMemory = nullptr;
-    static inline uint8_t* m_CurrentLinearMemory = nullptr;
-    size_t m_TotalAllocation = 0;
+    LinearAllocator* m_FrameAllocators[2]{};
+    uint32_t m_FrameAllocatorIndex = 0;
+    static inline std::atomic<size_t> m_TotalAllocation{ 0 };
+    static inline std::atomic<size_t> m_TaggedAllocations[(size_t)MemoryTag::MAX]{};
+    static inline std::atomic<size_t> m_TaggedAllocationCounts[(size_t)MemoryTag::MAX]{};
 };
\ No newline at end of file
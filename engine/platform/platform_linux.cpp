@@ -1,7 +1,10 @@
 
 #if defined (PLATFORM_LINUX)
 #include "platform.h"
+#include "allocator/pool_allocator.h"
 #include "window/window.h"
+#include "core/string.h"
+#include "containers/small_list.h"
 #include "core/logger.h"
 
 #include <SDL2/SDL_messagebox.h>
@@ -11,22 +14,26 @@
 #include <cstdio>
 #include <ctime>
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <linux/limits.h> // NOTE: I think you must have linux-headers installed, but i still need to look for that up.
 #include <cerrno>
 #include <cstdlib>
 
-#define SALLOCATOR_
-
 void Window::MessageBox(const char* title, const char* message) {
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, title, message, nullptr);
 }
 
 struct alignas(MINIMUM_ALIGNMENT_SIZE) alloc_header {
     size_t allocation_size;
-    size_t alignment;
+    uint32_t alignment;
+    MemoryTag tag;
 };
 
+static_assert(sizeof(alloc_header) == MINIMUM_ALIGNMENT_SIZE, "alloc_header must not change the alignment of the memory that follows it");
+
 static inline void* from_header_to_memory(alloc_header* header) {
     return ((uint8_t*)header) + sizeof(alloc_header); 
 }
@@ -35,118 +42,342 @@ static inline alloc_header* from_memory_to_header(void* memory) {
     return (alloc_header*)(((uint8_t*)memory) - sizeof(alloc_header));
 }
 
-Platform::Platform() {
+Platform::Platform(const PlatformConfig& config) {
     if (platform_ptr) {
         // TODO: Throw exception
     }
 
-    constexpr uint64_t allocatorSize = 1024 * 1024 * 1024;
-    m_BaseLinearMemory = (uint8_t*)malloc(allocatorSize);
-    m_CurrentLinearMemory = m_BaseLinearMemory;
-    Logger::Debug("Initializing allocator with initial size of: %llu B", allocatorSize);
     platform_ptr = this;
+
+    // Arenas only reserve address space here, pages are committed the first time they are used.
+    // One frame allocator is for the frame being built and the other one for the previous frame.
+    m_FrameAllocators[0] = Platform::Construct<LinearAllocator, MemoryTag::Core>(config.frameArenaReserveSize);
+    m_FrameAllocators[1] = Platform::Construct<LinearAllocator, MemoryTag::Core>(config.frameArenaReserveSize);
+    LOG_DEBUG("Reserved %zu B per frame allocator", config.frameArenaReserveSize);
 }
 
 Platform::~Platform() {
-    Logger::Warning("Shutting down platform with %zu allocated!", platform_ptr->m_TotalAllocation);
+    Platform::Destroy(m_FrameAllocators[0]);
+    Platform::Destroy(m_FrameAllocators[1]);
+    if (GetTotalAllocation() != 0) {
+        LOG_WARNING("Shutting down platform with %zu allocated!", GetTotalAllocation());
+        ReportMemoryUsage();
+    }
     platform_ptr = nullptr;
-    free(m_BaseLinearMemory);
 }
 
-void* Platform::UAlloc(size_t size) {
-#ifndef SALLOCATOR_
-    alloc_header* header = (alloc_header*)malloc(sizeof(alloc_header) + size);
-#else
-    alloc_header* header = (alloc_header*)m_CurrentLinearMemory;
-    m_CurrentLinearMemory += size + sizeof(alloc_header);
-#endif
-    memset(header, 0, sizeof(alloc_header) + size);
+static inline void* allocate_pool_memory(size_t size, MemoryTag tag, bool zeroed) {
+    alloc_header* header = (alloc_header*)PoolAllocator::Allocate(sizeof(alloc_header) + size, zeroed);
+    if (!header) {
+        return nullptr;
+    }
+
     header->allocation_size = size;
+    header->alignment = 0;
+    header->tag = tag;
+
+    return from_header_to_memory(header);
+}
+
+void* Platform::UAllocZeroed(size_t size, MemoryTag tag) {
+    void* memory = allocate_pool_memory(size, tag, true);
 
-    if (!platform_ptr) {
-        Logger::Warning("Allocating %zu bytes before initializing platform", size);
-    } else {
-        platform_ptr->m_TotalAllocation += size;
-        Logger::Warning("Allocating %zu bytes, total: %zu", size, platform_ptr->m_TotalAllocation);    
+    if (memory) {
+        TrackAllocation(size, tag);
     }
-    
-    return from_header_to_memory(header);    
+
+    return memory;
+}
+
+void* Platform::UAllocUninitialized(size_t size, MemoryTag tag) {
+    void* memory = allocate_pool_memory(size, tag, false);
+
+    if (memory) {
+        TrackAllocation(size, tag);
+#if defined(POISON_MEMORY)
+        memset(memory, UNINITIALIZED_MEMORY_PATTERN, size);
+#endif
+    }
+
+    return memory;
 }
 
 void Platform::UFree(void* memory) {
     alloc_header* header = from_memory_to_header(memory);
+    size_t allocationSize = header->allocation_size;
 
-    if (!platform_ptr) {
-        Logger::Warning("Freeing %zu bytes before initializing platform", header->allocation_size);
-    } else {
-        platform_ptr->m_TotalAllocation -= header->allocation_size;
-        Logger::Warning("Freeing %zu bytes, total: %zu", header->allocation_size, platform_ptr->m_TotalAllocation);
-    }
+    TrackFree(allocationSize, header->tag);
 
-    memset(header, 0, sizeof(alloc_header) + header->allocation_size);
-#ifndef SALLOCATOR_
-    free(header);
+#if defined(POISON_MEMORY)
+    memset(memory, FREED_MEMORY_PATTERN, allocationSize);
 #endif
+
+    PoolAllocator::Free(header, sizeof(alloc_header) + allocationSize);
 }
 
-void* Platform::AAlloc(size_t alignment, size_t size) {
+static void* allocate_aligned_memory(size_t alignment, size_t size, MemoryTag tag) {
     if (alignment < MINIMUM_ALIGNMENT_SIZE) {
-        Logger::Warning("Platform::aalloc: alignment size should be greater or equal to %zu bytes", MINIMUM_ALIGNMENT_SIZE);
+        LOG_WARNING("Platform::aalloc: alignment size should be greater or equal to %zu bytes", MINIMUM_ALIGNMENT_SIZE);
         return nullptr;
     }
-    
-    alloc_header* header = nullptr;
-    int result = posix_memalign((void**)&header, alignment, sizeof(alloc_header) + size);
+
+    // The header sits right before the returned memory, so a whole alignment is reserved
+    // in front of it to keep the returned memory aligned.
+    uint8_t* block = nullptr;
+    int result = posix_memalign((void**)&block, alignment, alignment + size);
 
     if (result == EINVAL) {
-        Logger::Warning("The alignment argument was not a power of two, or was not a multiple of sizeof(void *).");
-        goto cleanup;
+        LOG_WARNING("The alignment argument was not a power of two, or was not a multiple of sizeof(void *).");
+        return nullptr;
     } else if (result == ENOMEM) {
-        Logger::Warning("There was insufficient memory to fulfill the allocation request.");
-        goto cleanup;
+        LOG_WARNING("There was insufficient memory to fulfill the allocation request.");
+        return nullptr;
     }
 
-    memset(header, 0, sizeof(alloc_header) + size);
+    void* memory = block + alignment;
+    alloc_header* header = from_memory_to_header(memory);
     header->allocation_size = size;
-    header->alignment = alignment;
+    header->alignment = (uint32_t)alignment;
+    header->tag = tag;
+
+    return memory;
+}
 
-    if (!platform_ptr) {
-        Logger::Warning("Allocating %zu bytes before initializing platform", size);
-    } else {
-        platform_ptr->m_TotalAllocation += size;
-        Logger::Warning("Allocating %zu bytes, total: %zu", size, platform_ptr->m_TotalAllocation);
-    }  
+void* Platform::AAllocZeroed(size_t alignment, size_t size, MemoryTag tag) {
+    void* memory = allocate_aligned_memory(alignment, size, tag);
 
-    return from_header_to_memory(header);    
+    if (memory) {
+        memset(memory, 0, size);
+        TrackAllocation(size, tag);
+    }
+
+    return memory;
+}
+
+void* Platform::AAllocUninitialized(size_t alignment, size_t size, MemoryTag tag) {
+    void* memory = allocate_aligned_memory(alignment, size, tag);
 
-cleanup:
-    if (header) {
-        AFree(header);
+    if (memory) {
+        TrackAllocation(size, tag);
+#if defined(POISON_MEMORY)
+        memset(memory, UNINITIALIZED_MEMORY_PATTERN, size);
+#endif
     }
-    return nullptr;
+
+    return memory;
 }
 
 void Platform::AFree(void* memory) {
     alloc_header* header = from_memory_to_header(memory);
 
-    if (!platform_ptr) {
-        Logger::Warning("Freeing %zu bytes before initializing platform", header->allocation_size);
-    } else {
-        platform_ptr->m_TotalAllocation -= header->allocation_size;
-        Logger::Warning("Freeing %zu bytes, total: %zu", header->allocation_size, platform_ptr->m_TotalAllocation);
-    }
+    TrackFree(header->allocation_size, header->tag);
 
-    memset(header, 0, sizeof(alloc_header) + header->allocation_size);
-    free(header);
+#if defined(POISON_MEMORY)
+    memset(memory, FREED_MEMORY_PATTERN, header->allocation_size);
+#endif
+
+    free((uint8_t*)memory - header->alignment);
 }
 
 void* Platform::ZeroMemory(void* memory, size_t size) {
     return memset(memory, 0, size);
 }
 
+void* Platform::VAlloc(size_t size) {
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (memory == MAP_FAILED) {
+        LOG_WARNING("Platform::VAlloc: failed to map %zu bytes: %s", size, strerror(errno));
+        return nullptr;
+    }
+
+    // Big buffers (textures, meshes) are walked linearly, let the kernel back them with huge pages.
+    if (size >= HUGE_PAGE_SIZE) {
+        madvise(memory, size, MADV_HUGEPAGE);
+    }
+
+    return memory;
+}
+
+void Platform::VFree(void* memory, size_t size) {
+    if (memory) {
+        munmap(memory, size);
+    }
+}
+
+void* Platform::VReserve(size_t size, bool hugePages) {
+    // Huge pages need HUGE_PAGE_SIZE aligned ranges, so over-reserve and trim both ends.
+    size_t reserveSize = hugePages ? size + HUGE_PAGE_SIZE : size;
+    uint8_t* memory = (uint8_t*)mmap(nullptr, reserveSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (memory == MAP_FAILED) {
+        LOG_WARNING("Platform::VReserve: failed to reserve %zu bytes: %s", size, strerror(errno));
+        return nullptr;
+    }
+
+    if (hugePages) {
+        uint8_t* aligned = (uint8_t*)(((uintptr_t)memory + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1));
+        size_t head = aligned - memory;
+        size_t tail = reserveSize - head - size;
+
+        if (head) {
+            munmap(memory, head);
+        }
+        if (tail) {
+            munmap(aligned + size, tail);
+        }
+
+        madvise(aligned, size, MADV_HUGEPAGE);
+        memory = aligned;
+    }
+
+    return memory;
+}
+
+bool Platform::VCommit(void* memory, size_t size) {
+    if (mprotect(memory, size, PROT_READ | PROT_WRITE) != 0) {
+        LOG_WARNING("Platform::VCommit: failed to commit %zu bytes: %s", size, strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+void Platform::VDecommit(void* memory, size_t size) {
+    madvise(memory, size, MADV_DONTNEED);
+    mprotect(memory, size, PROT_NONE);
+}
+
+void Platform::VRelease(void* memory, size_t size) {
+    if (memory) {
+        munmap(memory, size);
+    }
+}
+
+/* Log file handles are the file descriptor plus one, so nullptr can mean failure. */
+static AINLINE HANDLE fd_to_handle(int fd) { return (HANDLE)(intptr_t)(fd + 1); }
+static AINLINE int handle_to_fd(HANDLE handle) { return (int)(intptr_t)handle - 1; }
+
+/* writev until everything is out, pipes and terminals may take less than asked. */
+static uint64_t write_all(int fd, iovec* vectors, int count) {
+    uint64_t total = 0;
+
+    while (count > 0) {
+        ssize_t written = writev(fd, vectors, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        total += written;
+        while (count > 0 && (size_t)written >= vectors->iov_len) {
+            written -= vectors->iov_len;
+            vectors++;
+            count--;
+        }
+
+        if (count > 0) {
+            vectors->iov_base = (char*)vectors->iov_base + written;
+            vectors->iov_len -= written;
+        }
+    }
+
+    return total;
+}
+
+/* Lines per writev, each takes up to three vectors. */
+static constexpr uint32_t LOG_LINES_PER_WRITE = 64;
+
 void Platform::Log(log_level level, const char *message) {
-    static constexpr const char* color_string[] = { "0;41", "1;33", "1;32", "1;30" };
-    printf("\033[%sm%s\033[0m\n", color_string[level], message);
+    LogLine line{ message, (uint32_t)strlen(message), level };
+    WriteLogConsole(&line, 1);
+}
+
+void Platform::WriteLogConsole(const LogLine* lines, uint32_t count) {
+    static constexpr const char* color_string[] = { "\033[0;41m", "\033[1;33m", "\033[1;30m", "\033[1;32m" };
+    static constexpr char reset_string[] = "\033[0m\n";
+
+    iovec vectors[LOG_LINES_PER_WRITE * 3];
+
+    for (uint32_t first = 0; first < count; first += LOG_LINES_PER_WRITE) {
+        uint32_t last = first + LOG_LINES_PER_WRITE < count ? first + LOG_LINES_PER_WRITE : count;
+        int vectorCount = 0;
+
+        for (uint32_t i = first; i < last; i++) {
+            vectors[vectorCount++] = { (void*)color_string[lines[i].level], strlen(color_string[lines[i].level]) };
+            vectors[vectorCount++] = { (void*)lines[i].message, lines[i].size };
+            vectors[vectorCount++] = { (void*)reset_string, sizeof(reset_string) - 1 };
+        }
+
+        write_all(STDOUT_FILENO, vectors, vectorCount);
+    }
+}
+
+HANDLE Platform::OpenLogFile(const char* path) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    return fd < 0 ? nullptr : fd_to_handle(fd);
+}
+
+void Platform::CloseLogFile(HANDLE file) {
+    if (file) {
+        close(handle_to_fd(file));
+    }
+}
+
+uint64_t Platform::WriteLogFile(HANDLE file, const LogLine* lines, uint32_t count) {
+    iovec vectors[LOG_LINES_PER_WRITE * 2];
+    uint64_t written = 0;
+
+    for (uint32_t first = 0; first < count; first += LOG_LINES_PER_WRITE) {
+        uint32_t last = first + LOG_LINES_PER_WRITE < count ? first + LOG_LINES_PER_WRITE : count;
+        int vectorCount = 0;
+
+        for (uint32_t i = first; i < last; i++) {
+            vectors[vectorCount++] = { (void*)lines[i].message, lines[i].size };
+            vectors[vectorCount++] = { (void*)"\n", 1 };
+        }
+
+        written += write_all(handle_to_fd(file), vectors, vectorCount);
+    }
+
+    return written;
+}
+
+bool Platform::RenameFile(const char* source, const char* destination) {
+    return rename(source, destination) == 0;
+}
+
+void* Platform::MapFile(const char* path, uint64_t size) {
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG_WARNING("Platform::MapFile: failed to open %s: %s", path, strerror(errno));
+        return nullptr;
+    }
+
+    if (ftruncate(fd, size) != 0) {
+        LOG_WARNING("Platform::MapFile: failed to resize %s to %llu bytes: %s", path, size, strerror(errno));
+        close(fd);
+        return nullptr;
+    }
+
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // The mapping keeps the file alive.
+    close(fd);
+
+    if (memory == MAP_FAILED) {
+        LOG_WARNING("Platform::MapFile: failed to map %s: %s", path, strerror(errno));
+        return nullptr;
+    }
+
+    return memory;
+}
+
+void Platform::UnmapFile(void* memory, uint64_t size) {
+    if (memory) {
+        munmap(memory, size);
+    }
 }
 
 void* Platform::LoadLibrary(const char* libraryPath) {
@@ -154,7 +385,7 @@ void* Platform::LoadLibrary(const char* libraryPath) {
 
     char path[PATH_MAX];
     if (getcwd(path, PATH_MAX) == nullptr) {
-        Logger::Warning("Platform::load_library: Failed to get current working directory");
+        LOG_WARNING("Platform::load_library: Failed to get current working directory");
         return nullptr;
     }
 
@@ -163,7 +394,7 @@ void* Platform::LoadLibrary(const char* libraryPath) {
     void* library = dlopen(library_name, RTLD_NOW);
 
     if (!library) {
-        Logger::Fatal("%s", dlerror());
+        LOG_FATAL("%s", dlerror());
     }
 
     return library;
@@ -179,7 +410,7 @@ void* Platform::LoadLibraryFunction(void* library, const char* functionName) {
     const char* error_message = dlerror();
     
     if (error_message) {
-        Logger::Warning("%s", error_message);
+        LOG_WARNING("%s", error_message);
         return nullptr;
     }
 
@@ -190,16 +421,16 @@ void* Platform::CreateVulkanSurface(const Window* window, void* instance) {
     VkSurfaceKHR surface = 0;
     
     if (SDL_Vulkan_CreateSurface((SDL_Window*)window->GetWindowInternalHandle(), (VkInstance)instance, &surface) != SDL_TRUE) {
-        Logger::Fatal("Failed to create vulkan surface");
+        LOG_FATAL("Failed to create vulkan surface");
         return nullptr;
     }
 
     return surface;
 }
 
-list<const char*> Platform::GetRequiredExtensionNames(const Window& window) {
+small_list<const char*, 8> Platform::GetRequiredExtensionNames(const Window& window) {
     uint32_t extensionCount = 0;
-    list<const char*> extensions;
+    small_list<const char*, 8> extensions;
 
     SDL_Window* sdlWindow = (SDL_Window*)window.GetWindowInternalHandle();
 
@@ -214,7 +445,7 @@ binary_info Platform::OpenBinary(const char* path) {
     FILE* file = fopen(path, "rb");
 
     if (!file) {
-        Logger::Warning("Failed to open file %s", path);
+        LOG_WARNING("Failed to open file %s", path);
         return {};
     }
 
@@ -227,7 +458,7 @@ binary_info Platform::OpenBinary(const char* path) {
     // get back to the beginning
     fseek(file, 0, SEEK_SET);
 
-    info.binary = (char*)Platform::UAlloc(info.size);
+    info.binary = (char*)Platform::UAllocUninitialized(info.size, MemoryTag::Asset);
 
     fread(info.binary, info.size, 1, file);
 
@@ -256,4 +487,13 @@ String Platform::GetCurrentWorkingDirectory() {
     return buffer;
 }
 
+LinearAllocator& Platform::GetFrameAllocator() {
+    return *platform_ptr->m_FrameAllocators[platform_ptr->m_FrameAllocatorIndex];
+}
+
+void Platform::AdvanceFrameAllocator() {
+    platform_ptr->m_FrameAllocatorIndex ^= 1;
+    platform_ptr->m_FrameAllocators[platform_ptr->m_FrameAllocatorIndex]->Reset();
+}
+
 #endif
\ No newline at end of file
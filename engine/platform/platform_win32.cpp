@@ -1,7 +1,9 @@
 #if defined (PLATFORM_WINDOWS)
 #include "platform.h"
 #include "defines.h"
+#include "allocator/pool_allocator.h"
 #include "window/window.h"
+#include "core/string.h"
 #include "renderer/renderer_exception.h"
 
 #include <vulkan/vulkan.h>
@@ -24,7 +26,8 @@
 
 struct alignas(MINIMUM_ALIGNMENT_SIZE) alloc_header {
     size_t allocation_size;
-    size_t alignment;
+    uint32_t alignment;
+    MemoryTag tag;
 };
 
 void Window::MessageBox(const char* title, const char* message) {
@@ -39,106 +42,274 @@ static inline alloc_header* from_memory_to_header(void* memory) {
     return (alloc_header*)(((uint8_t*)memory) - sizeof(alloc_header));
 }
 
-Platform::Platform() {
+Platform::Platform(const PlatformConfig& config) {
     if (platform_ptr) {
         // TODO: Throw exception
     }
     platform_ptr = this;
+
+    m_FrameAllocators[0] = Platform::Construct<LinearAllocator, MemoryTag::Core>(config.frameArenaReserveSize);
+    m_FrameAllocators[1] = Platform::Construct<LinearAllocator, MemoryTag::Core>(config.frameArenaReserveSize);
 }
 
 Platform::~Platform() {
-    Logger::Warning("Shutting down platform with %zu allocated!", platform_ptr->m_TotalAllocation);
+    Platform::Destroy(m_FrameAllocators[0]);
+    Platform::Destroy(m_FrameAllocators[1]);
+    if (GetTotalAllocation() != 0) {
+        LOG_WARNING("Shutting down platform with %zu allocated!", GetTotalAllocation());
+        ReportMemoryUsage();
+    }
     platform_ptr = nullptr;
 }
 
-void* Platform::UAlloc(size_t size) {
-    alloc_header* header = (alloc_header*)malloc(sizeof(alloc_header) + size);
-    memset(header, 0, sizeof(alloc_header) + size);
+static inline void* allocate_pool_memory(size_t size, MemoryTag tag, bool zeroed) {
+    alloc_header* header = (alloc_header*)PoolAllocator::Allocate(sizeof(alloc_header) + size, zeroed);
+    if (!header) {
+        return nullptr;
+    }
+
     header->allocation_size = size;
+    header->alignment = 0;
+    header->tag = tag;
 
-    if (!platform_ptr) {
-        Logger::Warning("Allocating %zu bytes before initializing platform", size);
-    } else {
-        platform_ptr->m_TotalAllocation += size;
-        Logger::Warning("Allocating %zu bytes, total: %zu", size, platform_ptr->m_TotalAllocation);
+    return from_header_to_memory(header);
+}
+
+void* Platform::UAllocZeroed(size_t size, MemoryTag tag) {
+    void* memory = allocate_pool_memory(size, tag, true);
+
+    if (memory) {
+        TrackAllocation(size, tag);
     }
 
-    return from_header_to_memory(header);
+    return memory;
+}
+
+void* Platform::UAllocUninitialized(size_t size, MemoryTag tag) {
+    void* memory = allocate_pool_memory(size, tag, false);
+
+    if (memory) {
+        TrackAllocation(size, tag);
+#if defined(POISON_MEMORY)
+        memset(memory, UNINITIALIZED_MEMORY_PATTERN, size);
+#endif
+    }
+
+    return memory;
 }
 
 void Platform::UFree(void* memory) {
     alloc_header* header = from_memory_to_header(memory);
+    size_t allocationSize = header->allocation_size;
 
-    if (!platform_ptr) {
-        Logger::Warning("Freeing %zu bytes before initializing platform", header->allocation_size);
-    } else {
-        platform_ptr->m_TotalAllocation -= header->allocation_size;
-        Logger::Warning("Freeing %zu bytes, total: %zu", header->allocation_size, platform_ptr->m_TotalAllocation);
-    }
+    TrackFree(allocationSize, header->tag);
 
-    free(header);
+#if defined(POISON_MEMORY)
+    memset(memory, FREED_MEMORY_PATTERN, allocationSize);
+#endif
+
+    PoolAllocator::Free(header, sizeof(alloc_header) + allocationSize);
 }
 
-void* Platform::AAlloc(size_t alignment, size_t size) {
+static void* allocate_aligned_memory(size_t alignment, size_t size, MemoryTag tag) {
     if (alignment < MINIMUM_ALIGNMENT_SIZE) {
-        Logger::Warning("Platform::aalloc: alignment size should be greater or equal to %zu bytes", MINIMUM_ALIGNMENT_SIZE);
+        LOG_WARNING("Platform::aalloc: alignment size should be greater or equal to %zu bytes", MINIMUM_ALIGNMENT_SIZE);
         return nullptr;
     }
 
-    alloc_header* header = (alloc_header*)_aligned_malloc(size + sizeof(alloc_header), alignment);
+    // The header sits right before the returned memory, so a whole alignment is reserved
+    // in front of it to keep the returned memory aligned.
+    uint8_t* block = (uint8_t*)_aligned_malloc(alignment + size, alignment);
     
-    if (!header) {
+    if (!block) {
         int error_number = 0;
         _get_errno(&error_number);
 
         if (error_number == EINVAL) {
-            Logger::Warning("The alignment argument was not a power of two, or was not a multiple of sizeof(void *).");
+            LOG_WARNING("The alignment argument was not a power of two, or was not a multiple of sizeof(void *).");
         }
         return nullptr;
     }
 
-    memset(header, 0, size + sizeof(alloc_header));
+    void* memory = block + alignment;
+    alloc_header* header = from_memory_to_header(memory);
     header->allocation_size = size;
-    header->alignment = alignment;
+    header->alignment = (uint32_t)alignment;
+    header->tag = tag;
+
+    return memory;
+}
 
-    if (!platform_ptr) {
-        Logger::Warning("Allocating %zu bytes before initializing platform", size);
-    } else {
-        platform_ptr->m_TotalAllocation += size;
-        Logger::Warning("Allocating %zu bytes, total: %zu", size, platform_ptr->m_TotalAllocation);
+void* Platform::AAllocZeroed(size_t alignment, size_t size, MemoryTag tag) {
+    void* memory = allocate_aligned_memory(alignment, size, tag);
+
+    if (memory) {
+        memset(memory, 0, size);
+        TrackAllocation(size, tag);
     }
 
-    return from_header_to_memory(header);
+    return memory;
+}
+
+void* Platform::AAllocUninitialized(size_t alignment, size_t size, MemoryTag tag) {
+    void* memory = allocate_aligned_memory(alignment, size, tag);
+
+    if (memory) {
+        TrackAllocation(size, tag);
+#if defined(POISON_MEMORY)
+        memset(memory, UNINITIALIZED_MEMORY_PATTERN, size);
+#endif
+    }
+
+    return memory;
 }
 
 void Platform::AFree(void* memory) {
     alloc_header* header = from_memory_to_header(memory);
 
-    if (!platform_ptr) {
-        Logger::Warning("Freeing %zu bytes before initializing platform", header->allocation_size);
-    } else {
-        platform_ptr->m_TotalAllocation -= header->allocation_size;
-        Logger::Warning("Freeing %zu bytes, total: %zu", header->allocation_size, platform_ptr->m_TotalAllocation);
-    }
+    TrackFree(header->allocation_size, header->tag);
 
-    memset(header, 0, sizeof(alloc_header) + header->allocation_size);
-    _aligned_free(header);
+#if defined(POISON_MEMORY)
+    memset(memory, FREED_MEMORY_PATTERN, header->allocation_size);
+#endif
+
+    _aligned_free((uint8_t*)memory - header->alignment);
 }
 
 void* Platform::ZeroMemory(void* memory, size_t size) {
     return memset(memory, 0, size);
 }
 
+void* Platform::VAlloc(size_t size) {
+    void* memory = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+
+    if (!memory) {
+        LOG_WARNING("Platform::VAlloc: failed to allocate %zu bytes", size);
+    }
+
+    return memory;
+}
+
+void Platform::VFree(void* memory, size_t size) {
+    if (memory) {
+        VirtualFree(memory, 0, MEM_RELEASE);
+    }
+}
+
+void* Platform::VReserve(size_t size, bool hugePages) {
+    // Large pages need SeLockMemoryPrivilege and can't be committed on demand, so hugePages is ignored here.
+    void* memory = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+
+    if (!memory) {
+        LOG_WARNING("Platform::VReserve: failed to reserve %zu bytes", size);
+    }
+
+    return memory;
+}
+
+bool Platform::VCommit(void* memory, size_t size) {
+    if (!VirtualAlloc(memory, size, MEM_COMMIT, PAGE_READWRITE)) {
+        LOG_WARNING("Platform::VCommit: failed to commit %zu bytes", size);
+        return false;
+    }
+
+    return true;
+}
+
+void Platform::VDecommit(void* memory, size_t size) {
+    VirtualFree(memory, size, MEM_DECOMMIT);
+}
+
+void Platform::VRelease(void* memory, size_t size) {
+    if (memory) {
+        VirtualFree(memory, 0, MEM_RELEASE);
+    }
+}
+
 void Platform::Log(log_level level, const char* message) {
-    static constexpr WORD colors[] = { 207, 14, 10, 8 };
+    LogLine line{ message, (uint32_t)strlen(message), level };
+    WriteLogConsole(&line, 1);
+}
+
+void Platform::WriteLogConsole(const LogLine* lines, uint32_t count) {
+    static constexpr WORD colors[] = { 207, 14, 8, 10 };
 
     HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD written = 0;
+
+    // The console colors are set per call, consecutive lines of the same level share one.
+    for (uint32_t i = 0; i < count; i++) {
+        if (i == 0 || lines[i].level != lines[i - 1].level) {
+            SetConsoleTextAttribute(handle, colors[lines[i].level]);
+        }
+        WriteFile(handle, lines[i].message, lines[i].size, &written, nullptr);
+        WriteFile(handle, "\n", 1, &written, nullptr);
+    }
 
-    SetConsoleTextAttribute(handle, colors[level]);
-    printf("%s\n", message);
     SetConsoleTextAttribute(handle, 15);
 }
 
+HANDLE Platform::OpenLogFile(const char* path) {
+    HANDLE file = CreateFileA(path, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    return file == INVALID_HANDLE_VALUE ? nullptr : file;
+}
+
+void Platform::CloseLogFile(HANDLE file) {
+    if (file) {
+        CloseHandle(file);
+    }
+}
+
+uint64_t Platform::WriteLogFile(HANDLE file, const LogLine* lines, uint32_t count) {
+    uint64_t total = 0;
+    DWORD written = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (WriteFile(file, lines[i].message, lines[i].size, &written, nullptr)) {
+            total += written;
+        }
+        if (WriteFile(file, "\r\n", 2, &written, nullptr)) {
+            total += written;
+        }
+    }
+
+    return total;
+}
+
+bool Platform::RenameFile(const char* source, const char* destination) {
+    return MoveFileExA(source, destination, MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
+void* Platform::MapFile(const char* path, uint64_t size) {
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        LOG_WARNING("Platform::MapFile: failed to open %s", path);
+        return nullptr;
+    }
+
+    // Mapping more than the file holds grows it, the new bytes are zero.
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)size, nullptr);
+    void* memory = mapping ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size) : nullptr;
+
+    // The view keeps the mapping and the file alive.
+    if (mapping) {
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+
+    if (!memory) {
+        LOG_WARNING("Platform::MapFile: failed to map %s", path);
+    }
+
+    return memory;
+}
+
+void Platform::UnmapFile(void* memory, uint64_t size) {
+    if (memory) {
+        UnmapViewOfFile(memory);
+    }
+}
+
 void* Platform::LoadLibrary(const char* libraryPath) {
     char library_name[1024]{};
 
@@ -147,14 +318,14 @@ void* Platform::LoadLibrary(const char* libraryPath) {
     path_size = GetCurrentDirectoryA(path_size, nullptr);
 
     if (path_size == 0) {
-        Logger::Warning("Failed to get current directory while trying to read binary in %s", libraryPath);
+        LOG_WARNING("Failed to get current directory while trying to read binary in %s", libraryPath);
         return false;
     }
 
     list<char> path(path_size);
 
     if (GetCurrentDirectoryA(path_size, path.data()) == 0) {
-        Logger::Warning("Failed to get current directory while trying to read binary in %s", libraryPath);
+        LOG_WARNING("Failed to get current directory while trying to read binary in %s", libraryPath);
         return false;
     }
 
@@ -162,7 +333,7 @@ void* Platform::LoadLibrary(const char* libraryPath) {
 
     void* library = LoadLibraryA(library_name);
     
-    Logger::Warning("Failed to load library %s", library_name);
+    LOG_WARNING("Failed to load library %s", library_name);
 
     return library;
 }
@@ -179,7 +350,7 @@ void* Platform::create_vulkan_surface(Window* window, void* instance) {
     VkSurfaceKHR surface = 0;
 
     if (SDL_Vulkan_CreateSurface((SDL_Window*)window->get_internal_handle(), (VkInstance)instance, &surface) != SDL_TRUE) {
-        Logger::Fatal("Failed to create vulkan surface");
+        LOG_FATAL("Failed to create vulkan surface");
         return nullptr;
     }
 
@@ -198,18 +369,18 @@ binary_info Platform::ReadBinary(const char* path) {
     );
 
     if (!file) {
-        Logger::Warning("Failed to open file %s", path);
+        LOG_WARNING("Failed to open file %s", path);
         return {};
     }
 
     int64_t size = 0;
     if (!GetFileSizeEx(file, (PLARGE_INTEGER)&size)) {
-        Logger::Warning("Failed to get file size of %s", path);
+        LOG_WARNING("Failed to get file size of %s", path);
         CloseHandle(file);
         return {};
     }
 
-    char* buffer = (char*)Platform::UAlloc(size);
+    char* buffer = (char*)Platform::UAllocUninitialized(size, MemoryTag::Asset);
 
     DWORD bytes_read;
 
@@ -220,7 +391,7 @@ binary_info Platform::ReadBinary(const char* path) {
         &bytes_read,
         nullptr
     )) {
-        Logger::Warning("Failed to read file %s");
+        LOG_WARNING("Failed to read file %s");
         CloseHandle(file);
         return {};
     }
@@ -247,4 +418,13 @@ int64_t Platform::GetTime() {
     return (now * 1000000000ui64) / performance_frequency;
 }
 
+LinearAllocator& Platform::GetFrameAllocator() {
+    return *platform_ptr->m_FrameAllocators[platform_ptr->m_FrameAllocatorIndex];
+}
+
+void Platform::AdvanceFrameAllocator() {
+    platform_ptr->m_FrameAllocatorIndex ^= 1;
+    platform_ptr->m_FrameAllocators[platform_ptr->m_FrameAllocatorIndex]->Reset();
+}
+
 #endif
\ No newline at end of file
@@ -1,12 +1,22 @@
+#pragma once
+
+#include "defines.h"
+#include "core/string.h"
+
 #include <exception>
 
 class RAPI RendererException : public std::exception {
 public:
-    RendererException(const char* error, ...);
+    template<typename... Args>
+    RendererException(const char* format, const Args&... args) : RendererException(String::Format(format, args...)) {}
     virtual ~RendererException();
 
-    virtual const char* what() const noexcept { return m_What; }
+    virtual const char* what() const noexcept { return m_What.CStr(); }
+
+private:
+    /* Logs the message as fatal. */
+    explicit RendererException(String&& what);
 
 private:
-    char* m_What;
+    String m_What;
 };
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "renderer_frontend.h"
 
+#include "core/image.h"
+#include "core/logger.h"
+
 bool RendererFrontend::DrawFrame(const RenderPacket& renderPacket) {
 	if (m_Backend.BeginFrame(renderPacket.deltaTime)) {
 		if (!m_Backend.EndFrame(renderPacket.deltaTime)) {
@@ -9,5 +12,52 @@ bool RendererFrontend::DrawFrame(const RenderPacket& renderPacket) {
 		return false;
 	}
 
+	return true;
+}
+
+Handle<Texture> RendererFrontend::CreateTexture(const Image& image) {
+	Texture texture = {};
+	texture.width = image.width;
+	texture.height = image.height;
+	texture.channelCount = image.channelCount;
+
+	return m_Textures.insert(texture);
+}
+
+void RendererFrontend::DestroyTexture(Handle<Texture> texture) {
+	if (!m_Textures.erase(texture)) {
+		LOG_WARNING("RendererFrontend::DestroyTexture: stale texture handle (%u, %u)", texture.index, texture.generation);
+	}
+}
+
+Handle<RenderItem> RendererFrontend::CreateRenderItem(const RenderItemCreateInfo& createInfo) {
+	if (createInfo.texture.IsValid() && !m_Textures.contains(createInfo.texture)) {
+		LOG_WARNING("RendererFrontend::CreateRenderItem: stale texture handle (%u, %u)", createInfo.texture.index, createInfo.texture.generation);
+		return {};
+	}
+
+	RenderItem renderItem = {};
+	renderItem.verticesCount = createInfo.verticesCount;
+	renderItem.indicesCount = createInfo.indicesCount;
+	renderItem.texture = createInfo.texture;
+	DirectX::XMStoreFloat4x4(&renderItem.model, DirectX::XMMatrixIdentity());
+
+	return m_RenderItems.insert(renderItem);
+}
+
+void RendererFrontend::DestroyRenderItem(Handle<RenderItem> renderItem) {
+	if (!m_RenderItems.erase(renderItem)) {
+		LOG_WARNING("RendererFrontend::DestroyRenderItem: stale render item handle (%u, %u)", renderItem.index, renderItem.generation);
+	}
+}
+
+bool RendererFrontend::UpdateRenderItem(Handle<RenderItem> renderItem, const GeometryRenderData* renderData) {
+	RenderItem* item = m_RenderItems.get(renderItem);
+	if (!item) {
+		return false;
+	}
+
+	item->model = renderData->model;
+
 	return true;
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 
 #include "renderer/renderer_backend.h"
 #include "renderer/renderer_types.inl"
+#include "containers/handle_pool.h"
+
+struct Image;
 
 class RendererFrontend {
 public:
@@ -15,6 +18,18 @@ public:
 	bool DrawFrame(const RenderPacket& renderPacket);
     AINLINE void WaitDeviceIdle() { m_Backend.WaitDeviceIdle(); }
 
+	Handle<Texture> CreateTexture(const Image& image);
+	void DestroyTexture(Handle<Texture> texture);
+	AINLINE const Texture* GetTexture(Handle<Texture> texture) const { return m_Textures.get(texture); }
+
+	/* Returns an invalid handle if createInfo references a texture that was destroyed. */
+	Handle<RenderItem> CreateRenderItem(const RenderItemCreateInfo& createInfo);
+	void DestroyRenderItem(Handle<RenderItem> renderItem);
+	bool UpdateRenderItem(Handle<RenderItem> renderItem, const GeometryRenderData* renderData);
+	AINLINE const RenderItem* GetRenderItem(Handle<RenderItem> renderItem) const { return m_RenderItems.get(renderItem); }
+
 private:
 	RendererBackend& m_Backend;
+	handle_pool<Texture> m_Textures;
+	handle_pool<RenderItem> m_RenderItems;
 };
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "defines.h"
+#include "containers/handle_pool.h"
+
 #include <DirectXMath.h>
 
 enum class RendererType : char {
@@ -20,6 +22,13 @@ struct GlobalUniformBuffer {
     DirectX::XMFLOAT4X4 view;
 };
 
+struct Texture {
+    uint32_t width;
+    uint32_t height;
+    uint32_t channelCount;
+    HANDLE internalData;
+};
+
 struct RenderItemCreateInfo {
     uint64_t vertexSize;
     HANDLE pVertices;
@@ -27,7 +36,7 @@ struct RenderItemCreateInfo {
     uint64_t indexSize;
     HANDLE pIndices;
     uint32_t indicesCount;
-    HANDLE texture;
+    Handle<Texture> texture;
 };
 
 enum FrameStatus {
@@ -51,6 +60,14 @@ struct GeometryRenderData {
     HANDLE textures[16];
 };
 
+struct RenderItem {
+    uint32_t verticesCount;
+    uint32_t indicesCount;
+    Handle<Texture> texture;
+    DirectX::XMFLOAT4X4 model;
+    HANDLE internalData;
+};
+
 struct RenderPacket {
     float deltaTime;
 };
\ No newline at end of file
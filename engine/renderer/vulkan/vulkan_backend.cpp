@@ -2,6 +2,7 @@
 
 #include "core/logger.h"
 #include "core/string.h"
+#include "core/string_id.h"
 #include "platform/platform.h"
 
 #include "vulkan_device.h"
@@ -11,7 +12,7 @@
 VulkanBackend::VulkanBackend(const char* applicationName, const Window& window) 
 	:
 	RendererBackend(applicationName, window) {
-	Logger::Info("Initializing Vulkan backend");
+	LOG_INFO("Initializing Vulkan backend");
 
 	VkApplicationInfo app_info = { VK_STRUCTURE_TYPE_APPLICATION_INFO };
 	app_info.apiVersion = VK_API_VERSION_1_2;
@@ -26,19 +27,19 @@ VulkanBackend::VulkanBackend(const char* applicationName, const Window& window)
 	instance_create_info.pNext = &debugUtilsCreateInfo;
 	instance_create_info.pApplicationInfo = &app_info;
 
-	list<const char*> requiredExtensions = Platform::GetRequiredExtensionNames(m_Window);
+	small_list<const char*, 8> requiredExtensions = Platform::GetRequiredExtensionNames(m_Window);
 
 #ifdef DEBUG
 	requiredExtensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 	requiredExtensions.push_back("VK_EXT_debug_utils");
 
-	Logger::Debug("Required extensions:");
+	LOG_DEBUG("Required extensions:");
 	for (const char* requiredExtension : requiredExtensions) {
-		Logger::Debug("\t%s", requiredExtension);
+		LOG_DEBUG("\t%s", requiredExtension);
 	}
 
 	// Validation layers.
-	list<const char*> requiredLayers = GetRequiredInstanceLayers();
+	small_list<const char*, 4> requiredLayers = GetRequiredInstanceLayers();
 	
 	instance_create_info.enabledLayerCount = requiredLayers.size_u32();
 	instance_create_info.ppEnabledLayerNames = requiredLayers.data();
@@ -58,7 +59,7 @@ VulkanBackend::VulkanBackend(const char* applicationName, const Window& window)
 	if (func) {
 		func(m_Instance, &debugUtilsCreateInfo, m_Allocator, &m_Messenger);
 	}
-	Logger::Debug("Vulkan debugger created");
+	LOG_DEBUG("Vulkan debugger created");
 #endif
 
 	m_Surface = (VkSurfaceKHR)Platform::CreateVulkanSurface(&m_Window, m_Instance);
@@ -67,14 +68,14 @@ VulkanBackend::VulkanBackend(const char* applicationName, const Window& window)
 		throw RendererException("Failed to create vulkan surface");
 	}
 
-	m_Device = Platform::Construct<VulkanDevice>(this);
+	m_Device = Platform::Construct<VulkanDevice, MemoryTag::Renderer>(this);
 	uint32_t width, height;
 	m_Window.GetDimensions(&width, &height);
-	m_Swapchain = Platform::Construct<VulkanSwapchain>(this, m_Device, VulkanSwapchainExtent{ width, height });
+	m_Swapchain = Platform::Construct<VulkanSwapchain, MemoryTag::Renderer>(this, m_Device, VulkanSwapchainExtent{ width, height });
 }
 
 VulkanBackend::~VulkanBackend() {
-	Logger::Info("Destroying Vulkan backend");
+	LOG_INFO("Destroying Vulkan backend");
 	Platform::Destroy(m_Swapchain);
 	Platform::Destroy(m_Device);
 	vkDestroySurfaceKHR(m_Instance, m_Surface, m_Allocator);
@@ -86,7 +87,7 @@ VulkanBackend::~VulkanBackend() {
 	if (func) {
 		func(m_Instance, m_Messenger, m_Allocator);
 	}
-	Logger::Debug("Vulkan debugger destroyed");
+	LOG_DEBUG("Vulkan debugger destroyed");
 #endif
 	vkDestroyInstance(m_Instance, m_Allocator);
 }
@@ -129,23 +130,23 @@ VkBool32 VulkanBackend::PrintDebugLayer(
 	
 	switch (messageSeverity) {
 		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT: {
-			Logger::Fatal("%s", pCallbackData->pMessage);
+			LOG_FATAL("%s", pCallbackData->pMessage);
 			break;
 		}
 		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT: {
-			Logger::Warning("%s", pCallbackData->pMessage);
+			LOG_WARNING("%s", pCallbackData->pMessage);
 			break;
 		}
 		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT: {
-			Logger::Debug("%s", pCallbackData->pMessage);
+			LOG_DEBUG("%s", pCallbackData->pMessage);
 			break;
 		}
 		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT: {
-			Logger::Info("%s", pCallbackData->pMessage);
+			LOG_INFO("%s", pCallbackData->pMessage);
 			break;
 		}
 		default: {
-			Logger::Info("%s", pCallbackData->pMessage);
+			LOG_INFO("%s", pCallbackData->pMessage);
 			break;
 		}
 	}
@@ -153,8 +154,8 @@ VkBool32 VulkanBackend::PrintDebugLayer(
 	return true;
 }
 
-list<const char*> VulkanBackend::GetRequiredInstanceLayers() {
-	list<const char*> requiredLayers;
+small_list<const char*, 4> VulkanBackend::GetRequiredInstanceLayers() {
+	small_list<const char*, 4> requiredLayers;
 
 	requiredLayers.push_back("VK_LAYER_KHRONOS_validation");
 
@@ -164,20 +165,28 @@ list<const char*> VulkanBackend::GetRequiredInstanceLayers() {
 	supportedLayers.resize(supportedLayerCount);
 	VK_CHECK(vkEnumerateInstanceLayerProperties(&supportedLayerCount, supportedLayers.data()));
 
+	// Hash every supported name once, the search below only compares integers.
+	list<StringId> supportedLayerIds;
+	supportedLayerIds.reserve(supportedLayers.size());
+	for (const VkLayerProperties& supportedLayer : supportedLayers) {
+		supportedLayerIds.push_back(StringId(supportedLayer.layerName));
+	}
+
 	for (const char* requiredLayer : requiredLayers) {
-		Logger::Info("Searching for layer: %s", requiredLayer);
+		LOG_INFO("Searching for layer: %s", requiredLayer);
+		StringId requiredLayerId(requiredLayer);
 		bool found = false;
 
-		for (const VkLayerProperties& supportedLayer : supportedLayers) {
-			if (String::StringEqual(requiredLayer, supportedLayer.layerName)) {
+		for (StringId supportedLayerId : supportedLayerIds) {
+			if (supportedLayerId == requiredLayerId) {
 				found = true;
-				Logger::Info("%s Found", requiredLayer);	
+				LOG_INFO("%s Found", requiredLayer);	
 				break;
 			}
 		}
 
 		if (!found) {
-			Logger::Fatal("Required instance layer %s is not supported!", requiredLayer);
+			LOG_FATAL("Required instance layer %s is not supported!", requiredLayer);
 			uint32_t foundIndex = requiredLayers.find_index(requiredLayer);
 
 			if (foundIndex != -1) {
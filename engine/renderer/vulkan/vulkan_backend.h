@@ -4,6 +4,7 @@
 #include "vulkan_types.inl"
 
 #include "containers/list.h"
+#include "containers/small_list.h"
 
 class VulkanDevice;
 class VulkanSwapchain;
@@ -32,7 +33,7 @@ private:
 		void* pUserData);
 	static VkDebugUtilsMessengerCreateInfoEXT GetDebugMessengerCreateInfo();
 
-	list<const char*> GetRequiredInstanceLayers();
+	small_list<const char*, 4> GetRequiredInstanceLayers();
 
 private:
 	VkAllocationCallbacks* m_Allocator = nullptr;
@@ -2,6 +2,8 @@
 
 #include "core/logger.h"
 #include "core/string.h"
+#include "core/string_id.h"
+#include "containers/small_list.h"
 #include "vulkan_backend.h"
 
 #if defined (PLATFORM_LINUX) || defined(PLATFORM_MAC)
@@ -15,13 +17,13 @@
 #endif
 
 VulkanDevice::VulkanDevice(const VulkanBackend* backend) : backend(backend) {
-	Logger::Info("Creating Vulkan Device");
+	LOG_INFO("Creating Vulkan Device");
 	ChoosePhysicalDevice();
 	CreateLogicalDevice();
 }
 
 VulkanDevice::~VulkanDevice() {
-	Logger::Info("Destroying Vulkan Device");
+	LOG_INFO("Destroying Vulkan Device");
 	vkDestroyDevice(m_LogicalDevice, backend->GetVulkanAllocator());
 	m_LogicalDevice = VK_NULL_HANDLE;
 	m_TransferQueue = VK_NULL_HANDLE;
@@ -101,7 +103,7 @@ void VulkanDevice::ChoosePhysicalDevice() {
 			requirements, 
 			queueFamilyIndices, 
 			swapchainSupport)) {
-			Logger::Info("%s does not meet physical device requirements", properties.deviceName);
+			LOG_INFO("%s does not meet physical device requirements", properties.deviceName);
 			continue;
 		}
 
@@ -112,11 +114,11 @@ void VulkanDevice::ChoosePhysicalDevice() {
 		m_QueueFamilyIndices = queueFamilyIndices;
 		m_SwapchainSupport = swapchainSupport;
 
-		Logger::Info("Selected Device %s", properties.deviceName);
-		Logger::Info("Graphics Queue Index: %d", m_QueueFamilyIndices.graphicsQueueFamilyIndex);
-		Logger::Info("Transfer Queue Index: %d", m_QueueFamilyIndices.transferQueueFamilyIndex);
-		Logger::Info("Compute Queue Index: %d", m_QueueFamilyIndices.computeQueueFamilyIndex);
-		Logger::Info("Present Queue Index: %d", m_QueueFamilyIndices.presentQueueFamilyIndex);
+		LOG_INFO("Selected Device %s", properties.deviceName);
+		LOG_INFO("Graphics Queue Index: %d", m_QueueFamilyIndices.graphicsQueueFamilyIndex);
+		LOG_INFO("Transfer Queue Index: %d", m_QueueFamilyIndices.transferQueueFamilyIndex);
+		LOG_INFO("Compute Queue Index: %d", m_QueueFamilyIndices.computeQueueFamilyIndex);
+		LOG_INFO("Present Queue Index: %d", m_QueueFamilyIndices.presentQueueFamilyIndex);
 		break;
 	}
 	
@@ -131,7 +133,7 @@ void VulkanDevice::CreateLogicalDevice() {
 	bool transferSharesGraphicsQueue = 
 		m_QueueFamilyIndices.transferQueueFamilyIndex == m_QueueFamilyIndices.graphicsQueueFamilyIndex;
 
-	list<uint32_t> indices;
+	small_list<uint32_t, 3> indices;
 	indices.push_back(m_QueueFamilyIndices.graphicsQueueFamilyIndex);
 
 	if (!presentSharesGraphicsQueue) [[unlikely]] {
@@ -142,7 +144,7 @@ void VulkanDevice::CreateLogicalDevice() {
 		indices.push_back(m_QueueFamilyIndices.transferQueueFamilyIndex);
 	}
 
-	list<VkDeviceQueueCreateInfo> queueCreateInfos;
+	small_list<VkDeviceQueueCreateInfo, 3> queueCreateInfos;
 	queueCreateInfos.resize(indices.size());
 
 	for (uint32_t i = 0; i < indices.size_u32(); i++) {
@@ -161,7 +163,7 @@ void VulkanDevice::CreateLogicalDevice() {
 	VkPhysicalDeviceFeatures requestFeatures{};
 	requestFeatures.samplerAnisotropy = VK_TRUE;
 
-	list<const char*> deviceExtensions;
+	small_list<const char*, 4> deviceExtensions;
 	deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
 	VkDeviceCreateInfo createInfo = { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
@@ -261,12 +263,12 @@ bool VulkanDevice::PhysicalDeviceMeetsRequirements(
 	outQueueFamilyIndices = VulkanQueueFamilyIndices();
 
 	if (requirements.discreteGpu && properties.deviceType != VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) {
-		Logger::Info("%s is not a discrete GPU!", properties.deviceName);
+		LOG_INFO("%s is not a discrete GPU!", properties.deviceName);
 		return false;
 	}
 
 	if (requirements.samplerAnisotropy && !features.samplerAnisotropy) {
-		Logger::Info("%s does not support Sampler Anisotropy!", properties.deviceName);
+		LOG_INFO("%s does not support Sampler Anisotropy!", properties.deviceName);
 		return false;
 	}
 
@@ -277,7 +279,7 @@ bool VulkanDevice::PhysicalDeviceMeetsRequirements(
 	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
 	
 	if (queueFamilyCount == 0) {
-		Logger::Warning("%s does not have any queue families. Does this device really supports Vulkan?");
+		LOG_WARNING("%s does not have any queue families. Does this device really supports Vulkan?", properties.deviceName);
 		return false;
 	}
 
@@ -317,7 +319,7 @@ bool VulkanDevice::PhysicalDeviceMeetsRequirements(
 			"\t** Compute: %s\n"
 			"\t** Transfer: %s\n";
 			
-	Logger::Debug(
+	LOG_DEBUG(
 		format,
 		properties.deviceName,
 		outQueueFamilyIndices.graphicsQueueFamilyIndex != -1 ? "true" : "false",
@@ -327,29 +329,29 @@ bool VulkanDevice::PhysicalDeviceMeetsRequirements(
 	);
 
 	if (requirements.graphics && outQueueFamilyIndices.graphicsQueueFamilyIndex == -1) {
-		Logger::Warning("Graphics Queue required but no graphics queue index was found");
+		LOG_WARNING("Graphics Queue required but no graphics queue index was found");
 		return false;
 	}
 
 	if (requirements.compute && outQueueFamilyIndices.computeQueueFamilyIndex == -1) {
-		Logger::Warning("Compute Queue required but no compute queue index was found");
+		LOG_WARNING("Compute Queue required but no compute queue index was found");
 		return false;
 	}
 
 	if (requirements.present && outQueueFamilyIndices.presentQueueFamilyIndex == -1) {
-		Logger::Warning("Present Queue required but no present queue index was found");
+		LOG_WARNING("Present Queue required but no present queue index was found");
 		return false;
 	}
 
 	if (requirements.transfer && outQueueFamilyIndices.transferQueueFamilyIndex == -1) {
-		Logger::Warning("Transfer Queue required but no transfer queue index was found");
+		LOG_WARNING("Transfer Queue required but no transfer queue index was found");
 		return false;
 	}
 
 	outSwapchainSupportInfo = QuerySwapchainSupport(physicalDevice, surface);
 
 	if (outSwapchainSupportInfo.formats.is_empty() || outSwapchainSupportInfo.presentModes.is_empty()) {
-		Logger::Info("Required formats or present modes are not supported by %s", properties.deviceName);
+		LOG_INFO("Required formats or present modes are not supported by %s", properties.deviceName);
 		return false;
 	}
 
@@ -371,17 +373,24 @@ bool VulkanDevice::PhysicalDeviceMeetsRequirements(
 			&supportedExtensionCount, 
 			supportedExtensions.data()));
 
+		list<StringId> supportedExtensionIds;
+		supportedExtensionIds.reserve(supportedExtensions.size());
+		for (const VkExtensionProperties& supportedExtension : supportedExtensions) {
+			supportedExtensionIds.push_back(StringId(supportedExtension.extensionName));
+		}
+
 		for (const char* requiredExtension : requirements.deviceExtensionNames) {
+			StringId requiredExtensionId(requiredExtension);
 			bool found = false;
-			for (const VkExtensionProperties& supportedExtension : supportedExtensions) {
-				if (String::StringEqual(requiredExtension, supportedExtension.extensionName)) {
+			for (StringId supportedExtensionId : supportedExtensionIds) {
+				if (supportedExtensionId == requiredExtensionId) {
 					found = true;
 					break;
 				}
 			}
 
 			if (!found) {
-				Logger::Info("Required extension %s was not found in device %s, skipping...", requiredExtension, properties.deviceName);
+				LOG_INFO("Required extension %s was not found in device %s, skipping...", requiredExtension, properties.deviceName);
 				return false;
 			}
 		}
@@ -13,7 +13,7 @@ VulkanSwapchain::VulkanSwapchain(const VulkanBackend* backend, const VulkanDevic
 	: 
 	m_Backend(backend),
 	m_Device(device) {
-	Logger::Info("Creating Vulkan Swapchain");
+	LOG_INFO("Creating Vulkan Swapchain");
 	CreateSwapchain(extent);
 
 	if (m_Swapchain == nullptr) {
@@ -24,7 +24,7 @@ VulkanSwapchain::VulkanSwapchain(const VulkanBackend* backend, const VulkanDevic
 }
 
 VulkanSwapchain::~VulkanSwapchain() {
-	Logger::Info("Destroying Vulkan Swapchain");
+	LOG_INFO("Destroying Vulkan Swapchain");
 	DestroySwapchain();
 }
 
@@ -141,28 +141,28 @@ void VulkanSwapchain::CreateSwapchain(VulkanSwapchainExtent extent) {
 		&surfaceCapabilities);
 
 	if (extent.width > surfaceCapabilities.maxImageExtent.width) {
-		Logger::Info(
+		LOG_INFO(
 			"Width of %u is bigger than the maximum supported by the GPU, decreasing to %u...", 
 			extent.width, 
 			surfaceCapabilities.maxImageExtent.width);
 		extent.width = surfaceCapabilities.maxImageExtent.width;
 	}
 	if (extent.height > surfaceCapabilities.maxImageExtent.height) {
-		Logger::Info(
+		LOG_INFO(
 			"Height of %u is bigger than the maximum supported by the GPU, decreasing to %u...", 
 			extent.height, 
 			surfaceCapabilities.maxImageExtent.height);
 		extent.height = surfaceCapabilities.maxImageExtent.height;
 	}
 	if (extent.width < surfaceCapabilities.minImageExtent.width) {
-		Logger::Info(
+		LOG_INFO(
 			"Width of %u is smaller than the minimum supported by the GPU, increasing to %u...", 
 			extent.width, 
 			surfaceCapabilities.minImageExtent.width);
 		extent.width = surfaceCapabilities.minImageExtent.width;
 	}
 	if (extent.height < surfaceCapabilities.maxImageExtent.height) {
-		Logger::Info(
+		LOG_INFO(
 			"Height of %u is smaller than the minimum supported by the GPU, increasing to %u...", 
 			extent.height, 
 			surfaceCapabilities.minImageExtent.height);
@@ -246,7 +246,7 @@ void VulkanSwapchain::CreateSwapchain(VulkanSwapchainExtent extent) {
 		depthAspect = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
 	}
 
-	m_DepthImage = Platform::Construct<VulkanImage>(
+	m_DepthImage = Platform::Construct<VulkanImage, MemoryTag::Renderer>(
 		m_Backend,
 		VK_IMAGE_TYPE_2D,
 		createInfo.imageExtent.width,
@@ -55,7 +55,7 @@ int Window::ProcessMessages() {
 
 void Window::GetDimensions(uint32_t* width, uint32_t* height) const {
     if (!width || !height) {
-        Logger::Warning("Window::GetDimensions: width or height are nullptr");
+        LOG_WARNING("Window::GetDimensions: width or height are nullptr");
         return;
     }
 
@@ -67,7 +67,7 @@ bool Window::ConfineCursorToWindow() {
     int result = SDL_SetRelativeMouseMode(SDL_TRUE);
 
     if (result) {
-        Logger::Warning("Failed to confine cursor to Window: %s", SDL_GetError());
+        LOG_WARNING("Failed to confine cursor to Window: %s", SDL_GetError());
         return false;
     }
 
@@ -80,7 +80,7 @@ bool Window::FreeCursorFromWindow() {
     int result = SDL_SetRelativeMouseMode(SDL_FALSE);
 
     if (result) {
-        Logger::Warning("Failed to free cursor from Window: %s", SDL_GetError());
+        LOG_WARNING("Failed to free cursor from Window: %s", SDL_GetError());
         return false;
     }
 
@@ -116,7 +116,7 @@ void Window::process_window_messages(const void* pEvent) {
                 eventData.width = m_Width;
                 eventData.height = m_Height;
 
-                IEvent::FireEvent(EventType::WindowResized, &eventData);
+                EventChannel<WindowResizedEventData>::Queue(eventData);
             }
             break;
         }
@@ -132,14 +132,14 @@ void Window::process_key_event(const void* pKey, bool pressed) {
     eventData.Key = (Key)key.scancode;
     eventData.Pressed = pressed;
 
-    IEvent::FireEvent(EventType::KeyboardEvent, &eventData);
+    EventChannel<KeyboardEventData>::Queue(eventData);
 }
 
 void Window::process_mouse_motion(const void* pMotion) {
     const SDL_MouseMotionEvent& event = *(SDL_MouseMotionEvent*)pMotion;
 
-    // Logger::Warning("Mouse coordinates | Mouse Relative");
-    // Logger::Warning("%i %i             | %i %i", event.x, event.y, event.xrel, event.yrel);
+    // LOG_WARNING("Mouse coordinates | Mouse Relative");
+    // LOG_WARNING("%i %i             | %i %i", event.x, event.y, event.xrel, event.yrel);
 
     MouseEventData eventData;
     eventData.MouseXMotion = event.xrel;
@@ -147,7 +147,7 @@ void Window::process_mouse_motion(const void* pMotion) {
     eventData.MouseXScreen = event.x;
     eventData.MouseYScreen = event.y;
 
-    IEvent::FireEvent(EventType::MouseMoved, &eventData);
+    EventChannel<MouseEventData>::Queue(eventData);
 }
 
 void Window::process_mouse_confinment() {
@@ -7,6 +7,10 @@
 #include <window/window.h>
 #include <core/image_loader.h>
 #include <core/image.h>
+#include <ecs/components.h>
+#include <ecs/registry.h>
+#include <ecs/world.h>
+#include <renderer/renderer_frontend.h>
 
 #include <cstdint>
 #include <cstring>
@@ -23,13 +27,14 @@ Game::Game(const Application* application)
 	m_Application(application) {}
 
 Game::~Game() {
-	Logger::Debug("Destroying game instance");
+	LOG_DEBUG("Destroying game instance");
 }
 
 void Game::OnBegin() {
-	Logger::Debug("OnBegin");
+	LOG_DEBUG("OnBegin");
 
     CreateTestPlane();
+    CreateInstances();
 }
 
 void Game::OnUpdate(float deltaTime) {
@@ -55,22 +60,104 @@ void Game::OnUpdate(float deltaTime) {
     //     }
     // }
 
-    // GeometryRenderData render_data;
+    UpdateInstanceTransforms(deltaTime);
 
-    // static float time = 0.0f;
-    // time += deltaTime;
+    Registry* registry = m_Application->GetRegistry();
+    RendererFrontend* renderer = m_Application->GetRenderer();
 
-    // DirectX::XMStoreFloat4x4(&render_data.model, DirectX::XMMatrixRotationRollPitchYaw(0.0f, 0.0f, time));
+    if (TransformComponent* transform = registry->GetComponent<TransformComponent>(m_TestPlane)) {
+        transform->rotation.z += deltaTime;
+    }
 
-    // m_Application->GetRenderer()->UpdateRenderItem(m_RenderItem[0], &render_data);
+    registry->GetView<TransformComponent, RenderItemComponent>().Each(
+        [renderer](Entity entity, TransformComponent& transform, RenderItemComponent& renderItem) {
+            using namespace DirectX;
+
+            XMMATRIX scale = XMMatrixScaling(transform.scale.x, transform.scale.y, transform.scale.z);
+            XMMATRIX rotation = XMMatrixRotationRollPitchYaw(transform.rotation.x, transform.rotation.y, transform.rotation.z);
+            XMMATRIX translation = XMMatrixTranslation(transform.position.x, transform.position.y, transform.position.z);
+
+            GeometryRenderData renderData{};
+            renderData.id = entity.index;
+            XMStoreFloat4x4(&renderData.model, XMMatrixMultiply(XMMatrixMultiply(scale, rotation), translation));
+
+            renderer->UpdateRenderItem(renderItem.renderItem, &renderData);
+        });
 }
 
 void Game::OnShutdown() {
-	Logger::Debug("OnShutdown");
+	LOG_DEBUG("OnShutdown");
+
+	Registry* registry = m_Application->GetRegistry();
+
+	if (RenderItemComponent* renderItem = registry->GetComponent<RenderItemComponent>(m_TestPlane)) {
+		m_Application->GetRenderer()->DestroyRenderItem(renderItem->renderItem);
+	}
 
-	//RendererBackend* renderer = m_Application->GetRenderer();
+	registry->DestroyEntity(m_TestPlane);
 }
 
 void Game::CreateTestPlane() {
-	
+	static constexpr Vertex vertices[] = {
+		{ { -0.5f, -0.5f, 0.0f }, { 0.0f, 1.0f } },
+		{ {  0.5f, -0.5f, 0.0f }, { 1.0f, 1.0f } },
+		{ {  0.5f,  0.5f, 0.0f }, { 1.0f, 0.0f } },
+		{ { -0.5f,  0.5f, 0.0f }, { 0.0f, 0.0f } },
+	};
+	static constexpr uint32_t indices[] = { 0, 1, 2, 2, 3, 0 };
+
+	RenderItemCreateInfo createInfo{};
+	createInfo.vertexSize = sizeof(Vertex);
+	createInfo.pVertices = (HANDLE)vertices;
+	createInfo.verticesCount = (uint32_t)std::size(vertices);
+	createInfo.indexSize = sizeof(uint32_t);
+	createInfo.pIndices = (HANDLE)indices;
+	createInfo.indicesCount = (uint32_t)std::size(indices);
+	createInfo.texture = m_Texture;
+
+	Registry* registry = m_Application->GetRegistry();
+
+	m_TestPlane = registry->CreateEntity();
+	registry->AddComponent<TransformComponent>(m_TestPlane);
+	registry->AddComponent<RenderItemComponent>(m_TestPlane, RenderItemComponent{ m_Application->GetRenderer()->CreateRenderItem(createInfo) });
+}
+
+
+void Game::CreateInstances() {
+	static constexpr int32_t GRID_SIZE = 64;
+	static constexpr float SPACING = 2.0f;
+
+	World* world = m_Application->GetWorld();
+
+	for (int32_t z = 0; z < GRID_SIZE; z++) {
+		for (int32_t x = 0; x < GRID_SIZE; x++) {
+			TransformComponent transform;
+			transform.position = { (x - GRID_SIZE / 2) * SPACING, 0.0f, (z - GRID_SIZE / 2) * SPACING };
+
+			world->CreateEntity(transform, WorldMatrixComponent{});
+		}
+	}
 }
+
+void Game::UpdateInstanceTransforms(float deltaTime) {
+	World* world = m_Application->GetWorld();
+
+	world->Query<TransformComponent, WorldMatrixComponent>().ParallelForEachChunk(
+		[deltaTime](ChunkView<TransformComponent, WorldMatrixComponent>& chunk) {
+			using namespace DirectX;
+
+			TransformComponent* transforms = chunk.Get<TransformComponent>();
+			WorldMatrixComponent* matrices = chunk.Get<WorldMatrixComponent>();
+
+			for (uint32_t i = 0; i < chunk.GetCount(); i++) {
+				TransformComponent& transform = transforms[i];
+				transform.rotation.y += deltaTime;
+
+				XMMATRIX scale = XMMatrixScaling(transform.scale.x, transform.scale.y, transform.scale.z);
+				XMMATRIX rotation = XMMatrixRotationRollPitchYaw(transform.rotation.x, transform.rotation.y, transform.rotation.z);
+				XMMATRIX translation = XMMatrixTranslation(transform.position.x, transform.position.y, transform.position.z);
+
+				XMStoreFloat4x4(&matrices[i].world, XMMatrixMultiply(XMMatrixMultiply(scale, rotation), translation));
+			}
+		});
+}
\ No newline at end of file
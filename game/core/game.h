@@ -4,6 +4,9 @@
 #include <core/game_interface.h>
 
 #include <containers/list.h>
+#include <containers/handle_pool.h>
+#include <renderer/renderer_types.inl>
+#include <ecs/entity.h>
 
 class Application;
 
@@ -17,9 +20,13 @@ public:
 	virtual void OnShutdown() override;
 
 	void CreateTestPlane();
+	/* Spawns a grid of instances in the archetype world. */
+	void CreateInstances();
+	/* Chunks are updated in parallel on the job system, each one only touches its own rows. */
+	void UpdateInstanceTransforms(float deltaTime);
 
 private:
 	const Application* m_Application;
-	list<HANDLE> m_RenderItem;
-	HANDLE m_Texture;
+	Entity m_TestPlane;
+	Handle<Texture> m_Texture;
 };
\ No newline at end of file
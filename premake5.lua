@@ -10,6 +10,16 @@ elseif os.host() == "macosx" then
     platform_define = "PLATFORM_MAC"
 end 
 
+newoption {
+    trigger = "poison-memory",
+    description = "Fill uninitialized and freed engine allocations with debug patterns"
+}
+
+newoption {
+    trigger = "sanitize-thread",
+    description = "Build the engine and the tools with ThreadSanitizer (clang on Linux)"
+}
+
 workspace "StimplyEngine"
     configurations { "Debug", "Release" }
     startproject "Stimply-Game"
@@ -50,6 +60,13 @@ project "Stimply-Engine"
     -- defines for DirectXMath
     defines { "_XM_AVX2_INTRINSICS_", "_XM_AVX_INTRINSICS_", "_XM_SSE_INTRINSICS_", "_XM_SSE3_INTRINSICS_", "_XM_SSE4_INTRINSICS_", "_XM_FMA3_INTRINSICS_"  }
 
+    filter "options:poison-memory"
+        defines { "POISON_MEMORY" }
+
+    filter { "options:sanitize-thread", "system:linux" }
+        buildoptions { "-fsanitize=thread" }
+        linkoptions { "-fsanitize=thread" }
+
     filter "configurations:Debug"
         defines { "DEBUG", platform_define }
         debugdir "bin/Debug"
@@ -97,4 +114,158 @@ project "Stimply-Game"
     filter "configurations:Release"
         defines { platform_define }
         debugdir "bin/Release"
+        optimize "Full"
+
+project "Stimply-LogDecode"
+    kind "ConsoleApp"
+    language "C++"
+    if os.host() == "windows" then
+        cppdialect "c++17"
+        defines { "RAPI= ", "_CRT_SECURE_NO_WARNINGS" }
+        flags { "MultiProcessorCompile" }
+    elseif os.host() == "linux" then
+        defines { "RAPI= ", "_XM_NO_XMVECTOR_OVERLOADS_" }
+        cppdialect "gnu++17"
+        toolset "clang"
+    end
+    targetdir "bin/%{cfg.buildcfg}"
+
+    architecture("x86_64")
+    -- Only needs the file layout and the formatter, not the whole engine.
+    files { "tools/log_decode/**.cpp", "engine/core/binary_log.h", "engine/core/format.h", "engine/core/format.cpp", "engine/core/string_view.h", "engine/core/string_view.cpp" }
+
+    includedirs { "engine/", "vendor/DirectXMath/Inc" }
+
+    filter "configurations:Debug"
+        defines { "DEBUG", platform_define }
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { platform_define }
+        optimize "Full"
+
+project "Stimply-FormatTest"
+    kind "ConsoleApp"
+    language "C++"
+    if os.host() == "windows" then
+        cppdialect "c++17"
+        defines { "RAPI= ", "_CRT_SECURE_NO_WARNINGS" }
+        flags { "MultiProcessorCompile" }
+    elseif os.host() == "linux" then
+        defines { "RAPI= ", "_XM_NO_XMVECTOR_OVERLOADS_" }
+        cppdialect "gnu++17"
+        toolset "clang"
+    end
+    targetdir "bin/%{cfg.buildcfg}"
+
+    architecture("x86_64")
+    -- Compares the formatter against snprintf, exits with 1 on any difference.
+    files { "tools/format_test/**.cpp", "engine/core/format.h", "engine/core/format.cpp", "engine/core/string_view.h", "engine/core/string_view.cpp" }
+
+    includedirs { "engine/", "vendor/DirectXMath/Inc" }
+
+    filter "configurations:Debug"
+        defines { "DEBUG", platform_define }
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { platform_define }
+        optimize "Full"
+
+project "Stimply-QueueStress"
+    kind "ConsoleApp"
+    language "C++"
+    if os.host() == "windows" then
+        cppdialect "c++17"
+        defines { "RAPI=__declspec(dllimport)", "_CRT_SECURE_NO_WARNINGS" }
+        flags { "MultiProcessorCompile" }
+    elseif os.host() == "linux" then
+        defines { "RAPI= ", "_XM_NO_XMVECTOR_OVERLOADS_" }
+        cppdialect "gnu++17"
+        toolset "clang"
+    end
+    targetdir "bin/%{cfg.buildcfg}"
+
+    architecture("x86_64")
+    -- Stress checks for mpmc_queue and spsc_queue plus a throughput benchmark, run it with --sanitize-thread too.
+    files { "tools/queue_stress/**.cpp" }
+
+    links { "Stimply-Engine" }
+
+    includedirs { "engine/", "vendor/DirectXMath/Inc" }
+
+    filter { "options:sanitize-thread", "system:linux" }
+        buildoptions { "-fsanitize=thread" }
+        linkoptions { "-fsanitize=thread" }
+
+    filter "configurations:Debug"
+        defines { "DEBUG", platform_define }
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { platform_define }
+        optimize "Full"
+
+project "Stimply-Benchmarks"
+    kind "ConsoleApp"
+    language "C++"
+    if os.host() == "windows" then
+        cppdialect "c++17"
+        defines { "RAPI=__declspec(dllimport)", "_CRT_SECURE_NO_WARNINGS" }
+        flags { "MultiProcessorCompile" }
+    elseif os.host() == "linux" then
+        defines { "RAPI= ", "_XM_NO_XMVECTOR_OVERLOADS_" }
+        cppdialect "gnu++17"
+        toolset "clang"
+        buildoptions {
+            "-mavx2",
+            "-mfma"
+        }
+    end
+    targetdir "bin/%{cfg.buildcfg}"
+
+    architecture("x86_64")
+    -- Engine containers and parsers against the standard library, only the Release numbers are meaningful.
+    files { "tools/benchmarks/**.cpp", "tools/benchmarks/**.h" }
+
+    links { "Stimply-Engine" }
+
+    includedirs { "engine/", "vendor/DirectXMath/Inc" }
+
+    filter "configurations:Debug"
+        defines { "DEBUG", platform_define }
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { platform_define }
+        optimize "Full"
+
+project "Stimply-HandlePoolTest"
+    kind "ConsoleApp"
+    language "C++"
+    if os.host() == "windows" then
+        cppdialect "c++17"
+        defines { "RAPI=__declspec(dllimport)", "_CRT_SECURE_NO_WARNINGS" }
+        flags { "MultiProcessorCompile" }
+    elseif os.host() == "linux" then
+        defines { "RAPI= ", "_XM_NO_XMVECTOR_OVERLOADS_" }
+        cppdialect "gnu++17"
+        toolset "clang"
+    end
+    targetdir "bin/%{cfg.buildcfg}"
+
+    architecture("x86_64")
+    -- Stale and forged handle checks for handle_pool, exits with 1 on any failure.
+    files { "tools/handle_pool_test/**.cpp" }
+
+    links { "Stimply-Engine" }
+
+    includedirs { "engine/", "vendor/DirectXMath/Inc" }
+
+    filter "configurations:Debug"
+        defines { "DEBUG", platform_define }
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { platform_define }
         optimize "Full"
\ No newline at end of file
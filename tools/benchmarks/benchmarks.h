@@ -0,0 +1,23 @@
+#pragma once
+
+#include "platform/platform.h"
+
+#include <cstdint>
+
+/* Each benchmark prints its own table, maxCount caps the largest input it builds. */
+void run_hash_map_benchmark(uint64_t maxCount);
+/* Parses at most a million numbers per input, maxCount is only used to go lower. */
+void run_number_parser_benchmark(uint64_t maxCount);
+
+/* Nanoseconds per operation since start. */
+static inline double ns_per_op(int64_t start, uint64_t operations) {
+	return double(Platform::GetTime() - start) / double(operations ? operations : 1);
+}
+
+/* splitmix64, so both sides of a comparison see the same keys. */
+static inline uint64_t next_random(uint64_t& state) {
+	uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "benchmarks.h"
+#include "containers/hash_map.h"
+
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+struct HashMapTimings {
+	double insert;
+	double findHit;
+	double findMiss;
+	double erase;
+};
+
+/* Inserts keys, looks all of them up, looks up as many keys that aren't there and erases everything. */
+template<typename Map, typename Insert, typename Find>
+static HashMapTimings measure(const std::vector<uint64_t>& keys, const std::vector<uint64_t>& missingKeys, Insert insert, Find find, uint64_t& checksum) {
+	HashMapTimings timings;
+	Map map;
+
+	int64_t start = Platform::GetTime();
+	for (uint64_t key : keys) {
+		insert(map, key);
+	}
+	timings.insert = ns_per_op(start, keys.size());
+
+	start = Platform::GetTime();
+	for (uint64_t key : keys) {
+		checksum += find(map, key);
+	}
+	timings.findHit = ns_per_op(start, keys.size());
+
+	start = Platform::GetTime();
+	for (uint64_t key : missingKeys) {
+		checksum += find(map, key);
+	}
+	timings.findMiss = ns_per_op(start, missingKeys.size());
+
+	start = Platform::GetTime();
+	for (uint64_t key : keys) {
+		checksum += map.erase(key);
+	}
+	timings.erase = ns_per_op(start, keys.size());
+
+	return timings;
+}
+
+using EngineMap = hash_map<uint64_t, uint64_t>;
+using StandardMap = std::unordered_map<uint64_t, uint64_t>;
+
+void run_hash_map_benchmark(uint64_t maxCount) {
+	printf("%10s %-20s %10s %10s %10s %10s  (ns per operation)\n", "entries", "map", "insert", "find hit", "find miss", "erase");
+
+	uint64_t checksum = 0;
+	for (uint64_t count = 1000; count <= maxCount; count *= 10) {
+		uint64_t random = count;
+		std::vector<uint64_t> keys(count);
+		std::vector<uint64_t> missingKeys(count);
+		for (uint64_t i = 0; i < count; i++) {
+			// The low bit splits present and missing keys so they never collide.
+			keys[i] = next_random(random) | 1;
+			missingKeys[i] = next_random(random) & ~1ull;
+		}
+
+		HashMapTimings engine = measure<EngineMap>(keys, missingKeys,
+			[](EngineMap& map, uint64_t key) { map.insert(key, key); },
+			[](const EngineMap& map, uint64_t key) -> uint64_t { const uint64_t* value = map.find(key); return value ? *value : 0; },
+			checksum);
+		HashMapTimings standard = measure<StandardMap>(keys, missingKeys,
+			[](StandardMap& map, uint64_t key) { map.insert({ key, key }); },
+			[](const StandardMap& map, uint64_t key) -> uint64_t { auto it = map.find(key); return it != map.end() ? it->second : 0; },
+			checksum);
+
+		printf("%10llu %-20s %10.1f %10.1f %10.1f %10.1f\n", (unsigned long long)count, "hash_map", engine.insert, engine.findHit, engine.findMiss, engine.erase);
+		printf("%10llu %-20s %10.1f %10.1f %10.1f %10.1f\n", (unsigned long long)count, "std::unordered_map", standard.insert, standard.findHit, standard.findMiss, standard.erase);
+	}
+
+	// Keeps the lookups from being optimized away.
+	printf("checksum %llu\n", (unsigned long long)checksum);
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "benchmarks.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/*
+ * Stimply-Benchmarks: micro benchmarks of engine containers and parsers against their standard library counterparts.
+ *
+ *     Stimply-Benchmarks [benchmark] [max count]
+ *
+ * Without a name every benchmark runs. Build the Release configuration, Debug numbers mean nothing.
+ */
+
+struct Benchmark {
+	const char* name;
+	void (*run)(uint64_t maxCount);
+};
+
+static const Benchmark s_Benchmarks[] = {
+	{ "hash_map", run_hash_map_benchmark },
+	{ "number_parser", run_number_parser_benchmark },
+};
+
+int main(int argc, char** argv) {
+	const char* name = argc > 1 ? argv[1] : nullptr;
+	uint64_t maxCount = argc > 2 ? strtoull(argv[2], nullptr, 10) : 10000000;
+
+	Platform platform;
+
+	bool found = false;
+	for (const Benchmark& benchmark : s_Benchmarks) {
+		if (!name || strcmp(name, benchmark.name) == 0) {
+			printf("== %s ==\n", benchmark.name);
+			benchmark.run(maxCount);
+			found = true;
+		}
+	}
+
+	if (!found) {
+		printf("Unknown benchmark %s\n", name);
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
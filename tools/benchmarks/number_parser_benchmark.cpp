@@ -0,0 +1,175 @@
+#include "benchmarks.h"
+#include "core/number_parser.h"
+#include "core/string.h"
+
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/* Numbers separated by single spaces, like the values of an asset file. */
+struct NumberText {
+	std::string text;
+	uint64_t count = 0;
+};
+
+template<typename Generate>
+static NumberText make_text(uint64_t count, Generate generate) {
+	NumberText numbers;
+	numbers.text.reserve(count * 12);
+
+	char buffer[64];
+	for (uint64_t i = 0; i < count; i++) {
+		int length = generate(buffer, sizeof(buffer), i);
+		numbers.text.append(buffer, length);
+		numbers.text.push_back(' ');
+	}
+	numbers.count = count;
+	return numbers;
+}
+
+/* Every measurement is the best of this many runs, single runs vary too much on shared machines. */
+static constexpr uint32_t MEASURE_RUNS = 7;
+
+/* Calls parse(first, last, value) until the text runs out, parse returns the end of the number. */
+template<typename T, typename Parse>
+static double measure(const NumberText& numbers, Parse parse, double& checksum) {
+	double best = 0.0;
+	for (uint32_t run = 0; run < MEASURE_RUNS; run++) {
+		const char* first = numbers.text.data();
+		const char* last = first + numbers.text.size();
+
+		int64_t start = Platform::GetTime();
+		while (first < last) {
+			T value = 0;
+			first = parse(first, last, value) + 1;
+			checksum += (double)value;
+		}
+
+		double nanoseconds = ns_per_op(start, numbers.count);
+		best = run == 0 || nanoseconds < best ? nanoseconds : best;
+	}
+	return best;
+}
+
+/* Null terminated lines, the way asset loaders hand them to String::To*. */
+struct LineText {
+	std::string text;
+	std::vector<uint32_t> offsets;
+};
+
+template<typename Generate>
+static LineText make_lines(uint64_t count, Generate generate) {
+	LineText lines;
+	lines.text.reserve(count * 32);
+	lines.offsets.reserve(count);
+
+	char buffer[128];
+	for (uint64_t i = 0; i < count; i++) {
+		int length = generate(buffer, sizeof(buffer));
+		lines.offsets.push_back((uint32_t)lines.text.size());
+		lines.text.append(buffer, length);
+		lines.text.push_back(0);
+	}
+	return lines;
+}
+
+/* Calls parse(line) on every line, returns nanoseconds per line. */
+template<typename Parse>
+static double measure_lines(const LineText& lines, Parse parse, double& checksum) {
+	const char* text = lines.text.data();
+
+	double best = 0.0;
+	for (uint32_t run = 0; run < MEASURE_RUNS; run++) {
+		int64_t start = Platform::GetTime();
+		for (uint32_t offset : lines.offsets) {
+			checksum += parse(text + offset);
+		}
+
+		double nanoseconds = ns_per_op(start, lines.offsets.size());
+		best = run == 0 || nanoseconds < best ? nanoseconds : best;
+	}
+	return best;
+}
+
+/* The replaced sscanf call next to the String::To* function that replaced it. */
+static void print_baseline_row(const char* input, const LineText& lines, double sscanfNanoseconds, double stringNanoseconds) {
+	printf("%-24s %14.1f %14.1f %9.1fx\n", input, sscanfNanoseconds, stringNanoseconds, sscanfNanoseconds / stringNanoseconds);
+}
+
+static void print_row(const char* input, const char* parser, const NumberText& numbers, double nanoseconds) {
+	double megabytesPerSecond = double(numbers.text.size()) / (nanoseconds * numbers.count) * 1e3;
+	printf("%-24s %-20s %10.1f %10.1f\n", input, parser, nanoseconds, megabytesPerSecond);
+}
+
+void run_number_parser_benchmark(uint64_t maxCount) {
+	uint64_t count = maxCount < 1000000 ? maxCount : 1000000;
+	uint64_t random = 1;
+
+	NumberText shortFloats = make_text(count, [&](char* buffer, size_t size, uint64_t) {
+		return snprintf(buffer, size, "%.6g", (double)(int64_t)(next_random(random) % 2000000 - 1000000) / 1000.0);
+	});
+	NumberText longFloats = make_text(count, [&](char* buffer, size_t size, uint64_t) {
+		return snprintf(buffer, size, "%.17g", (double)next_random(random) / 1e19 * 1e-3);
+	});
+	NumberText integers = make_text(count, [&](char* buffer, size_t size, uint64_t) {
+		return snprintf(buffer, size, "%d", (int32_t)next_random(random));
+	});
+
+	printf("%-24s %-20s %10s %10s\n", "input", "parser", "ns/number", "MB/s");
+
+	double checksum = 0.0;
+	auto number_parser = [](const char* first, const char* last, auto& value) { return NumberParser::Parse(first, last, value).end; };
+	auto from_chars = [](const char* first, const char* last, auto& value) { return std::from_chars(first, last, value).ptr; };
+	auto strtod_parser = [](const char* first, const char*, double& value) { char* end; value = strtod(first, &end); return (const char*)end; };
+	auto strtof_parser = [](const char* first, const char*, float& value) { char* end; value = strtof(first, &end); return (const char*)end; };
+	auto strtol_parser = [](const char* first, const char*, int32_t& value) { char* end; value = (int32_t)strtol(first, &end, 10); return (const char*)end; };
+
+	struct FloatInput {
+		const char* name;
+		const NumberText& numbers;
+	};
+	const FloatInput floatInputs[] = { { "floats, 6 digits", shortFloats }, { "floats, 17 digits", longFloats } };
+
+	for (const FloatInput& input : floatInputs) {
+		print_row(input.name, "NumberParser double", input.numbers, measure<double>(input.numbers, number_parser, checksum));
+		print_row(input.name, "std::from_chars", input.numbers, measure<double>(input.numbers, from_chars, checksum));
+		print_row(input.name, "strtod", input.numbers, measure<double>(input.numbers, strtod_parser, checksum));
+		print_row(input.name, "NumberParser float", input.numbers, measure<float>(input.numbers, number_parser, checksum));
+		print_row(input.name, "strtof", input.numbers, measure<float>(input.numbers, strtof_parser, checksum));
+	}
+
+	print_row("int32", "NumberParser", integers, measure<int32_t>(integers, number_parser, checksum));
+	print_row("int32", "std::from_chars", integers, measure<int32_t>(integers, from_chars, checksum));
+	print_row("int32", "strtol", integers, measure<int32_t>(integers, strtol_parser, checksum));
+
+	// String::To* against the sscanf calls they used before NumberParser, on the same lines.
+	LineText vertices = make_lines(count / 3, [&](char* buffer, size_t size) {
+		float x = (float)(int64_t)(next_random(random) % 2000000 - 1000000) / 1000.0f;
+		float y = (float)(int64_t)(next_random(random) % 2000000 - 1000000) / 1000.0f;
+		float z = (float)(int64_t)(next_random(random) % 2000000 - 1000000) / 1000.0f;
+		return snprintf(buffer, size, "%f %f %f", x, y, z);
+	});
+	LineText singleFloats = make_lines(count, [&](char* buffer, size_t size) {
+		return snprintf(buffer, size, "%f", (double)(int64_t)(next_random(random) % 2000000 - 1000000) / 1000.0);
+	});
+	LineText unsignedIntegers = make_lines(count, [&](char* buffer, size_t size) {
+		return snprintf(buffer, size, "%u", (uint32_t)next_random(random));
+	});
+
+	printf("\n%-24s %14s %14s %10s\n", "input", "sscanf ns", "String::To* ns", "speedup");
+
+	print_baseline_row("\"%f %f %f\" lines", vertices,
+		measure_lines(vertices, [](const char* line) { float x = 0, y = 0, z = 0; sscanf(line, "%f %f %f", &x, &y, &z); return (double)(x + y + z); }, checksum),
+		measure_lines(vertices, [](const char* line) { DirectX::XMFLOAT3 v = String::ToFloat3(line); return (double)(v.x + v.y + v.z); }, checksum));
+	print_baseline_row("\"%f\" lines", singleFloats,
+		measure_lines(singleFloats, [](const char* line) { float value = 0; sscanf(line, "%f", &value); return (double)value; }, checksum),
+		measure_lines(singleFloats, [](const char* line) { return (double)String::ToFloat(line); }, checksum));
+	print_baseline_row("\"%u\" lines", unsignedIntegers,
+		measure_lines(unsignedIntegers, [](const char* line) { uint32_t value = 0; sscanf(line, "%u", &value); return (double)value; }, checksum),
+		measure_lines(unsignedIntegers, [](const char* line) { return (double)String::Tou32(line); }, checksum));
+
+	// Keeps the parsed values from being optimized away.
+	printf("checksum %g\n", checksum);
+}
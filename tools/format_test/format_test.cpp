@@ -0,0 +1,97 @@
+#include "core/format.h"
+
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+/*
+ * Stimply-FormatTest: formats the same conversions with Formatter and snprintf and reports every difference.
+ * Exits with 1 if any output differs, so it can run as a check after touching format.cpp.
+ */
+
+static uint32_t s_Checks = 0;
+static uint32_t s_Failures = 0;
+
+template<typename... Args>
+static void check(const char* format, const Args&... args) {
+	char expected[512];
+	char actual[512];
+	snprintf(expected, sizeof(expected), format, args...);
+	Formatter::FormatTo(actual, sizeof(actual), format, args...);
+
+	s_Checks++;
+	if (strcmp(expected, actual) != 0) {
+		s_Failures++;
+		printf("%-12s expected \"%s\", got \"%s\"\n", format, expected, actual);
+	}
+}
+
+static void check_integers() {
+	const char* signedFormats[] = { "%d", "%+d", "% d", "%5d", "%-5d|", "%05d", "%.3d", "%+.0d", "%.0d", "%x", "%#x", "%#X", "%#o", "%o", "%.0o", "%#.0o", "%#.0x" };
+	const int32_t signedValues[] = { 0, 1, -1, 42, -42, 123456, INT32_MAX, INT32_MIN };
+	for (const char* format : signedFormats) {
+		for (int32_t value : signedValues) {
+			check(format, value);
+		}
+	}
+
+	const char* unsignedFormats[] = { "%u", "%+u", "% u", "%8u", "%-8u|", "%.0u", "%+x", "% o" };
+	const uint32_t unsignedValues[] = { 0, 1, 255, 4096, UINT32_MAX };
+	for (const char* format : unsignedFormats) {
+		for (uint32_t value : unsignedValues) {
+			check(format, value);
+		}
+	}
+
+	const char* longFormats[] = { "%lu", "%+lu", "%lx", "%#lo", "%#.0lo" };
+	const unsigned long longValues[] = { 0, 1, 4096, ULONG_MAX };
+	for (const char* format : longFormats) {
+		for (unsigned long value : longValues) {
+			check(format, value);
+		}
+	}
+
+	check("%c|%3c|%-3c|", 'a', 'b', 'c');
+}
+
+static void check_floats() {
+	const char* formats[] = {
+		"%f", "%.0f", "%#.0f", "%+.2f", "% .3f", "%10.2f", "%-10.2f|", "%010.2f",
+		"%e", "%.0e", "%#.0e", "%E", "%+.3e",
+		"%g", "%.0g", "%#g", "%#.3g", "%#.0g", "%G", "%.10g",
+		"%a", "%.0a", "%#.0a", "%.3a", "%A", "%+a",
+	};
+	const double values[] = { 0.0, -0.0, 1.0, -1.5, 0.1, 123.456, 1e-5, 1e10, 100000.0, 1234567.0, 0.0001, 2.5, 3.5 };
+	for (const char* format : formats) {
+		for (double value : values) {
+			check(format, value);
+		}
+	}
+
+	const char* specialFormats[] = { "%f", "%e", "%g", "%a", "%A", "%F", "%+f", "%#a", "%#g", "%8f" };
+	const double specialValues[] = { INFINITY, -INFINITY, NAN };
+	for (const char* format : specialFormats) {
+		for (double value : specialValues) {
+			check(format, value);
+		}
+	}
+}
+
+static void check_strings() {
+	check("%s", "text");
+	check("%10s|%-10s|", "right", "left");
+	check("%.2s", "truncated");
+	check("%*d|%-*d|%.*f", 6, 42, 6, 42, 2, 3.14159);
+	check("100%%");
+}
+
+int main() {
+	check_integers();
+	check_floats();
+	check_strings();
+
+	printf("%u checks, %u failed\n", s_Checks, s_Failures);
+	return s_Failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "containers/handle_pool.h"
+
+#include <cstdint>
+#include <cstdio>
+
+/*
+ * Stimply-HandlePoolTest: checks that handle_pool rejects stale and forged handles and keeps
+ * the remaining elements reachable after erases. Exits with 1 if any check fails.
+ */
+
+static uint32_t s_Checks = 0;
+static uint32_t s_Failures = 0;
+
+static void check(bool condition, const char* what) {
+	s_Checks++;
+	if (!condition) {
+		s_Failures++;
+		printf("failed: %s\n", what);
+	}
+}
+
+static void check_stale_handles() {
+	handle_pool<int> pool;
+	Handle<int> a = pool.insert(1);
+	Handle<int> b = pool.insert(2);
+
+	check(pool.erase(a), "erase a live handle");
+	check(!pool.contains(a), "erased handle is stale");
+	check(pool.get(a) == nullptr, "get on an erased handle");
+	check(!pool.erase(a), "erase an erased handle twice");
+	check(pool.get(b) && *pool.get(b) == 2, "other element survives the erase");
+
+	Handle<int> c = pool.insert(3);
+	check(c.index == a.index && c.generation != a.generation, "slot is reused with a new generation");
+	check(!pool.contains(a), "old handle doesn't alias the reused slot");
+	check(pool.get(c) && *pool.get(c) == 3, "reused slot holds the new element");
+}
+
+static void check_forged_handles() {
+	handle_pool<int> pool;
+	Handle<int> a = pool.insert(1);
+	Handle<int> b = pool.insert(2);
+	pool.erase(a);
+
+	// The freed slot already carries the generation its next element will get.
+	Handle<int> forged{ a.index, a.generation + 1 };
+	check(!pool.contains(forged), "forged handle to a free slot");
+	check(pool.get(forged) == nullptr, "get on a forged handle to a free slot");
+	check(!pool.erase(forged), "erase a forged handle to a free slot");
+	check(pool.size() == 1 && pool.get(b) && *pool.get(b) == 2, "pool is untouched by the forged handle");
+
+	// Free slots chain through their index, so a forged handle may point at a valid dense position.
+	Handle<int> c = pool.insert(3);
+	pool.erase(b);
+	pool.erase(c);
+	check(!pool.contains(Handle<int>{ b.index, b.generation + 1 }), "forged handle to the head of the free list");
+	check(!pool.contains(Handle<int>{ c.index, c.generation + 1 }), "forged handle inside the free list");
+
+	check(!pool.contains(Handle<int>{ 1000, 0 }), "handle past the end of the slots");
+	check(!pool.contains(Handle<int>{}), "default handle");
+}
+
+static void check_dense_moves() {
+	handle_pool<int> pool;
+	Handle<int> handles[16];
+	for (int i = 0; i < 16; i++) {
+		handles[i] = pool.insert(i);
+	}
+
+	for (int i = 0; i < 16; i += 2) {
+		pool.erase(handles[i]);
+	}
+
+	for (int i = 0; i < 16; i++) {
+		const int* value = pool.get(handles[i]);
+		check(i % 2 == 0 ? value == nullptr : (value && *value == i), "lookup after erasing every other element");
+	}
+
+	pool.clear();
+	check(pool.is_empty(), "clear empties the pool");
+	for (Handle<int> handle : handles) {
+		check(!pool.contains(handle), "no handle survives clear");
+	}
+}
+
+int main() {
+	check_stale_handles();
+	check_forged_handles();
+	check_dense_moves();
+
+	printf("%u checks, %u failed\n", s_Checks, s_Failures);
+	return s_Failures == 0 ? 0 : 1;
+}
\ No newline at end of file
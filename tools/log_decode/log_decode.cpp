@@ -0,0 +1,268 @@
+#include "core/binary_log.h"
+#include "core/format.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/*
+ * Stimply-LogDecode: turns a binary log (LoggerConfig::binaryLogPath) back into text.
+ *
+ *     Stimply-LogDecode <binary log> [output file]
+ *
+ * Messages of all threads are merged in the order they were logged, each prefixed with the seconds since the log was created.
+ * The log may come from a process that crashed, every record between a ring's tail and head is complete.
+ */
+
+struct RingCursor {
+	const char* data;
+	uint64_t position;
+	uint64_t end;
+};
+
+struct DecodedMessage {
+	const BinaryLogRecord* record;
+	FormatArg args[0xff];
+	/* Vector arguments are copied out, the file only keeps them 4 byte aligned. */
+	float floats[0xff][4];
+};
+
+static const char* s_LevelStrings[] = { "[FATAL]: ", "[WARN]: ", "[INFO]: ", "[DEBUG]: " };
+
+static char* read_file(const char* path, uint64_t& size) {
+	FILE* file = fopen(path, "rb");
+	if (!file) {
+		return nullptr;
+	}
+
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	char* contents = (char*)malloc(size);
+	if (contents && fread(contents, 1, size, file) != size) {
+		free(contents);
+		contents = nullptr;
+	}
+
+	fclose(file);
+	return contents;
+}
+
+/* Next record of a ring, skipping the unused end of it, nullptr once it's exhausted or damaged. */
+static const BinaryLogRecord* peek_record(RingCursor& cursor, uint64_t ringSize) {
+	while (cursor.position < cursor.end) {
+		uint64_t offset = cursor.position & (ringSize - 1);
+		uint64_t toEnd = ringSize - offset;
+
+		const BinaryLogRecord* record = (const BinaryLogRecord*)(cursor.data + offset);
+		if (toEnd < sizeof(BinaryLogRecord) || record->size == BINARY_LOG_WRAP_RECORD) {
+			cursor.position += toEnd;
+			continue;
+		}
+
+		if (record->size < sizeof(BinaryLogRecord) || record->size > toEnd) {
+			fprintf(stderr, "Damaged record, skipping the rest of a thread's messages\n");
+			cursor.position = cursor.end;
+			return nullptr;
+		}
+
+		return record;
+	}
+
+	return nullptr;
+}
+
+static bool decode_args(const BinaryLogRecord* record, DecodedMessage& message) {
+	const char* cursor = (const char*)(record + 1);
+	const char* end = (const char*)record + record->size;
+
+	for (uint32_t i = 0; i < record->argCount; i++) {
+		if (cursor + sizeof(BinaryLogArg) > end) {
+			return false;
+		}
+
+		BinaryLogArg argHeader;
+		memcpy(&argHeader, cursor, sizeof(argHeader));
+		cursor += sizeof(BinaryLogArg);
+
+		FormatArg& arg = message.args[i];
+		arg = FormatArg{};
+		arg.type = argHeader.type;
+		arg.size = argHeader.size;
+
+		uint64_t payloadSize;
+		switch (arg.type) {
+		case FormatArgType::String: {
+			uint32_t length = 0;
+			if (cursor + sizeof(length) > end) {
+				return false;
+			}
+			memcpy(&length, cursor, sizeof(length));
+			arg.string.data = cursor + sizeof(length);
+			arg.string.size = length;
+			payloadSize = binary_log_payload_size(arg.type, length);
+			break;
+		}
+		case FormatArgType::Float2:
+		case FormatArgType::Float3:
+		case FormatArgType::Float4:
+			payloadSize = binary_log_payload_size(arg.type, 0);
+			if (cursor + payloadSize <= end) {
+				memcpy(message.floats[i], cursor, payloadSize);
+			}
+			arg.floats = message.floats[i];
+			break;
+		case FormatArgType::Signed:
+		case FormatArgType::Unsigned:
+		case FormatArgType::Char:
+		case FormatArgType::Bool:
+		case FormatArgType::Double:
+		case FormatArgType::Pointer:
+			payloadSize = binary_log_payload_size(arg.type, 0);
+			if (cursor + payloadSize <= end) {
+				memcpy(&arg.u, cursor, sizeof(arg.u));
+			}
+			break;
+		default:
+			return false;
+		}
+
+		if (cursor + payloadSize > end) {
+			return false;
+		}
+		cursor += payloadSize;
+	}
+
+	return true;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s <binary log> [output file]\n", argv[0]);
+		return 1;
+	}
+
+	uint64_t fileSize = 0;
+	char* contents = read_file(argv[1], fileSize);
+	if (!contents) {
+		fprintf(stderr, "Failed to read %s\n", argv[1]);
+		return 1;
+	}
+
+	const BinaryLogFileHeader* header = (const BinaryLogFileHeader*)contents;
+	if (fileSize < sizeof(BinaryLogFileHeader) || header->magic != BINARY_LOG_MAGIC) {
+		fprintf(stderr, "%s is not a binary log\n", argv[1]);
+		return 1;
+	}
+
+	if (header->version != BINARY_LOG_VERSION) {
+		fprintf(stderr, "%s is version %u, this decoder reads version %u\n", argv[1], header->version, BINARY_LOG_VERSION);
+		return 1;
+	}
+
+	uint64_t formatTableUsed = header->formatTableUsed.load(std::memory_order_relaxed);
+	if (header->fileSize > fileSize || header->ringCount > BINARY_LOG_MAX_THREADS ||
+		header->formatTableOffset + formatTableUsed > fileSize || header->ringOffset + header->ringSize * header->ringCount > fileSize) {
+		fprintf(stderr, "%s is truncated\n", argv[1]);
+		return 1;
+	}
+
+	FILE* output = stdout;
+	if (argc > 2) {
+		output = fopen(argv[2], "w");
+		if (!output) {
+			fprintf(stderr, "Failed to open %s\n", argv[2]);
+			return 1;
+		}
+	}
+
+	// Format ids are their index in the table.
+	uint32_t formatCount = 0;
+	for (uint64_t offset = 0; offset < formatTableUsed; formatCount++) {
+		const BinaryLogFormat* entry = (const BinaryLogFormat*)(contents + header->formatTableOffset + offset);
+		offset += binary_log_align(sizeof(BinaryLogFormat) + entry->length + 1);
+	}
+
+	const char** formats = (const char**)calloc(formatCount + 1, sizeof(const char*));
+	for (uint64_t offset = 0; offset < formatTableUsed;) {
+		const BinaryLogFormat* entry = (const BinaryLogFormat*)(contents + header->formatTableOffset + offset);
+		if (entry->id < formatCount) {
+			formats[entry->id] = (const char*)(entry + 1);
+		}
+		offset += binary_log_align(sizeof(BinaryLogFormat) + entry->length + 1);
+	}
+
+	const BinaryLogRingHeader* ringHeaders = (const BinaryLogRingHeader*)(contents + binary_log_align(sizeof(BinaryLogFileHeader)));
+	RingCursor cursors[BINARY_LOG_MAX_THREADS];
+	for (uint32_t i = 0; i < header->ringCount; i++) {
+		uint64_t head = ringHeaders[i].head.load(std::memory_order_relaxed);
+		uint64_t tail = ringHeaders[i].tail.load(std::memory_order_relaxed);
+		if (head < tail || head - tail > header->ringSize) {
+			fprintf(stderr, "Thread %u has a damaged ring, skipping it\n", i);
+			tail = head;
+		}
+		cursors[i] = { contents + header->ringOffset + header->ringSize * i, tail, head };
+	}
+
+	DecodedMessage* message = (DecodedMessage*)malloc(sizeof(DecodedMessage));
+	uint64_t bufferSize = 4096;
+	char* buffer = (char*)malloc(bufferSize);
+	uint64_t messageCount = 0;
+
+	for (;;) {
+		RingCursor* next = nullptr;
+		const BinaryLogRecord* record = nullptr;
+
+		for (uint32_t i = 0; i < header->ringCount; i++) {
+			const BinaryLogRecord* candidate = peek_record(cursors[i], header->ringSize);
+			if (candidate && (!record || candidate->time < record->time)) {
+				next = &cursors[i];
+				record = candidate;
+			}
+		}
+
+		if (!next) {
+			break;
+		}
+		next->position += record->size;
+
+		double seconds = (double)(record->time - header->startTime) / 1e9;
+		const char* level = (uint32_t)record->level < 4 ? s_LevelStrings[record->level] : "[?]: ";
+
+		if (record->formatId >= formatCount || !formats[record->formatId] || !decode_args(record, *message)) {
+			fprintf(output, "[%12.6f] %s<damaged record>\n", seconds, level);
+			continue;
+		}
+
+		FormatSink sink;
+		sink.buffer = buffer;
+		sink.capacity = bufferSize;
+		Formatter::Format(sink, formats[record->formatId], message->args, record->argCount);
+
+		if (sink.size > sink.capacity) {
+			bufferSize = sink.size;
+			buffer = (char*)realloc(buffer, bufferSize);
+
+			sink.buffer = buffer;
+			sink.capacity = bufferSize;
+			sink.size = 0;
+			Formatter::Format(sink, formats[record->formatId], message->args, record->argCount);
+		}
+
+		fprintf(output, "[%12.6f] %s%.*s\n", seconds, level, (int)sink.size, buffer);
+		messageCount++;
+	}
+
+	fprintf(stderr, "Decoded %llu messages\n", (unsigned long long)messageCount);
+
+	if (output != stdout) {
+		fclose(output);
+	}
+
+	free(buffer);
+	free(message);
+	free(formats);
+	free(contents);
+	return 0;
+}
\ No newline at end of file
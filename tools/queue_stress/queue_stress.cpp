@@ -0,0 +1,155 @@
+#include "containers/mpmc_queue.h"
+#include "containers/spsc_queue.h"
+#include "platform/platform.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+/*
+ * Stimply-QueueStress: checks mpmc_queue and spsc_queue under contention, then measures mpmc_queue throughput
+ * with 1 to N producers. Build with --sanitize-thread to run the checks under ThreadSanitizer.
+ *
+ *     Stimply-QueueStress [max producers] [elements per producer]
+ *
+ * Exits with 1 if an element was lost, duplicated or, for the spsc queue, came out of order.
+ */
+
+static constexpr size_t QUEUE_CAPACITY = 1024;
+
+/* Every producer pushes its own ids, the consumers count each one they pop. */
+static bool stress_mpmc(uint32_t producerCount, uint32_t consumerCount, uint32_t elementsPerProducer) {
+	mpmc_queue<uint32_t> queue(QUEUE_CAPACITY);
+
+	uint32_t total = producerCount * elementsPerProducer;
+	std::vector<std::atomic<uint32_t>> seen(total);
+	std::atomic<uint32_t> popped{ 0 };
+
+	std::vector<std::thread> threads;
+	for (uint32_t producer = 0; producer < producerCount; producer++) {
+		threads.emplace_back([&, producer] {
+			for (uint32_t i = 0; i < elementsPerProducer; i++) {
+				while (!queue.try_push(producer * elementsPerProducer + i)) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	for (uint32_t consumer = 0; consumer < consumerCount; consumer++) {
+		threads.emplace_back([&] {
+			uint32_t value;
+			while (popped.load(std::memory_order_relaxed) < total) {
+				if (queue.try_pop(value)) {
+					seen[value].fetch_add(1, std::memory_order_relaxed);
+					popped.fetch_add(1, std::memory_order_relaxed);
+				} else {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	for (uint32_t i = 0; i < total; i++) {
+		if (seen[i].load(std::memory_order_relaxed) != 1) {
+			printf("mpmc_queue %u producers, %u consumers: element %u popped %u times\n", producerCount, consumerCount, i, seen[i].load());
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool stress_spsc(uint32_t elementCount) {
+	spsc_queue<uint32_t> queue(QUEUE_CAPACITY);
+
+	std::thread producer([&] {
+		for (uint32_t i = 0; i < elementCount; i++) {
+			while (!queue.try_push(i)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	bool ordered = true;
+	uint32_t value;
+	for (uint32_t expected = 0; expected < elementCount;) {
+		if (!queue.try_pop(value)) {
+			std::this_thread::yield();
+			continue;
+		}
+		if (value != expected && ordered) {
+			printf("spsc_queue: expected %u, popped %u\n", expected, value);
+			ordered = false;
+		}
+		expected++;
+	}
+
+	producer.join();
+	return ordered;
+}
+
+/* Producers push as fast as they can while one consumer drains, returns pushes per second. */
+static double measure_mpmc(uint32_t producerCount, uint32_t elementsPerProducer) {
+	mpmc_queue<uint64_t> queue(QUEUE_CAPACITY);
+
+	std::atomic<bool> start{ false };
+	std::vector<std::thread> producers;
+	for (uint32_t producer = 0; producer < producerCount; producer++) {
+		producers.emplace_back([&] {
+			while (!start.load(std::memory_order_acquire)) {
+				std::this_thread::yield();
+			}
+			for (uint32_t i = 0; i < elementsPerProducer; i++) {
+				while (!queue.try_push(i)) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	uint64_t total = (uint64_t)producerCount * elementsPerProducer;
+	int64_t begin = Platform::GetTime();
+	start.store(true, std::memory_order_release);
+
+	uint64_t value;
+	for (uint64_t popped = 0; popped < total;) {
+		if (queue.try_pop(value)) {
+			popped++;
+		} else {
+			std::this_thread::yield();
+		}
+	}
+
+	int64_t elapsed = Platform::GetTime() - begin;
+	for (std::thread& producer : producers) {
+		producer.join();
+	}
+	return total * 1e9 / (elapsed > 0 ? elapsed : 1);
+}
+
+int main(int argc, char** argv) {
+	uint32_t maxProducers = argc > 1 ? (uint32_t)atoi(argv[1]) : std::thread::hardware_concurrency();
+	uint32_t elementsPerProducer = argc > 2 ? (uint32_t)atoi(argv[2]) : 100000;
+	if (maxProducers == 0) {
+		maxProducers = 1;
+	}
+
+	Platform platform;
+
+	bool passed = stress_spsc(elementsPerProducer * 4);
+	for (uint32_t producers = 1; producers <= maxProducers; producers *= 2) {
+		passed &= stress_mpmc(producers, 1, elementsPerProducer);
+		passed &= stress_mpmc(producers, producers, elementsPerProducer);
+	}
+	printf("Stress: %s\n", passed ? "passed" : "FAILED");
+
+	for (uint32_t producers = 1; producers <= maxProducers; producers++) {
+		printf("mpmc_queue %2u producers: %8.2f M pushes/s\n", producers, measure_mpmc(producers, elementsPerProducer) / 1e6);
+	}
+
+	return passed ? 0 : 1;
+}